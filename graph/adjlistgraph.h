@@ -20,6 +20,15 @@
 #include "../matrix/tuple/tripletsparsematrix.h"
 #include"../tree/priorityqueue.h"
 #include"unionfind.h"
+#include "openhashmap.h"
+#include "csrgraph.h"
+#include "compressedgraph.h"
+#include "../list/seqlist/seqlist.h"
+#include "traversalcontext.h"
+#include <cmath>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace bu_tools {
 
@@ -28,9 +37,10 @@ namespace bu_tools {
  * @brief : 图（邻接表
  * @tparam T 顶点
  * @tparam E 权值
+ * @tparam H 顶点的哈希函数，用于按顶点查找索引
  * *****************************************************************
  */
-template <typename T, typename E>
+template <typename T, typename E, typename H = std::hash<T>>
 class AdjLsitgraph {
   /*****************************************************************
 
@@ -100,13 +110,19 @@ private:
   public:
     T m_data;                // 顶点存储的数据
     AdjListNode *m_adj_list; // 邻接表的头指针
+    AdjListNode *m_in_list;  // 入边表的头指针，结点的 m_dest 是弧的起点，只在有向图的延迟删除模式下维护
+    bool m_removed;          // 是否已被延迟删除（墓碑）
+    int m_in_degree;         // 入度（指向该顶点的弧的条数），有向图始终维护
 
     Vertex() {
       m_data = T();
       m_adj_list = nullptr;
+      m_in_list = nullptr;
+      m_removed = false;
+      m_in_degree = 0;
     }
 
-    Vertex(const T &data) : m_data(data), m_adj_list(nullptr) {}
+    Vertex(const T &data) : m_data(data), m_adj_list(nullptr), m_in_list(nullptr), m_removed(false), m_in_degree(0) {}
   };
 
   /*****************************************************************
@@ -121,6 +137,17 @@ protected:
   int m_vertex_capacity; //顶点数组容量
   int m_edge_count;      // 边或弧的数量
   Vertex *m_vertexs;     //顶点数组
+  OpenHashMap<T, int, H> m_vertex_index; // 顶点到索引的哈希表
+  bool m_lazy_removal;   // 是否为延迟删除模式
+  bool m_in_edge_index;  // 是否维护入边表（有向图）
+  int m_removed_count;   // 墓碑顶点个数
+
+  // 邻接表结点按块分配，删除的结点回收到空闲链表中重复使用
+  AdjListNode *m_free_nodes;   // 空闲结点链表（通过 m_next 串联）
+  int m_free_count;            // 空闲结点个数
+  AdjListNode **m_node_blocks; // 已分配的结点块
+  int m_block_count;           // 结点块个数
+  int m_block_capacity;        // 结点块指针数组容量
 
   /*****************************************************************
 
@@ -129,18 +156,41 @@ protected:
   *****************************************************************/
 
 private:
-  void ResizeVertexs();
+  void ResizeVertexs(int new_capacity);
+  void AllocateNodeBlock(int block_size);
+  AdjListNode *NewNode(int dest, const E &weight);
+  void DeleteNode(AdjListNode *node);
+  bool HelpUnlinkNode(AdjListNode *&head, int dest);
+  bool HelpSetNodeWeight(AdjListNode *head, int dest, const E &weight);
+  bool HelpTracksInEdges() const;
+  void HelpBuildInLists();
+  void HelpFreeInLists();
   void HelpDepthFirstSearch(int vertex, void (*visit)(const T &vertex), bool *visited) const;
   void HelpBreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex), bool *visited) const;
+  template <typename F>
+  bool HelpDepthFirstSearch(int vertex, int depth, F &visit, TraversalContext &context) const;
   void HelpFloyd(E **distance, int **path) const;
+  int HelpPageRank(const double *teleport, double *scores, double damping, double tolerance, int max_iteration) const;
+  void HelpOrientByDegree(CSRGraph<E> &oriented, int *degrees) const;
+  static long long HelpIntersect(const int *a, int a_len, const int *b, int b_len, long long *vertex_triangles);
+  long long HelpCountTriangles(int *degrees, long long *vertex_triangles) const;
+  void HelpGlobalRelabel(int source, int sink, const int *offsets, const int *targets, const E *capacity,
+                         const int *reverse, int *height) const;
 
 public:
   AdjLsitgraph(bool is_directed, int capacity = 10) : m_is_directed(is_directed), m_vertex_count(0),
-                                                      m_edge_count(0), m_vertex_capacity(capacity) {
+                                                      m_edge_count(0), m_vertex_capacity(capacity),
+                                                      m_lazy_removal(false), m_in_edge_index(false), m_removed_count(0),
+                                                      m_free_nodes(nullptr), m_free_count(0), m_node_blocks(nullptr),
+                                                      m_block_count(0), m_block_capacity(0) {
     m_vertexs = new Vertex[m_vertex_capacity];
   }
   virtual ~AdjLsitgraph();
 
+  // 预分配
+  void ReserveVertices(int vertex_capacity); // 预留顶点数组容量
+  void ReserveEdges(int edge_capacity);      // 预留边或弧的结点
+
   // 顶点相关操作
   int GetVertexCount() const;                        // 获取顶点数量
   bool InsertVertex(const T &vertex);                // 插入顶点
@@ -148,8 +198,21 @@ public:
   int GetVertexIndex(const T &vertex) const;         // 获取顶点的索引
   bool GetVertexByIndex(int index, T &vertex) const; // 根据索引获取顶点
 
+  // 延迟删除：删除顶点只留下墓碑，索引保持不变，直到 Compact
+  void SetLazyRemoval(bool enable);      // 开启或关闭延迟删除模式
+  bool IsVertexRemoved(int index) const; // 顶点是否已被删除（墓碑）
+  int GetLiveVertexCount() const;        // 未被删除的顶点数量
+  int Compact(int *mapping = nullptr);   // 回收墓碑，一次性重新编号
+
+  // 入边表（有向图）：入度始终是 O(1)，开启后还可以 O(入度) 遍历前驱
+  void SetInEdgeIndex(bool enable); // 开启或关闭入边表
+  bool HasInEdgeIndex() const;      // 是否可以遍历前驱
+  template <typename F>
+  bool ForEachPredecessor(int vertex, F visit) const; // 依次以 (前驱顶点, 权值) 调用 visit
+
   // 边或弧相关操作
   bool InsertEdge(int src, int dest, const E &weight);    // 插入边或弧
+  int InsertEdges(const int *srcs, const int *dests, const E *weights, int count, bool is_unique = false); // 批量插入边或弧
   bool RemoveEdge(int src, int dest);                     // 删除边或弧
   bool IsEdgeExist(int src, int dest) const;              // 判断边或弧是否存在
   bool GetEdgeWeight(int src, int dest, E &weight) const; // 获取边或弧的权值
@@ -158,13 +221,30 @@ public:
   // 图的遍历
   void DepthFirstSearch(int start_vertex, void (*visit)(const T &vertex)) const;   // 深度优先遍历
   void BreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex)) const; // 广度优先遍历
+  void BreadthFirstDistance(int start_vertex, int *distance) const;                 // 求跳数距离，方向优化的广度优先
+
+  // 复用遍历上下文：不分配内存，只访问起始顶点可达的部分，代价与访问到的顶点和边成正比
+  void DepthFirstSearch(int start_vertex, void (*visit)(const T &vertex), TraversalContext &context) const;   // 深度优先遍历
+  void BreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex), TraversalContext &context) const; // 广度优先遍历
+
+  // 任意可调用对象作为访问器，以 (顶点, 索引, 深度) 调用，返回 true 时立即停止遍历；可以内联，也可以带状态
+  template <typename F>
+  bool DepthFirstSearch(int start_vertex, F visit) const; // 深度优先遍历，返回是否被提前停止
+  template <typename F>
+  bool BreadthFirstSearch(int start_vertex, F visit) const; // 广度优先遍历，返回是否被提前停止
+  template <typename F>
+  bool DepthFirstSearch(int start_vertex, F visit, TraversalContext &context) const; // 复用遍历上下文
+  template <typename F>
+  bool BreadthFirstSearch(int start_vertex, F visit, TraversalContext &context) const; // 复用遍历上下文
 
   // 最短路径算法
   void Dijkstra(int start_vertex, E *distance) const; // Dijkstra 算法
+  void Dijkstra(int start_vertex, E *distance, TraversalContext &context) const; // 堆优化的 Dijkstra，只写入可达顶点
   void Floyd(E **distance, int **path) const;                    // Floyd 算法
 
   // // 拓扑排序
   bool TopologicalSort(T *sorted_vertices) const; // 拓扑排序
+  bool TopologicalSort(T *sorted_vertices, TraversalContext &context) const; // 拓扑排序，复用遍历上下文
 
   // // 最小生成树算法:其实两个最小生成树算法，最终目的还是得到一个能够连通所有顶点，且边的总权值最小的边的集合
   void Prim(int start_vertex, TripletSparseMatrix<E>& matrix) const; // Prim 算法
@@ -174,6 +254,35 @@ public:
   int GetInDegree(int vertex) const;  // 获取顶点的入度
   int GetOutDegree(int vertex) const; // 获取顶点的出度
 
+  // 导出快照
+  void ToCSRGraph(CSRGraph<E> &csr) const; // 导出为 CSR 快照
+  void ToCompressedGraph(CompressedGraph<E> &graph, bool with_weights = true) const; // 导出为压缩邻接表
+
+  // 顶点重排
+  bool Relabel(const int *permutation);                 // 按给定的映射重新编号顶点
+  bool Reorder(VertexOrder order, int *permutation);    // 计算重排并重新编号，输出映射
+
+  // 链接分析
+  int PageRank(double *scores, double damping = 0.85, double tolerance = 1e-6, int max_iteration = 100) const; // PageRank
+  int PersonalizedPageRank(const int *sources, int source_count, double *scores, double damping = 0.85,
+                           double tolerance = 1e-6, int max_iteration = 100) const; // 个性化 PageRank
+
+  // 子图分析（无向图）
+  long long CountTriangles(long long *vertex_triangles = nullptr) const; // 三角形计数
+  bool ClusteringCoefficient(double *coefficients) const;                // 局部聚类系数
+
+  // 局部子图：代价只与访问到的顶点和边有关，与整个图的规模无关
+  int KHopNeighborhood(int start_vertex, int max_depth, SeqList<int> &vertices, SeqList<int> &distances) const; // k 跳邻域
+  bool ExtractSubgraph(const int *vertices, int count, AdjLsitgraph &subgraph) const; // 导出诱导子图
+  bool ExtractSubgraph(const int *vertices, int count, CSRGraph<E> &subgraph) const;  // 导出诱导子图的 CSR 快照
+  bool EgoNetwork(int center, int max_depth, AdjLsitgraph &subgraph) const;          // k 跳邻域的诱导子图
+
+  // 二分图最大匹配（无向图）
+  int MaximumMatching(int *mate) const; // Hopcroft-Karp 最大匹配
+
+  // 网络流（有向图，边的权值即容量）
+  bool MaxFlow(int source, int sink, E &max_flow, bool *source_side = nullptr) const; // 最大流与最小割
+
   // 清空图
   void Clear(); // 清空图中的所有顶点和边
 };
@@ -188,38 +297,231 @@ public:
 
 /**
  * *****************************************************************
- * @brief : 扩容，只在顶点放满的情况下
+ * @brief : 扩容，顶点数组整体搬移到新的容量
  * @tparam T
  * @tparam E
+ * @tparam H
+ * @param  new_capacity 新的容量，不小于当前顶点数量
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjLsitgraph<T, E>::ResizeVertexs() {
-  m_vertex_capacity *= 2;
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::ResizeVertexs(int new_capacity) {
+  m_vertex_capacity = new_capacity;
   Vertex *new_base = new Vertex[m_vertex_capacity];
 
   for (int i = 0; i < m_vertex_count; ++i) {
     new_base[i].m_data = m_vertexs[i].m_data;
     new_base[i].m_adj_list = m_vertexs[i].m_adj_list;
+    new_base[i].m_in_list = m_vertexs[i].m_in_list;
+    new_base[i].m_removed = m_vertexs[i].m_removed;
+    new_base[i].m_in_degree = m_vertexs[i].m_in_degree;
     m_vertexs[i].m_adj_list = nullptr;
+    m_vertexs[i].m_in_list = nullptr;
   }
 
   delete[] m_vertexs;
   m_vertexs = new_base;
 }
 
+/**
+ * *****************************************************************
+ * @brief : 分配一整块邻接表结点，并挂到空闲链表上
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  block_size 本块的结点个数
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::AllocateNodeBlock(int block_size) {
+  // 结点块指针数组放满时扩容
+  if (m_block_count == m_block_capacity) {
+    m_block_capacity = m_block_capacity == 0 ? 8 : m_block_capacity * 2;
+    AdjListNode **new_blocks = new AdjListNode *[m_block_capacity];
+    for (int i = 0; i < m_block_count; ++i) {
+      new_blocks[i] = m_node_blocks[i];
+    }
+    delete[] m_node_blocks;
+    m_node_blocks = new_blocks;
+  }
+
+  AdjListNode *block = new AdjListNode[block_size];
+  m_node_blocks[m_block_count++] = block;
+
+  // 倒序串联，使得取结点的顺序与内存顺序一致
+  for (int i = block_size - 1; i >= 0; --i) {
+    block[i].m_next = m_free_nodes;
+    m_free_nodes = &block[i];
+  }
+  m_free_count += block_size;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 从空闲链表中取出一个结点
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  dest
+ * @param  weight
+ * @return AdjListNode*
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline typename AdjLsitgraph<T, E, H>::AdjListNode *AdjLsitgraph<T, E, H>::NewNode(int dest, const E &weight) {
+  if (m_free_nodes == nullptr) {
+    // 每次按已有边数成倍增长，避免逐个分配
+    AllocateNodeBlock(m_edge_count < 16 ? 16 : m_edge_count);
+  }
+
+  AdjListNode *node = m_free_nodes;
+  m_free_nodes = node->m_next;
+  --m_free_count;
+
+  node->m_dest = dest;
+  node->m_weight = weight;
+  node->m_next = nullptr;
+  return node;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 回收结点到空闲链表
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  node
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::DeleteNode(AdjListNode *node) {
+  node->m_next = m_free_nodes;
+  m_free_nodes = node;
+  ++m_free_count;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 从链表中摘下第一个 m_dest 等于 dest 的结点并回收
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  head 链表头指针
+ * @param  dest
+ * @return true
+ * @return false 没有找到
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::HelpUnlinkNode(AdjListNode *&head, int dest) {
+  AdjListNode *previous = nullptr;
+  for (AdjListNode *current = head; current != nullptr; current = current->m_next) {
+    if (current->m_dest == dest) {
+      if (previous == nullptr) {
+        head = current->m_next;
+      } else {
+        previous->m_next = current->m_next;
+      }
+      DeleteNode(current);
+      return true;
+    }
+    previous = current;
+  }
+  return false;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 是否维护入边表：有向图在延迟删除模式或开启入边表时维护
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::HelpTracksInEdges() const {
+  return m_is_directed && (m_lazy_removal || m_in_edge_index);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 设置链表中第一个 m_dest 等于 dest 的结点的权值
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  head 链表头指针
+ * @param  dest
+ * @param  weight
+ * @return true
+ * @return false 没有找到
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::HelpSetNodeWeight(AdjListNode *head, int dest, const E &weight) {
+  for (AdjListNode *current = head; current != nullptr; current = current->m_next) {
+    if (current->m_dest == dest) {
+      current->m_weight = weight;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 由邻接表建立入边表
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::HelpBuildInLists() {
+  for (int u = 0; u < m_vertex_count; ++u) {
+    for (AdjListNode *current = m_vertexs[u].m_adj_list; current != nullptr; current = current->m_next) {
+      AdjListNode *in_node = NewNode(u, current->m_weight);
+      in_node->m_next = m_vertexs[current->m_dest].m_in_list;
+      m_vertexs[current->m_dest].m_in_list = in_node;
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 回收所有入边表
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::HelpFreeInLists() {
+  for (int v = 0; v < m_vertex_count; ++v) {
+    AdjListNode *current = m_vertexs[v].m_in_list;
+    while (current != nullptr) {
+      AdjListNode *temp = current;
+      current = current->m_next;
+      DeleteNode(temp);
+    }
+    m_vertexs[v].m_in_list = nullptr;
+  }
+}
+
 /**
  * *****************************************************************
  * @brief : 辅助深度优先搜索
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex
  * @param  visit
  * @param  visited
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjLsitgraph<T, E>::HelpDepthFirstSearch(int vertex, void (*visit)(const T &vertex), bool *visited) const {
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::HelpDepthFirstSearch(int vertex, void (*visit)(const T &vertex), bool *visited) const {
   // 标记当前顶点为已访问
   visited[vertex] = true;
 
@@ -241,13 +543,14 @@ inline void AdjLsitgraph<T, E>::HelpDepthFirstSearch(int vertex, void (*visit)(c
  * @brief : 辅助广度优先搜索
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  start_vertex
  * @param  visit
  * @param  visited
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjLsitgraph<T, E>::HelpBreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex), bool *visited) const {
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::HelpBreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex), bool *visited) const {
   // 创建队列并将起始顶点入队
   SeqQueue<int> vertex_queue(m_vertex_count);
   vertex_queue.EnQueue(start_vertex);
@@ -275,17 +578,49 @@ inline void AdjLsitgraph<T, E>::HelpBreadthFirstSearch(int start_vertex, void (*
   }
 }
 
+/**
+ * *****************************************************************
+ * @brief : 辅助深度优先搜索，访问标记记在遍历上下文中
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @tparam F
+ * @param  vertex
+ * @param  depth 深度优先树中的深度
+ * @param  visit
+ * @param  context
+ * @return true 访问器要求停止
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+template <typename F>
+inline bool AdjLsitgraph<T, E, H>::HelpDepthFirstSearch(int vertex, int depth, F &visit, TraversalContext &context) const {
+  context.Visit(vertex);
+  if (visit(m_vertexs[vertex].m_data, vertex, depth)) {
+    return true;
+  }
+
+  for (AdjListNode *current = m_vertexs[vertex].m_adj_list; current != nullptr; current = current->m_next) {
+    if (!context.IsVisited(current->m_dest) && HelpDepthFirstSearch(current->m_dest, depth + 1, visit, context)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /**
  * *****************************************************************
  * @brief : 辅助Floyd 算法，初始化两个矩阵
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  distance
  * @param  path
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjLsitgraph<T, E>::HelpFloyd(E **distance, int **path) const {
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::HelpFloyd(E **distance, int **path) const {
   // 初始化距离矩阵和路径矩阵
   // distance[i][j] 表示顶点 i 到顶点 j 的最短路径长度
   // path[i][j] 表示从顶点 i 到顶点 j 的路径上，j 的前驱顶点
@@ -312,11 +647,51 @@ inline void AdjLsitgraph<T, E>::HelpFloyd(E **distance, int **path) const {
  * @brief : Destroy the Adj Lsitgraph< T,  E>:: Adj Lsitgraph object
  * @tparam T
  * @tparam E
+ * @tparam H
  * *****************************************************************
  */
-template <typename T, typename E>
-inline AdjLsitgraph<T, E>::~AdjLsitgraph() {
+template <typename T, typename E, typename H>
+inline AdjLsitgraph<T, E, H>::~AdjLsitgraph() {
   Clear();
+  delete[] m_vertexs;
+  delete[] m_node_blocks;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 预留顶点数组容量，批量插入顶点前调用可避免多次扩容
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  vertex_capacity
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::ReserveVertices(int vertex_capacity) {
+  if (vertex_capacity > m_vertex_capacity) {
+    ResizeVertexs(vertex_capacity);
+  }
+  m_vertex_index.Reserve(vertex_capacity);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 预留边或弧的结点，无向图每条边占两个结点
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  edge_capacity 图中边或弧的总数上限
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::ReserveEdges(int edge_capacity) {
+  int node_count = m_is_directed ? edge_capacity : 2 * edge_capacity;
+
+  // m_edge_count 统计的是邻接表中的结点个数
+  int need = node_count - m_edge_count - m_free_count;
+  if (need > 0) {
+    AllocateNodeBlock(need);
+  }
 }
 
 /**
@@ -324,11 +699,12 @@ inline AdjLsitgraph<T, E>::~AdjLsitgraph() {
  * @brief : 获取顶点数量
  * @tparam T
  * @tparam E
+ * @tparam H
  * @return int
  * *****************************************************************
  */
-template <typename T, typename E>
-inline int AdjLsitgraph<T, E>::GetVertexCount() const {
+template <typename T, typename E, typename H>
+inline int AdjLsitgraph<T, E, H>::GetVertexCount() const {
   return m_vertex_count;
 }
 
@@ -337,28 +713,31 @@ inline int AdjLsitgraph<T, E>::GetVertexCount() const {
  * @brief : 插入顶点
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex
  * @return true
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjLsitgraph<T, E>::InsertVertex(const T &vertex) {
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::InsertVertex(const T &vertex) {
   // 检查顶点是否已存在
-  for (int i = 0; i < m_vertex_count; ++i) {
-    if (m_vertexs[i].m_data == vertex) {
-      return false; // 顶点已存在，插入失败
-    }
+  if (m_vertex_index.Contains(vertex)) {
+    return false; // 顶点已存在，插入失败
   }
 
   // 检查是否超过了当前的顶点容量
   if (m_vertex_count == m_vertex_capacity) {
-    ResizeVertexs();
+    ResizeVertexs(m_vertex_capacity * 2);
   }
 
   // 插入新的顶点
   m_vertexs[m_vertex_count].m_data = vertex;
   m_vertexs[m_vertex_count].m_adj_list = nullptr; // 初始化邻接表为空
+  m_vertexs[m_vertex_count].m_in_list = nullptr;
+  m_vertexs[m_vertex_count].m_removed = false;
+  m_vertexs[m_vertex_count].m_in_degree = 0;
+  m_vertex_index.Insert(vertex, m_vertex_count);
   ++m_vertex_count;                               // 更新顶点数量
 
   return true; // 插入成功
@@ -369,60 +748,75 @@ inline bool AdjLsitgraph<T, E>::InsertVertex(const T &vertex) {
  * @brief : 删除顶点，影响整体结构
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex
  * @return true
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjLsitgraph<T, E>::RemoveVertex(const T &vertex) {
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::RemoveVertex(const T &vertex) {
   // 查找顶点索引
   int vertex_index = GetVertexIndex(vertex);
   if (vertex_index == -1) {
     return false; // 顶点不存在，删除失败
   }
 
-  // 删除该顶点的邻接表
+  // 删除该顶点的邻接表，无向图同时删除邻接顶点中的反向边，
+  // 有向图减少邻接顶点的入度，维护入边表时同时删除其中的对应结点
   AdjListNode *adj_node = m_vertexs[vertex_index].m_adj_list;
   while (adj_node != nullptr) {
     AdjListNode *temp = adj_node;
     adj_node = adj_node->m_next;
-    delete temp;
+    if (temp->m_dest != vertex_index) {
+      if (!m_is_directed) {
+        if (HelpUnlinkNode(m_vertexs[temp->m_dest].m_adj_list, vertex_index)) {
+          m_edge_count--;
+        }
+      } else {
+        m_vertexs[temp->m_dest].m_in_degree--;
+        if (HelpTracksInEdges()) {
+          HelpUnlinkNode(m_vertexs[temp->m_dest].m_in_list, vertex_index);
+        }
+      }
+    }
+    DeleteNode(temp);
     m_edge_count--; // 更新边的数量
   }
   m_vertexs[vertex_index].m_adj_list = nullptr;
 
-  // 删除其他顶点指向该顶点的边
-  for (int i = 0; i < m_vertex_count; ++i) {
-    if (i != vertex_index) {
-      AdjListNode *prev = nullptr;
-      AdjListNode *current = m_vertexs[i].m_adj_list;
-
-      while (current != nullptr) {
-        if (current->m_dest == vertex_index) { //指向删除的顶点位置
-          if (prev == nullptr) {
-            m_vertexs[i].m_adj_list = current->m_next;
-          } else {
-            prev->m_next = current->m_next;
-          }
-          delete current;
+  // 删除其他顶点指向该顶点的弧
+  if (HelpTracksInEdges()) {
+    // 入边表给出了所有起点，只需要访问这些顶点的邻接表
+    AdjListNode *in_node = m_vertexs[vertex_index].m_in_list;
+    while (in_node != nullptr) {
+      AdjListNode *temp = in_node;
+      in_node = in_node->m_next;
+      if (temp->m_dest != vertex_index && HelpUnlinkNode(m_vertexs[temp->m_dest].m_adj_list, vertex_index)) {
+        m_edge_count--;
+      }
+      DeleteNode(temp);
+    }
+    m_vertexs[vertex_index].m_in_list = nullptr;
+  } else if (m_is_directed) {
+    for (int i = 0; i < m_vertex_count; ++i) {
+      if (i != vertex_index) {
+        while (HelpUnlinkNode(m_vertexs[i].m_adj_list, vertex_index)) {
           m_edge_count--; // 更新边的数量
-          break;
         }
-        prev = current;
-        current = current->m_next;
       }
     }
   }
 
-  // 移动顶点数组，填补删除顶点的位置
-  for (int i = vertex_index; i < m_vertex_count - 1; ++i) {
-    m_vertexs[i] = m_vertexs[i + 1]; // 移动顶点
+  // 留下墓碑，非延迟删除模式下立即压缩，后面的顶点前移并重新编号
+  m_vertexs[vertex_index].m_in_degree = 0;
+  m_vertexs[vertex_index].m_removed = true;
+  ++m_removed_count;
+  m_vertex_index.Remove(vertex);
+  if (!m_lazy_removal) {
+    Compact();
   }
 
-  // 更新顶点数量
-  m_vertex_count--;
-
   return true; // 删除成功
 }
 
@@ -431,19 +825,17 @@ inline bool AdjLsitgraph<T, E>::RemoveVertex(const T &vertex) {
  * @brief : 获取顶点的索引
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex
  * @return int 如果是-1，则不存在这个索引
  * *****************************************************************
  */
-template <typename T, typename E>
-inline int AdjLsitgraph<T, E>::GetVertexIndex(const T &vertex) const {
+template <typename T, typename E, typename H>
+inline int AdjLsitgraph<T, E, H>::GetVertexIndex(const T &vertex) const {
   // 查找顶点的索引
   int index = -1;
-  for (int i = 0; i < m_vertex_count; ++i) {
-    if (m_vertexs[i].m_data == vertex) {
-      index = i;
-      break;
-    }
+  if (!m_vertex_index.Find(vertex, index)) {
+    index = -1;
   }
 
   return index;
@@ -454,15 +846,16 @@ inline int AdjLsitgraph<T, E>::GetVertexIndex(const T &vertex) const {
  * @brief : 根据索引获取顶点
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  index 0开始
  * @param  vertex
  * @return true
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjLsitgraph<T, E>::GetVertexByIndex(int index, T &vertex) const {
-  if (index < 0 || index > m_vertex_count) {
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::GetVertexByIndex(int index, T &vertex) const {
+  if (index < 0 || index >= m_vertex_count || m_vertexs[index].m_removed) {
     vertex = T();
     return false;
   }
@@ -473,126 +866,416 @@ inline bool AdjLsitgraph<T, E>::GetVertexByIndex(int index, T &vertex) const {
 
 /**
  * *****************************************************************
- * @brief :
+ * @brief : 开启或关闭延迟删除模式。
+ *          开启后删除顶点只删除与它关联的边并留下墓碑，其他顶点的索引不变，有向图另外维护入边表，
+ *          删除时只需访问邻接顶点的链表，不必扫描整个图。墓碑顶点没有任何边，遍历和拓扑排序会跳过它们；
+ *          其余按索引输出结果的算法把它们当作孤立顶点，需要时先调用 Compact。
+ *          关闭时先压缩，再回收入边表
  * @tparam T
  * @tparam E
- * @param  vertex1
- * @param  vertex2
- * @param  weight
- * @return true
- * @return false
+ * @tparam H
+ * @param  enable
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjLsitgraph<T, E>::InsertEdge(int src, int dest, const E &weight) {
-  // 检查源和目标顶点的有效性
-  if (src < 0 || src >= m_vertex_count || dest < 0 || dest >= m_vertex_count) {
-    return false;
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::SetLazyRemoval(bool enable) {
+  if (enable == m_lazy_removal) {
+    return;
   }
 
-  // 创建新的邻接表节点
-  AdjListNode *new_node = new AdjListNode(dest, weight);
-  
-  // 将新节点插入到源顶点的邻接表中
-  new_node->m_next = m_vertexs[src].m_adj_list;
-  m_vertexs[src].m_adj_list = new_node;
-  
-
-  // 如果是无向图，还需要插入反向边
-  if (!m_is_directed) {
-    AdjListNode *reverse_node = new AdjListNode(src, weight);
-    reverse_node->m_next = m_vertexs[dest].m_adj_list;
-    m_vertexs[dest].m_adj_list = reverse_node;
-
-    // 增加边的计数
-    m_edge_count++;
+  if (enable) {
+    if (m_is_directed && !m_in_edge_index) {
+      HelpBuildInLists();
+    }
+    m_lazy_removal = true;
+  } else {
+    Compact();
+    if (m_is_directed && !m_in_edge_index) {
+      HelpFreeInLists();
+    }
+    m_lazy_removal = false;
   }
-
-  // 增加边的计数
-  m_edge_count++;
-  return true;
 }
 
 /**
  * *****************************************************************
- * @brief : 删除边或弧
+ * @brief : 顶点是否已被删除（墓碑）
  * @tparam T
  * @tparam E
- * @param  src
- * @param  dest
+ * @tparam H
+ * @param  index
  * @return true
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjLsitgraph<T, E>::RemoveEdge(int src, int dest) {
-  // 检查源和目标顶点的有效性
-  if (src < 0 || src >= m_vertex_count || dest < 0 || dest >= m_vertex_count) {
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::IsVertexRemoved(int index) const {
+  if (index < 0 || index >= m_vertex_count) {
     return false;
   }
+  return m_vertexs[index].m_removed;
+}
 
-  // 从源顶点的邻接表中删除目标顶点
-  AdjListNode *current = m_vertexs[src].m_adj_list;
-  AdjListNode *previous = nullptr;
+/**
+ * *****************************************************************
+ * @brief : 未被删除的顶点数量，GetVertexCount 在压缩之前还包含墓碑
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @return int
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline int AdjLsitgraph<T, E, H>::GetLiveVertexCount() const {
+  return m_vertex_count - m_removed_count;
+}
 
-  while (current != nullptr) {
-    if (current->m_dest == dest) {
-      if (previous == nullptr) {
-        // 删除的是头结点
-        m_vertexs[src].m_adj_list = current->m_next;
-      } else {
-        // 删除的是中间或尾部节点
-        previous->m_next = current->m_next;
-      }
-      delete current;
-      break; // 找到并删除后退出
-    }
-    previous = current;
-    current = current->m_next;
+/**
+ * *****************************************************************
+ * @brief : 回收墓碑，一次遍历完成重新编号：存活的顶点保持相对顺序前移，邻接表和入边表中的索引一起改写
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  mapping 可选，输出 mapping[旧索引] = 新索引，墓碑为 -1，长度为压缩前的顶点数量
+ * @return int 回收的墓碑个数
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline int AdjLsitgraph<T, E, H>::Compact(int *mapping) {
+  const int n = m_vertex_count;
+  int *new_index = mapping ? mapping : new int[n > 0 ? n : 1];
+
+  int live_count = 0;
+  for (int i = 0; i < n; ++i) {
+    new_index[i] = m_vertexs[i].m_removed ? -1 : live_count++;
   }
 
-  // 如果是无向图，还需要在目标顶点的邻接表中删除反向边
-  if (!m_is_directed) {
-    current = m_vertexs[dest].m_adj_list;
-    previous = nullptr;
+  int removed = m_removed_count;
+  if (removed > 0) {
+    for (int i = 0; i < n; ++i) {
+      if (m_vertexs[i].m_removed) {
+        continue;
+      }
 
-    while (current != nullptr) {
-      if (current->m_dest == src) {
-        if (previous == nullptr) {
-          // 删除的是头结点
-          m_vertexs[dest].m_adj_list = current->m_next;
-        } else {
-          // 删除的是中间或尾部节点
-          previous->m_next = current->m_next;
-        }
-        delete current;
-        break; // 找到并删除后退出
+      // 墓碑顶点的边已经全部删除，链表中只会出现存活的顶点
+      for (AdjListNode *current = m_vertexs[i].m_adj_list; current != nullptr; current = current->m_next) {
+        current->m_dest = new_index[current->m_dest];
+      }
+      for (AdjListNode *current = m_vertexs[i].m_in_list; current != nullptr; current = current->m_next) {
+        current->m_dest = new_index[current->m_dest];
+      }
+
+      if (new_index[i] != i) {
+        m_vertexs[new_index[i]] = m_vertexs[i];
+        m_vertex_index.Insert(m_vertexs[i].m_data, new_index[i]); // 同步哈希表中的索引
       }
-      previous = current;
-      current = current->m_next;
     }
+
+    for (int i = live_count; i < n; ++i) {
+      m_vertexs[i] = Vertex();
+    }
+    m_vertex_count = live_count;
+    m_removed_count = 0;
   }
 
-  // 减少边的计数
-  m_edge_count--;
+  if (!mapping) {
+    delete[] new_index;
+  }
+  return removed;
+}
 
-  return true;
+/**
+ * *****************************************************************
+ * @brief : 开启或关闭入边表。入边表与邻接表一样用结点池中的结点，每条弧多占一个结点，
+ *          之后插入、删除弧时同步维护；无向图的邻接表本身就是对称的，不需要入边表
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  enable
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::SetInEdgeIndex(bool enable) {
+  if (enable == m_in_edge_index) {
+    return;
+  }
+
+  bool had_in_lists = HelpTracksInEdges();
+  m_in_edge_index = enable;
+  if (m_is_directed && !had_in_lists && HelpTracksInEdges()) {
+    HelpBuildInLists();
+  } else if (m_is_directed && had_in_lists && !HelpTracksInEdges()) {
+    HelpFreeInLists();
+  }
 }
 
 /**
  * *****************************************************************
- * @brief : 判断边或弧是否存在
+ * @brief : 是否可以遍历前驱：无向图总是可以，有向图需要维护入边表
  * @tparam T
  * @tparam E
- * @param  src
- * @param  dest
+ * @tparam H
  * @return true
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjLsitgraph<T, E>::IsEdgeExist(int src, int dest) const {
-  // 检查源和目标顶点的有效性
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::HasInEdgeIndex() const {
+  return !m_is_directed || HelpTracksInEdges();
+}
+
+/**
+ * *****************************************************************
+ * @brief : 依次以 (前驱顶点, 权值) 调用 visit，代价 O(入度)
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @tparam F 可调用对象，形如 void(int src, const E &weight)
+ * @param  vertex
+ * @param  visit
+ * @return true
+ * @return false 顶点非法，或者有向图没有维护入边表
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+template <typename F>
+inline bool AdjLsitgraph<T, E, H>::ForEachPredecessor(int vertex, F visit) const {
+  if (vertex < 0 || vertex >= m_vertex_count || !HasInEdgeIndex()) {
+    return false;
+  }
+
+  AdjListNode *current = m_is_directed ? m_vertexs[vertex].m_in_list : m_vertexs[vertex].m_adj_list;
+  for (; current != nullptr; current = current->m_next) {
+    visit(current->m_dest, current->m_weight);
+  }
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief :
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  vertex1
+ * @param  vertex2
+ * @param  weight
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::InsertEdge(int src, int dest, const E &weight) {
+  // 检查源和目标顶点的有效性
+  if (src < 0 || src >= m_vertex_count || dest < 0 || dest >= m_vertex_count ||
+      m_vertexs[src].m_removed || m_vertexs[dest].m_removed) {
+    return false;
+  }
+
+  // 创建新的邻接表节点
+  AdjListNode *new_node = NewNode(dest, weight);
+  
+  // 将新节点插入到源顶点的邻接表中
+  new_node->m_next = m_vertexs[src].m_adj_list;
+  m_vertexs[src].m_adj_list = new_node;
+  
+  // 有向图维护入度，需要时还要记录入边
+  if (m_is_directed) {
+    m_vertexs[dest].m_in_degree++;
+  }
+  if (HelpTracksInEdges()) {
+    AdjListNode *in_node = NewNode(src, weight);
+    in_node->m_next = m_vertexs[dest].m_in_list;
+    m_vertexs[dest].m_in_list = in_node;
+  }
+
+  // 如果是无向图，还需要插入反向边
+  if (!m_is_directed) {
+    AdjListNode *reverse_node = NewNode(src, weight);
+    reverse_node->m_next = m_vertexs[dest].m_adj_list;
+    m_vertexs[dest].m_adj_list = reverse_node;
+
+    // 增加边的计数
+    m_edge_count++;
+  }
+
+  // 增加边的计数
+  m_edge_count++;
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 批量插入边或弧，先按源顶点分组，再一次性建立邻接表
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  srcs 源顶点索引数组
+ * @param  dests 目标顶点索引数组
+ * @param  weights 权值数组
+ * @param  count 边或弧的个数
+ * @param  is_unique 调用者保证批次内、以及与图中已有的边都不重复时为 true，跳过去重
+ * @return int 实际插入的边或弧的个数
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline int AdjLsitgraph<T, E, H>::InsertEdges(const int *srcs, const int *dests, const E *weights, int count, bool is_unique) {
+  if (count <= 0) {
+    return 0;
+  }
+
+  // 计数排序：按源顶点分组，position[s] 为第 s 组在 order 中的起始位置
+  int *position = new int[m_vertex_count + 1];
+  for (int i = 0; i <= m_vertex_count; ++i) {
+    position[i] = 0;
+  }
+  for (int i = 0; i < count; ++i) {
+    if (srcs[i] >= 0 && srcs[i] < m_vertex_count && dests[i] >= 0 && dests[i] < m_vertex_count &&
+        !m_vertexs[srcs[i]].m_removed && !m_vertexs[dests[i]].m_removed) {
+      ++position[srcs[i] + 1];
+    }
+  }
+  for (int i = 1; i <= m_vertex_count; ++i) {
+    position[i] += position[i - 1];
+  }
+
+  int valid_count = position[m_vertex_count];
+  int *order = new int[valid_count > 0 ? valid_count : 1];
+  for (int i = 0; i < count; ++i) {
+    if (srcs[i] >= 0 && srcs[i] < m_vertex_count && dests[i] >= 0 && dests[i] < m_vertex_count &&
+        !m_vertexs[srcs[i]].m_removed && !m_vertexs[dests[i]].m_removed) {
+      order[position[srcs[i]]++] = i;
+    }
+  }
+
+  // 一次性预留所有结点
+  ReserveEdges((m_is_directed ? m_edge_count : m_edge_count / 2) + valid_count);
+
+  // 去重标记：mark[d] == s 表示当前源顶点 s 已经有指向 d 的边
+  int *mark = nullptr;
+  if (!is_unique) {
+    mark = new int[m_vertex_count];
+    for (int i = 0; i < m_vertex_count; ++i) {
+      mark[i] = -1;
+    }
+  }
+
+  int inserted = 0;
+  int begin = 0;
+  for (int src = 0; src < m_vertex_count; ++src) {
+    // 分组后 position[src] 恰好是第 src 组的结束位置
+    int end = position[src];
+    if (begin == end) {
+      continue;
+    }
+
+    if (!is_unique) {
+      // 标记已有的出边，整组只扫描一次邻接表
+      for (AdjListNode *current = m_vertexs[src].m_adj_list; current != nullptr; current = current->m_next) {
+        mark[current->m_dest] = src;
+      }
+    }
+
+    for (int k = begin; k < end; ++k) {
+      int i = order[k];
+      int dest = dests[i];
+      if (!is_unique) {
+        if (mark[dest] == src) {
+          continue; // 重复的边或弧
+        }
+        mark[dest] = src;
+      }
+
+      AdjListNode *new_node = NewNode(dest, weights[i]);
+      new_node->m_next = m_vertexs[src].m_adj_list;
+      m_vertexs[src].m_adj_list = new_node;
+
+      if (m_is_directed) {
+        m_vertexs[dest].m_in_degree++;
+      }
+      if (HelpTracksInEdges()) {
+        AdjListNode *in_node = NewNode(src, weights[i]);
+        in_node->m_next = m_vertexs[dest].m_in_list;
+        m_vertexs[dest].m_in_list = in_node;
+      }
+
+      // 无向图同时插入反向边，后面处理 dest 组时标记阶段会看到它
+      if (!m_is_directed) {
+        AdjListNode *reverse_node = NewNode(src, weights[i]);
+        reverse_node->m_next = m_vertexs[dest].m_adj_list;
+        m_vertexs[dest].m_adj_list = reverse_node;
+        m_edge_count++;
+      }
+
+      m_edge_count++;
+      ++inserted;
+    }
+
+    begin = end;
+  }
+
+  delete[] mark;
+  delete[] order;
+  delete[] position;
+
+  return inserted;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 删除边或弧
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  src
+ * @param  dest
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::RemoveEdge(int src, int dest) {
+  // 检查源和目标顶点的有效性
+  if (src < 0 || src >= m_vertex_count || dest < 0 || dest >= m_vertex_count) {
+    return false;
+  }
+
+  // 从源顶点的邻接表中删除目标顶点
+  if (!HelpUnlinkNode(m_vertexs[src].m_adj_list, dest)) {
+    return false;
+  }
+  m_edge_count--;
+
+  if (!m_is_directed) {
+    // 无向图还需要在目标顶点的邻接表中删除反向边
+    if (HelpUnlinkNode(m_vertexs[dest].m_adj_list, src)) {
+      m_edge_count--;
+    }
+  } else {
+    m_vertexs[dest].m_in_degree--;
+    if (HelpTracksInEdges()) {
+      HelpUnlinkNode(m_vertexs[dest].m_in_list, src);
+    }
+  }
+
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 判断边或弧是否存在
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  src
+ * @param  dest
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::IsEdgeExist(int src, int dest) const {
+  // 检查源和目标顶点的有效性
   if (src < 0 || src >= m_vertex_count || dest < 0 || dest >= m_vertex_count) {
     return false;
   }
@@ -615,6 +1298,7 @@ inline bool AdjLsitgraph<T, E>::IsEdgeExist(int src, int dest) const {
  * @brief : 获取边或弧的权值
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  src
  * @param  dest
  * @param  weight
@@ -622,8 +1306,8 @@ inline bool AdjLsitgraph<T, E>::IsEdgeExist(int src, int dest) const {
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjLsitgraph<T, E>::GetEdgeWeight(int src, int dest, E &weight) const {
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::GetEdgeWeight(int src, int dest, E &weight) const {
   // 检查源和目标顶点的有效性
   if (src < 0 || src >= m_vertex_count || dest < 0 || dest >= m_vertex_count) {
     weight = E();
@@ -649,6 +1333,7 @@ inline bool AdjLsitgraph<T, E>::GetEdgeWeight(int src, int dest, E &weight) cons
  * @brief : 设置边或弧的权值
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  src
  * @param  dest
  * @param  weight
@@ -656,35 +1341,26 @@ inline bool AdjLsitgraph<T, E>::GetEdgeWeight(int src, int dest, E &weight) cons
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjLsitgraph<T, E>::SetEdgeWeight(int src, int dest, const E &weight) {
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::SetEdgeWeight(int src, int dest, const E &weight) {
   // 检查源和目标顶点的有效性
   if (src < 0 || src >= m_vertex_count || dest < 0 || dest >= m_vertex_count) {
     return false;
   }
 
-  // 遍历源顶点的邻接表，查找目标顶点
-  AdjListNode *current = m_vertexs[src].m_adj_list;
-  while (current != nullptr) {
-    if (current->m_dest == dest) {
-      current->m_weight = weight; // 找到边或弧，设置新的权值
-      return true;
-    }
-    current = current->m_next;
+  // 在源顶点的邻接表中查找目标顶点
+  if (!HelpSetNodeWeight(m_vertexs[src].m_adj_list, dest, weight)) {
+    return false;
   }
 
-  //无向图遍历目标顶点的邻接表，查找源顶点
-
   if (!m_is_directed) {
-    current = m_vertexs[dest].m_adj_list;
-    while (current != nullptr) {
-      if (current->m_dest == src) {
-        current->m_weight = weight; // 找到边或弧，设置新的权值
-        return true;
-      }
-      current = current->m_next;
-    }
+    // 无向图的边在两端的邻接表中各有一个结点
+    HelpSetNodeWeight(m_vertexs[dest].m_adj_list, src, weight);
+  } else if (HelpTracksInEdges()) {
+    // 入边表中的结点是同一条弧的副本，前驱遍历读的是它的权值
+    HelpSetNodeWeight(m_vertexs[dest].m_in_list, src, weight);
   }
+  return true;
 }
 
 /**
@@ -692,21 +1368,22 @@ inline bool AdjLsitgraph<T, E>::SetEdgeWeight(int src, int dest, const E &weight
  * @brief : 深度优先遍历
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  start_vertex
  * @param  visit 自定义处理顶点的函数
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjLsitgraph<T, E>::DepthFirstSearch(int start_vertex, void (*visit)(const T &vertex)) const {
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::DepthFirstSearch(int start_vertex, void (*visit)(const T &vertex)) const {
   // 检查起始顶点是否合法
-  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
+  if (start_vertex < 0 || start_vertex >= m_vertex_count || m_vertexs[start_vertex].m_removed) {
     return; // 非法的起始顶点
   }
 
-  // 创建一个访问标记数组，初始化为 false，表示所有顶点均未被访问
+  // 创建一个访问标记数组，墓碑顶点视为已访问，其余初始化为 false
   bool *visited = new bool[m_vertex_count];
   for (int i = 0; i < m_vertex_count; ++i) {
-    visited[i] = false;
+    visited[i] = m_vertexs[i].m_removed;
   }
 
   HelpDepthFirstSearch(start_vertex, visit, visited);
@@ -719,21 +1396,22 @@ inline void AdjLsitgraph<T, E>::DepthFirstSearch(int start_vertex, void (*visit)
  * @brief : 广度优先遍历
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  start_vertex
  * @param  visit  自定义处理顶点的函数
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjLsitgraph<T, E>::BreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex)) const {
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::BreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex)) const {
   // 检查起始顶点是否合法
-  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
+  if (start_vertex < 0 || start_vertex >= m_vertex_count || m_vertexs[start_vertex].m_removed) {
     return; // 非法的起始顶点
   }
 
-  // 创建一个访问标记数组，初始化为 false，表示所有顶点均未被访问
+  // 创建一个访问标记数组，墓碑顶点视为已访问，其余初始化为 false
   bool *visited = new bool[m_vertex_count];
   for (int i = 0; i < m_vertex_count; ++i) {
-    visited[i] = false;
+    visited[i] = m_vertexs[i].m_removed;
   }
 
   // 遍历所有顶点，以确保每个连通分量的顶点都能被访问
@@ -757,126 +1435,416 @@ inline void AdjLsitgraph<T, E>::BreadthFirstSearch(int start_vertex, void (*visi
 
 /**
  * *****************************************************************
- * @brief : Dijkstra 算法：用于在加权图中计算从起点顶点到其余顶点的最短路径
+ * @brief : 深度优先遍历，复用遍历上下文。与不带上下文的版本不同，只访问从起始顶点可达的顶点，
+ *          不再继续遍历其余连通分量，遍历结束后可用 context.IsVisited 查询哪些顶点可达
  * @tparam T
  * @tparam E
- * @param  start_vertex 起始顶点的索引
- * @param  distance 保存从起点到各顶点的最短距离
+ * @tparam H
+ * @param  start_vertex
+ * @param  visit 自定义处理顶点的函数
+ * @param  context 遍历上下文，容量不足时自动扩容
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjLsitgraph<T, E>::Dijkstra(int start_vertex, E *distance) const {
-  const E INF = std::numeric_limits<E>::max(); // 用于表示无穷大的值
-  // 检查起始顶点的有效性
-  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
-    delete [] distance;
-    distance=nullptr;
-    return;
-  }
-
-  // 初始化distance
-  bool *visited = new bool[m_vertex_count]; // 访问标记数组
-  for (int i = 0; i < m_vertex_count; i++) {
-    distance[i] = INF; // 所有顶点的初始距离设为无穷大
-    visited[i]=false;
-  }
-
-  distance[start_vertex] = 0; // 起点到自身的距离为0
-
-  // Dijkstra 算法核心
-  for (int i = 0; i < m_vertex_count; ++i) {
-    // 选择未访问顶点中距离最小的顶点
-    int u = -1;
-    E min_distance = INF;
-    for (int j = 0; j < m_vertex_count; j++) {
-      if (!visited[j] && distance[j] < min_distance) {
-        u = j;
-        min_distance = distance[j];
-      }
-    }
-
-    if (u == -1) {
-      break; // 若未找到可更新的顶点，退出
-    }
-
-    visited[u] = true; // 标记该顶点已处理
-
-    // 更新与顶点 u 相邻的顶点的距离
-    for (int v = 0; v < m_vertex_count; v++) {
-      //判断两个顶点是否有通路
-      E temp;
-      if (!visited[v] && GetEdgeWeight(u, v, temp)) {
-        
-        E new_dist = distance[u] + temp;
-        if (new_dist < distance[v]) {
-          distance[v] = new_dist; // 更新顶点 v 的最短距离
-        }
-      }
-    }
-  }
-
-  delete[] visited; // 释放内存
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::DepthFirstSearch(int start_vertex, void (*visit)(const T &vertex), TraversalContext &context) const {
+  DepthFirstSearch(start_vertex, [visit](const T &vertex, int, int) { visit(vertex); return false; }, context);
 }
 
 /**
  * *****************************************************************
- * @brief : Floyd 算法
+ * @brief : 广度优先遍历，复用遍历上下文，只访问从起始顶点可达的顶点，
+ *          遍历结束后可用 context.IsVisited 查询哪些顶点可达
  * @tparam T
  * @tparam E
- * @param  distance
- * @param  path
+ * @tparam H
+ * @param  start_vertex
+ * @param  visit 自定义处理顶点的函数
+ * @param  context 遍历上下文，容量不足时自动扩容
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjLsitgraph<T, E>::Floyd(E **distance, int **path) const {
-  HelpFloyd(distance, path); // 初始化矩阵
-
-  // 开始 Floyd 核心算法
-  // k 是中间顶点的索引，通过顶点 k 来更新 i 到 j 的最短路径
-  for (int k = 0; k < m_vertex_count; ++k) {
-    for (int i = 0; i < m_vertex_count; ++i) {
-      for (int j = 0; j < m_vertex_count; ++j) {
-        // 判断经过顶点 k 是否能找到更短的路径
-        if (distance[i][k] != std::numeric_limits<E>::max() &&
-            distance[k][j] != std::numeric_limits<E>::max() &&
-            distance[i][k] + distance[k][j] < distance[i][j]) {
-          distance[i][j] = distance[i][k] + distance[k][j]; // 更新最短路径长度
-          path[i][j] = path[k][j];                          // 更新路径：i 到 j 的前驱改为通过 k 的路径
-        }
-      }
-    }
-  }
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::BreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex), TraversalContext &context) const {
+  BreadthFirstSearch(start_vertex, [visit](const T &vertex, int, int) { visit(vertex); return false; }, context);
 }
 
 /**
  * *****************************************************************
- * @brief : 拓扑排序
+ * @brief : 深度优先遍历，访问器为任意可调用对象，只访问从起始顶点可达的顶点
  * @tparam T
  * @tparam E
- * @param  sorted_vertices
- * @return true
+ * @tparam H
+ * @tparam F bool(const T &vertex, int index, int depth)，返回 true 时停止遍历
+ * @param  start_vertex
+ * @param  visit
+ * @return true 被访问器提前停止
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjLsitgraph<T, E>::TopologicalSort(T *sorted_vertices) const {
-  if (!m_is_directed) {
-    delete[] sorted_vertices;
-    sorted_vertices = nullptr;
-    return false;
-  }
-
-  // 用于存储每个顶点的入度
-  int *in_degrees = new int[m_vertex_count];
-  for (int i = 0; i < m_vertex_count; ++i) {
-    in_degrees[i] = GetInDegree(i); // 获取每个顶点的入度
-  }
+template <typename T, typename E, typename H>
+template <typename F>
+inline bool AdjLsitgraph<T, E, H>::DepthFirstSearch(int start_vertex, F visit) const {
+  TraversalContext context(m_vertex_count);
+  return DepthFirstSearch(start_vertex, visit, context);
+}
 
-  bu_tools::SeqQueue<int> zero_in_degree_queue; // 存放入度为0的顶点索引
+/**
+ * *****************************************************************
+ * @brief : 广度优先遍历，访问器为任意可调用对象，只访问从起始顶点可达的顶点
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @tparam F bool(const T &vertex, int index, int depth)，返回 true 时停止遍历
+ * @param  start_vertex
+ * @param  visit
+ * @return true 被访问器提前停止
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+template <typename F>
+inline bool AdjLsitgraph<T, E, H>::BreadthFirstSearch(int start_vertex, F visit) const {
+  TraversalContext context(m_vertex_count);
+  return BreadthFirstSearch(start_vertex, visit, context);
+}
 
-  // 将所有入度为0的顶点加入队列
-  for (int i = 0; i < m_vertex_count; ++i) {
-    if (in_degrees[i] == 0) {
+/**
+ * *****************************************************************
+ * @brief : 深度优先遍历，访问器为任意可调用对象，复用遍历上下文
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @tparam F bool(const T &vertex, int index, int depth)，depth 为深度优先树中的深度，返回 true 时停止遍历
+ * @param  start_vertex
+ * @param  visit
+ * @param  context 遍历上下文，容量不足时自动扩容
+ * @return true 被访问器提前停止
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+template <typename F>
+inline bool AdjLsitgraph<T, E, H>::DepthFirstSearch(int start_vertex, F visit, TraversalContext &context) const {
+  context.Reserve(m_vertex_count);
+  context.Reset();
+  if (start_vertex < 0 || start_vertex >= m_vertex_count || m_vertexs[start_vertex].m_removed) {
+    return false; // 非法的起始顶点
+  }
+
+  return HelpDepthFirstSearch(start_vertex, 0, visit, context);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 广度优先遍历，访问器为任意可调用对象，复用遍历上下文，队列就是上下文中预分配的数组
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @tparam F bool(const T &vertex, int index, int depth)，depth 为跳数，返回 true 时停止遍历
+ * @param  start_vertex
+ * @param  visit
+ * @param  context 遍历上下文，容量不足时自动扩容
+ * @return true 被访问器提前停止
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+template <typename F>
+inline bool AdjLsitgraph<T, E, H>::BreadthFirstSearch(int start_vertex, F visit, TraversalContext &context) const {
+  context.Reserve(m_vertex_count);
+  context.Reset();
+  if (start_vertex < 0 || start_vertex >= m_vertex_count || m_vertexs[start_vertex].m_removed) {
+    return false; // 非法的起始顶点
+  }
+
+  // 每个顶点只入队一次，队列不会超过顶点个数，不必循环使用；跳数记在暂存区
+  int *vertex_queue = context.GetBuffer();
+  int *depths = context.GetSlots();
+  int head = 0;
+  int tail = 0;
+  vertex_queue[tail++] = start_vertex;
+  depths[start_vertex] = 0;
+  context.Visit(start_vertex);
+
+  while (head < tail) {
+    int current_vertex = vertex_queue[head++];
+    if (visit(m_vertexs[current_vertex].m_data, current_vertex, depths[current_vertex])) {
+      return true;
+    }
+
+    for (AdjListNode *current = m_vertexs[current_vertex].m_adj_list; current != nullptr; current = current->m_next) {
+      if (context.Visit(current->m_dest)) {
+        depths[current->m_dest] = depths[current_vertex] + 1;
+        vertex_queue[tail++] = current->m_dest;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 求从起始顶点出发的跳数距离，方向优化的广度优先搜索：
+ *          前沿较小时自顶向下，从前沿顶点沿出边扩展；前沿的出边数超过未访问顶点的入边数的 1/14 时
+ *          改为自底向上，每个未访问的顶点沿入边找一个在前沿中的前驱，找到即停；前沿重新变小时切回。
+ *          自底向上需要遍历前驱，有向图没有入边表时只用自顶向下
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  start_vertex
+ * @param  distance 输出每个顶点的跳数，不可达为 -1
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::BreadthFirstDistance(int start_vertex, int *distance) const {
+  const int n = m_vertex_count;
+  for (int i = 0; i < n; ++i) {
+    distance[i] = -1;
+  }
+  if (start_vertex < 0 || start_vertex >= n || m_vertexs[start_vertex].m_removed) {
+    return;
+  }
+
+  // 两个阶段的切换参数，取自 Beamer 等人的方向优化广度优先搜索
+  const long long alpha = 14;
+  const long long beta = 24;
+  const bool can_pull = HasInEdgeIndex();
+
+  int *frontier = new int[n];
+  int *next_frontier = new int[n];
+  int frontier_size = 0;
+  long long frontier_edges = 0; // 前沿顶点的出边数
+  long long unvisited_edges = m_edge_count; // 未访问顶点的入边数（近似用剩余的弧数）
+
+  distance[start_vertex] = 0;
+  frontier[frontier_size++] = start_vertex;
+  for (AdjListNode *current = m_vertexs[start_vertex].m_adj_list; current != nullptr; current = current->m_next) {
+    ++frontier_edges;
+  }
+
+  bool bottom_up = false;
+  int depth = 0;
+  while (frontier_size > 0) {
+    // 选择方向
+    if (can_pull && !bottom_up && frontier_edges * alpha > unvisited_edges) {
+      bottom_up = true;
+    } else if (bottom_up && static_cast<long long>(frontier_size) * beta < n) {
+      bottom_up = false;
+    }
+
+    int next_size = 0;
+    long long next_edges = 0;
+    if (!bottom_up) {
+      for (int k = 0; k < frontier_size; ++k) {
+        for (AdjListNode *current = m_vertexs[frontier[k]].m_adj_list; current != nullptr; current = current->m_next) {
+          int dest = current->m_dest;
+          if (distance[dest] == -1) {
+            distance[dest] = depth + 1;
+            next_frontier[next_size++] = dest;
+          }
+        }
+      }
+    } else {
+      for (int v = 0; v < n; ++v) {
+        if (distance[v] != -1 || m_vertexs[v].m_removed) {
+          continue;
+        }
+        AdjListNode *current = m_is_directed ? m_vertexs[v].m_in_list : m_vertexs[v].m_adj_list;
+        for (; current != nullptr; current = current->m_next) {
+          if (distance[current->m_dest] == depth) {
+            distance[v] = depth + 1;
+            next_frontier[next_size++] = v;
+            break;
+          }
+        }
+      }
+    }
+
+    // 统计新前沿的出边，同时从未访问的弧数中扣除
+    for (int k = 0; k < next_size; ++k) {
+      for (AdjListNode *current = m_vertexs[next_frontier[k]].m_adj_list; current != nullptr; current = current->m_next) {
+        ++next_edges;
+      }
+    }
+    unvisited_edges -= next_edges;
+
+    int *temp = frontier;
+    frontier = next_frontier;
+    next_frontier = temp;
+    frontier_size = next_size;
+    frontier_edges = next_edges;
+    ++depth;
+  }
+
+  delete[] frontier;
+  delete[] next_frontier;
+}
+
+/**
+ * *****************************************************************
+ * @brief : Dijkstra 算法：用于在加权图中计算从起点顶点到其余顶点的最短路径
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  start_vertex 起始顶点的索引
+ * @param  distance 保存从起点到各顶点的最短距离
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::Dijkstra(int start_vertex, E *distance) const {
+  const E INF = std::numeric_limits<E>::max(); // 用于表示无穷大的值
+  // 检查起始顶点的有效性
+  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
+    delete [] distance;
+    distance=nullptr;
+    return;
+  }
+
+  // 初始化distance
+  bool *visited = new bool[m_vertex_count]; // 访问标记数组
+  for (int i = 0; i < m_vertex_count; i++) {
+    distance[i] = INF; // 所有顶点的初始距离设为无穷大
+    visited[i]=false;
+  }
+
+  distance[start_vertex] = 0; // 起点到自身的距离为0
+
+  // Dijkstra 算法核心
+  for (int i = 0; i < m_vertex_count; ++i) {
+    // 选择未访问顶点中距离最小的顶点
+    int u = -1;
+    E min_distance = INF;
+    for (int j = 0; j < m_vertex_count; j++) {
+      if (!visited[j] && distance[j] < min_distance) {
+        u = j;
+        min_distance = distance[j];
+      }
+    }
+
+    if (u == -1) {
+      break; // 若未找到可更新的顶点，退出
+    }
+
+    visited[u] = true; // 标记该顶点已处理
+
+    // 更新与顶点 u 相邻的顶点的距离
+    for (int v = 0; v < m_vertex_count; v++) {
+      //判断两个顶点是否有通路
+      E temp;
+      if (!visited[v] && GetEdgeWeight(u, v, temp)) {
+        
+        E new_dist = distance[u] + temp;
+        if (new_dist < distance[v]) {
+          distance[v] = new_dist; // 更新顶点 v 的最短距离
+        }
+      }
+    }
+  }
+
+  delete[] visited; // 释放内存
+}
+
+/**
+ * *****************************************************************
+ * @brief : 堆优化的 Dijkstra 算法，复用遍历上下文中的索引堆，代价 O((V' + E') log V')，
+ *          V'、E' 为可达的顶点和边。只写入可达顶点的距离，其余位置保持原值不动，
+ *          结束后用 context.IsVisited 判断顶点是否可达。边的权值不能为负
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  start_vertex 起始顶点的索引
+ * @param  distance 保存从起点到各顶点的最短距离，长度不小于顶点数量
+ * @param  context 遍历上下文，容量不足时自动扩容
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::Dijkstra(int start_vertex, E *distance, TraversalContext &context) const {
+  context.Reserve(m_vertex_count);
+  context.Reset();
+  context.ClearHeap();
+  if (start_vertex < 0 || start_vertex >= m_vertex_count || m_vertexs[start_vertex].m_removed) {
+    return; // 非法的起始顶点
+  }
+
+  distance[start_vertex] = 0;
+  context.Visit(start_vertex);
+  context.PushHeap(start_vertex, distance);
+
+  while (!context.IsHeapEmpty()) {
+    int u = context.PopHeap(distance); // 出堆即确定最短距离
+
+    for (AdjListNode *current = m_vertexs[u].m_adj_list; current != nullptr; current = current->m_next) {
+      int v = current->m_dest;
+      E new_dist = distance[u] + current->m_weight;
+      if (context.Visit(v)) {
+        distance[v] = new_dist; // 第一次到达
+        context.PushHeap(v, distance);
+      } else if (context.IsInHeap(v) && new_dist < distance[v]) {
+        distance[v] = new_dist; // 松弛
+        context.DecreaseKey(v, distance);
+      }
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : Floyd 算法
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  distance
+ * @param  path
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::Floyd(E **distance, int **path) const {
+  HelpFloyd(distance, path); // 初始化矩阵
+
+  // 开始 Floyd 核心算法
+  // k 是中间顶点的索引，通过顶点 k 来更新 i 到 j 的最短路径
+  for (int k = 0; k < m_vertex_count; ++k) {
+    for (int i = 0; i < m_vertex_count; ++i) {
+      for (int j = 0; j < m_vertex_count; ++j) {
+        // 判断经过顶点 k 是否能找到更短的路径
+        if (distance[i][k] != std::numeric_limits<E>::max() &&
+            distance[k][j] != std::numeric_limits<E>::max() &&
+            distance[i][k] + distance[k][j] < distance[i][j]) {
+          distance[i][j] = distance[i][k] + distance[k][j]; // 更新最短路径长度
+          path[i][j] = path[k][j];                          // 更新路径：i 到 j 的前驱改为通过 k 的路径
+        }
+      }
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 拓扑排序
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  sorted_vertices
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::TopologicalSort(T *sorted_vertices) const {
+  if (!m_is_directed) {
+    return false;
+  }
+
+  // 入度直接取维护好的计数，之后只沿邻接表更新，总代价 O(V + E)
+  int *in_degrees = new int[m_vertex_count > 0 ? m_vertex_count : 1];
+  for (int i = 0; i < m_vertex_count; ++i) {
+    in_degrees[i] = m_vertexs[i].m_in_degree;
+  }
+
+  bu_tools::SeqQueue<int> zero_in_degree_queue(m_vertex_count + 1); // 存放入度为0的顶点索引
+
+  // 将所有入度为0的顶点加入队列，跳过墓碑顶点
+  for (int i = 0; i < m_vertex_count; ++i) {
+    if (in_degrees[i] == 0 && !m_vertexs[i].m_removed) {
       zero_in_degree_queue.EnQueue(i);
     }
   }
@@ -890,14 +1858,10 @@ inline bool AdjLsitgraph<T, E>::TopologicalSort(T *sorted_vertices) const {
     // 将当前顶点加入到拓扑排序结果中
     sorted_vertices[sorted_index++] = m_vertexs[vertex].m_data;
 
-    // 更新相邻顶点的入度
-    for (int i = 0; i < m_vertex_count; ++i) {
-      if (IsEdgeExist(vertex, i)) { // 如果存在从vertex到i的边
-        in_degrees[i]--;            // 减少相邻顶点的入度
-
-        if (in_degrees[i] == 0) {
-          zero_in_degree_queue.EnQueue(i); // 入度为0的顶点加入队列
-        }
+    // 更新相邻顶点的入度，重复的弧各减一次
+    for (AdjListNode *current = m_vertexs[vertex].m_adj_list; current != nullptr; current = current->m_next) {
+      if (--in_degrees[current->m_dest] == 0) {
+        zero_in_degree_queue.EnQueue(current->m_dest); // 入度为0的顶点加入队列
       }
     }
   }
@@ -905,24 +1869,71 @@ inline bool AdjLsitgraph<T, E>::TopologicalSort(T *sorted_vertices) const {
   delete[] in_degrees; // 释放内存
 
   // 如果排序后的顶点数量小于图的顶点数量，说明存在环，无法进行拓扑排序
-  if (sorted_index < m_vertex_count) {
+  if (sorted_index < m_vertex_count - m_removed_count) {
     return false; // 有环，拓扑排序失败
   }
 
   return true; // 拓扑排序成功
 }
 
+/**
+ * *****************************************************************
+ * @brief : 拓扑排序，入度副本和队列都放在遍历上下文中，不分配内存
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  sorted_vertices
+ * @param  context 遍历上下文，容量不足时自动扩容
+ * @return true
+ * @return false 无向图或有环
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::TopologicalSort(T *sorted_vertices, TraversalContext &context) const {
+  if (!m_is_directed) {
+    return false;
+  }
+
+  context.Reserve(m_vertex_count);
+  int *in_degrees = context.GetSlots();
+  int *zero_in_degree_queue = context.GetBuffer(); // 每个顶点只入队一次
+  int head = 0;
+  int tail = 0;
+
+  for (int i = 0; i < m_vertex_count; ++i) {
+    in_degrees[i] = m_vertexs[i].m_in_degree;
+    if (in_degrees[i] == 0 && !m_vertexs[i].m_removed) {
+      zero_in_degree_queue[tail++] = i;
+    }
+  }
+
+  while (head < tail) {
+    int vertex = zero_in_degree_queue[head++];
+    sorted_vertices[head - 1] = m_vertexs[vertex].m_data;
+
+    for (AdjListNode *current = m_vertexs[vertex].m_adj_list; current != nullptr; current = current->m_next) {
+      if (--in_degrees[current->m_dest] == 0) {
+        zero_in_degree_queue[tail++] = current->m_dest;
+      }
+    }
+  }
+
+  // 排序后的顶点数量小于未删除的顶点数量，说明存在环
+  return tail == m_vertex_count - m_removed_count;
+}
+
 /**
  * *****************************************************************
  * @brief : Prim 算法
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  start_vertex
  * @param  matrix 存储最小生成树的边集合
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjLsitgraph<T, E>::Prim(int start_vertex, TripletSparseMatrix<E> &matrix) const {
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::Prim(int start_vertex, TripletSparseMatrix<E> &matrix) const {
   if (start_vertex < 0 || start_vertex >= m_vertex_count) {
     return;
   }
@@ -988,11 +1999,12 @@ inline void AdjLsitgraph<T, E>::Prim(int start_vertex, TripletSparseMatrix<E> &m
  * @brief : Kruskal 算法
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  matrix 存储最小生成树的边集合
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjLsitgraph<T, E>::Kruskal(TripletSparseMatrix<E> &matrix) const {
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::Kruskal(TripletSparseMatrix<E> &matrix) const {
   //将所有的边放入优先队列中
   PriorityQueue<Edge> edges;
   AdjListNode* current=nullptr;
@@ -1032,26 +2044,19 @@ inline void AdjLsitgraph<T, E>::Kruskal(TripletSparseMatrix<E> &matrix) const {
  * @brief : 顶点入度
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex
  * @return int
  * *****************************************************************
  */
-template <typename T, typename E>
-inline int AdjLsitgraph<T, E>::GetInDegree(int vertex) const {
+template <typename T, typename E, typename H>
+inline int AdjLsitgraph<T, E, H>::GetInDegree(int vertex) const {
   if (vertex < 0 || vertex >= m_vertex_count || !m_is_directed) {
     return -1;
   }
 
-  int in_degree = 0; // 用于记录顶点的入度
-
-  // 遍历邻接矩阵的每一行，检查是否有边指向该顶点
-  for (int i = 0; i < m_vertex_count; ++i) {
-    if (IsEdgeExist(i, vertex)) { // 如果从顶点i到目标顶点vertex存在边
-      in_degree++;
-    }
-  }
-
-  return in_degree; // 返回入度
+  // 插入和删除弧时维护的计数，重复的弧各算一次
+  return m_vertexs[vertex].m_in_degree;
 }
 
 /**
@@ -1059,23 +2064,22 @@ inline int AdjLsitgraph<T, E>::GetInDegree(int vertex) const {
  * @brief : 顶点出度
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex
  * @return int
  * *****************************************************************
  */
-template <typename T, typename E>
-inline int AdjLsitgraph<T, E>::GetOutDegree(int vertex) const {
+template <typename T, typename E, typename H>
+inline int AdjLsitgraph<T, E, H>::GetOutDegree(int vertex) const {
   if (vertex < 0 || vertex >= m_vertex_count || !m_is_directed) {
     return -1;
   }
 
   int out_degree = 0; // 用于记录顶点的出度
 
-  // 遍历邻接矩阵的第 vertex 行，检查从该顶点出发的边
-  for (int i = 0; i < m_vertex_count; ++i) {
-    if (IsEdgeExist(vertex, i)) { // 如果从顶点vertex到顶点i存在边
-      out_degree++;
-    }
+  // 只需遍历该顶点自己的邻接表
+  for (AdjListNode *current = m_vertexs[vertex].m_adj_list; current != nullptr; current = current->m_next) {
+    out_degree++;
   }
 
   return out_degree; // 返回出度
@@ -1083,38 +2087,1124 @@ inline int AdjLsitgraph<T, E>::GetOutDegree(int vertex) const {
 
 /**
  * *****************************************************************
- * @brief : 置空
+ * @brief : 导出为 CSR 快照，每个顶点的邻接段保持邻接表中的顺序
  * @tparam T
  * @tparam E
+ * @tparam H
+ * @param  csr
  * *****************************************************************
  */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::ToCSRGraph(CSRGraph<E> &csr) const {
+  csr.Resize(m_vertex_count, m_edge_count);
 
-template <typename T, typename E>
-inline void AdjLsitgraph<T, E>::Clear() {
-  //避免重复置空
-  if (!m_vertexs) {
-    // 遍历每个顶点
-    for (int i = 0; i < m_vertex_count; ++i) {
-      // 获取当前顶点的邻接表头指针
-      AdjListNode *adj_node = m_vertexs[i].m_adj_list;
-      // 逐个删除邻接表中的边结点
-      while (adj_node != nullptr) {
-        AdjListNode *temp = adj_node;
-        adj_node = adj_node->m_next;
-        delete temp;
-      }
-      // 将顶点的邻接表头指针置空
-      m_vertexs[i].m_adj_list = nullptr;
+  int *offsets = csr.GetOffsets();
+  int *targets = csr.GetTargets();
+  E *weights = csr.GetWeights();
+
+  int pos = 0;
+  for (int i = 0; i < m_vertex_count; ++i) {
+    offsets[i] = pos;
+    for (AdjListNode *current = m_vertexs[i].m_adj_list; current != nullptr; current = current->m_next) {
+      targets[pos] = current->m_dest;
+      weights[pos] = current->m_weight;
+      ++pos;
+    }
+  }
+  offsets[m_vertex_count] = pos;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 导出为压缩邻接表，先调用 Reorder 可以让邻接顶点的差值更小、压缩得更紧
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  graph
+ * @param  with_weights 是否保存权值
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::ToCompressedGraph(CompressedGraph<E> &graph, bool with_weights) const {
+  CSRGraph<E> csr;
+  ToCSRGraph(csr);
+  graph.Build(csr, with_weights);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 按给定的映射重新编号顶点，顶点数组和邻接表一起重建：
+ *          新的邻接表结点按新编号顺序连续存放在一个结点块中，每个邻接表按目标顶点升序
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  permutation permutation[旧索引] = 新索引，必须是 0 到顶点数量减一的一个排列
+ * @return true
+ * @return false 映射不是排列
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::Relabel(const int *permutation) {
+  const int n = m_vertex_count;
+
+  // 检查是否为排列
+  bool *seen = new bool[n > 0 ? n : 1];
+  for (int i = 0; i < n; ++i) {
+    seen[i] = false;
+  }
+  for (int i = 0; i < n; ++i) {
+    if (permutation[i] < 0 || permutation[i] >= n || seen[permutation[i]]) {
+      delete[] seen;
+      return false;
+    }
+    seen[permutation[i]] = true;
+  }
+  delete[] seen;
+
+  // 按新编号导出弧，再整理成邻接段有序的 CSR
+  CSRGraph<E> old_csr;
+  ToCSRGraph(old_csr);
+  int arc_count = old_csr.GetEdgeCount();
+  int *srcs = new int[arc_count > 0 ? arc_count : 1];
+  int *dests = new int[arc_count > 0 ? arc_count : 1];
+  for (int u = 0; u < n; ++u) {
+    const int *neighbors = old_csr.GetNeighbors(u);
+    for (int k = 0; k < old_csr.GetDegree(u); ++k) {
+      srcs[old_csr.GetOffsets()[u] + k] = permutation[u];
+      dests[old_csr.GetOffsets()[u] + k] = permutation[neighbors[k]];
     }
+  }
+  CSRGraph<E> new_csr;
+  new_csr.Build(n, srcs, dests, old_csr.GetWeights(), arc_count);
+  new_csr.SortNeighbors();
+  delete[] srcs;
+  delete[] dests;
 
-    // 删除顶点数组
-    delete[] m_vertexs;
-    m_vertexs = nullptr;
+  // 顶点数组
+  Vertex *new_base = new Vertex[m_vertex_capacity];
+  for (int i = 0; i < n; ++i) {
+    new_base[permutation[i]].m_data = m_vertexs[i].m_data;
+    new_base[permutation[i]].m_removed = m_vertexs[i].m_removed;
+  }
+  delete[] m_vertexs;
+  m_vertexs = new_base;
 
-    // 重置顶点和边的计数
-    m_vertex_count = 0;
-    m_edge_count = 0;
+  // 释放旧的结点块，所有结点放入一个新块
+  for (int i = 0; i < m_block_count; ++i) {
+    delete[] m_node_blocks[i];
   }
+  m_block_count = 0;
+  m_free_nodes = nullptr;
+  m_free_count = 0;
+  if (arc_count > 0) {
+    AllocateNodeBlock(arc_count);
+  }
+
+  for (int v = 0; v < n; ++v) {
+    const int *neighbors = new_csr.GetNeighbors(v);
+    const E *weights = new_csr.GetWeights(v);
+    AdjListNode *tail = nullptr;
+    for (int k = 0; k < new_csr.GetDegree(v); ++k) {
+      AdjListNode *node = NewNode(neighbors[k], weights[k]);
+      if (m_is_directed) {
+        m_vertexs[neighbors[k]].m_in_degree++;
+      }
+      if (tail == nullptr) {
+        m_vertexs[v].m_adj_list = node;
+      } else {
+        tail->m_next = node;
+      }
+      tail = node;
+    }
+  }
+
+  if (HelpTracksInEdges()) {
+    HelpBuildInLists();
+  }
+
+  // 重建顶点索引
+  m_vertex_index.Clear();
+  for (int i = 0; i < n; ++i) {
+    if (!m_vertexs[i].m_removed) {
+      m_vertex_index.Insert(m_vertexs[i].m_data, i);
+    }
+  }
+
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 计算重排并重新编号，常在广度优先、Dijkstra 等大量访问邻居的计算之前调用
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  order 重排方式
+ * @param  permutation 输出 permutation[旧索引] = 新索引
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::Reorder(VertexOrder order, int *permutation) {
+  CSRGraph<E> csr;
+  ToCSRGraph(csr);
+  csr.ComputeOrder(order, permutation);
+
+  return Relabel(permutation);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 辅助 PageRank，拉取式迭代：每个顶点从入边邻接段汇总贡献，两个数组交替作为新旧值
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  teleport 随机跳转的概率分布，和为 1
+ * @param  scores 输出每个顶点的得分
+ * @param  damping 阻尼系数
+ * @param  tolerance 相邻两次迭代得分差的 L1 范数小于它时收敛
+ * @param  max_iteration 最大迭代次数
+ * @return int 实际迭代次数
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline int AdjLsitgraph<T, E, H>::HelpPageRank(const double *teleport, double *scores, double damping, double tolerance, int max_iteration) const {
+  const int n = m_vertex_count;
+
+  // 入边的 CSR，拉取时只读自己的邻接段，多线程无写冲突
+  CSRGraph<E> out_graph;
+  ToCSRGraph(out_graph);
+  CSRGraph<E> in_graph;
+  out_graph.Transpose(in_graph);
+
+  const int *in_offsets = in_graph.GetOffsets();
+  const int *in_targets = in_graph.GetTargets();
+  const int *out_offsets = out_graph.GetOffsets();
+
+  double *rank = scores;                 // 当前得分
+  double *next_rank = new double[n];     // 下一轮得分
+  double *contribution = new double[n];  // rank[u] / 出度，每轮预先算好
+
+  for (int v = 0; v < n; ++v) {
+    rank[v] = teleport[v];
+  }
+
+  int iteration = 0;
+  while (iteration < max_iteration) {
+    ++iteration;
+
+    // 出度为 0 的顶点（悬挂顶点）的得分按跳转分布重新分配
+    double dangling_sum = 0.0;
+#pragma omp parallel for reduction(+ : dangling_sum)
+    for (int u = 0; u < n; ++u) {
+      int out_degree = out_offsets[u + 1] - out_offsets[u];
+      if (out_degree == 0) {
+        dangling_sum += rank[u];
+        contribution[u] = 0.0;
+      } else {
+        contribution[u] = rank[u] / out_degree;
+      }
+    }
+
+    double diff = 0.0;
+#pragma omp parallel for reduction(+ : diff) schedule(dynamic, 1024)
+    for (int v = 0; v < n; ++v) {
+      double sum = 0.0;
+      for (int k = in_offsets[v]; k < in_offsets[v + 1]; ++k) {
+        sum += contribution[in_targets[k]];
+      }
+      double value = (1.0 - damping) * teleport[v] + damping * (sum + dangling_sum * teleport[v]);
+      next_rank[v] = value;
+      diff += std::fabs(value - rank[v]);
+    }
+
+    // 交换新旧数组
+    double *temp = rank;
+    rank = next_rank;
+    next_rank = temp;
+
+    if (diff < tolerance) {
+      break;
+    }
+  }
+
+  // 结果保证写回 scores
+  if (rank != scores) {
+    for (int v = 0; v < n; ++v) {
+      scores[v] = rank[v];
+    }
+    next_rank = rank;
+  }
+
+  delete[] next_rank;
+  delete[] contribution;
+
+  return iteration;
+}
+
+/**
+ * *****************************************************************
+ * @brief : PageRank，不考虑权值，随机跳转到任意顶点的概率相同
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  scores 输出每个顶点的得分，长度为顶点数量，得分之和为 1
+ * @param  damping
+ * @param  tolerance
+ * @param  max_iteration
+ * @return int 实际迭代次数，图为空时返回 -1
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline int AdjLsitgraph<T, E, H>::PageRank(double *scores, double damping, double tolerance, int max_iteration) const {
+  if (m_vertex_count == 0) {
+    return -1;
+  }
+
+  double *teleport = new double[m_vertex_count];
+  for (int i = 0; i < m_vertex_count; ++i) {
+    teleport[i] = 1.0 / m_vertex_count;
+  }
+
+  int iteration = HelpPageRank(teleport, scores, damping, tolerance, max_iteration);
+
+  delete[] teleport;
+  return iteration;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 个性化 PageRank，随机跳转只回到给定的源顶点
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  sources 源顶点索引数组
+ * @param  source_count
+ * @param  scores 输出每个顶点的得分
+ * @param  damping
+ * @param  tolerance
+ * @param  max_iteration
+ * @return int 实际迭代次数，没有合法的源顶点时返回 -1
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline int AdjLsitgraph<T, E, H>::PersonalizedPageRank(const int *sources, int source_count, double *scores, double damping,
+                                                      double tolerance, int max_iteration) const {
+  if (m_vertex_count == 0) {
+    return -1;
+  }
+
+  double *teleport = new double[m_vertex_count];
+  for (int i = 0; i < m_vertex_count; ++i) {
+    teleport[i] = 0.0;
+  }
+
+  int valid_count = 0;
+  for (int i = 0; i < source_count; ++i) {
+    if (sources[i] >= 0 && sources[i] < m_vertex_count) {
+      teleport[sources[i]] += 1.0;
+      ++valid_count;
+    }
+  }
+
+  if (valid_count == 0) {
+    delete[] teleport;
+    return -1;
+  }
+
+  for (int i = 0; i < m_vertex_count; ++i) {
+    teleport[i] /= valid_count;
+  }
+
+  int iteration = HelpPageRank(teleport, scores, damping, tolerance, max_iteration);
+
+  delete[] teleport;
+  return iteration;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 辅助三角形计数，按度数给边定向：只保留从度数小的顶点指向度数大的顶点的弧，
+ *          度数相同时按索引比较。定向后每个顶点的出度不超过 O(sqrt(E))，邻接段按索引升序
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  oriented 定向后的 CSR
+ * @param  degrees 输出每个顶点去掉自环和重边后的度数
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::HelpOrientByDegree(CSRGraph<E> &oriented, int *degrees) const {
+  const int n = m_vertex_count;
+
+  CSRGraph<E> csr;
+  ToCSRGraph(csr);
+  csr.SortNeighbors();
+
+  const int *offsets = csr.GetOffsets();
+  const int *targets = csr.GetTargets();
+
+  // 去掉自环和重边后的度数
+  for (int u = 0; u < n; ++u) {
+    int degree = 0;
+    for (int k = offsets[u]; k < offsets[u + 1]; ++k) {
+      if (targets[k] != u && (k == offsets[u] || targets[k] != targets[k - 1])) {
+        ++degree;
+      }
+    }
+    degrees[u] = degree;
+  }
+
+  // 第一遍统计定向后的出度，第二遍填充
+  int *oriented_offsets = new int[n + 1];
+  oriented_offsets[0] = 0;
+  for (int pass = 0; pass < 2; ++pass) {
+    int *oriented_targets = pass == 0 ? nullptr : oriented.GetTargets();
+    for (int u = 0; u < n; ++u) {
+      int pos = oriented_offsets[u];
+      for (int k = offsets[u]; k < offsets[u + 1]; ++k) {
+        int v = targets[k];
+        if (v == u || (k != offsets[u] && v == targets[k - 1])) {
+          continue;
+        }
+        if (degrees[u] < degrees[v] || (degrees[u] == degrees[v] && u < v)) {
+          if (oriented_targets) {
+            oriented_targets[pos] = v;
+          }
+          ++pos;
+        }
+      }
+      if (pass == 0) {
+        oriented_offsets[u + 1] = pos;
+      }
+    }
+    if (pass == 0) {
+      oriented.Resize(n, oriented_offsets[n]);
+      for (int i = 0; i <= n; ++i) {
+        oriented.GetOffsets()[i] = oriented_offsets[i];
+      }
+    }
+  }
+
+  delete[] oriented_offsets;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 辅助三角形计数，求两个严格升序数组的交集大小。有 SSE2 时（x86-64 默认具备，不需要额外的编译选项）
+ *          先按 4 个一组比较：a 的一组与 b 的一组及其 3 个循环移位逐个比较，得到 a 中命中的位置，
+ *          再丢弃最大值较小的一组；两边都不足 4 个时改用归并，计数时的比较不带分支
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  a
+ * @param  a_len
+ * @param  b
+ * @param  b_len
+ * @param  vertex_triangles 不为空时，交集中的每个顶点的三角形数加一
+ * @return long long 交集大小
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline long long AdjLsitgraph<T, E, H>::HelpIntersect(const int *a, int a_len, const int *b, int b_len, long long *vertex_triangles) {
+  long long count = 0;
+  int i = 0, j = 0;
+
+#ifdef __SSE2__
+  static const int BIT_COUNT[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4}; // 4 位掩码中 1 的个数
+  while (i + 4 <= a_len && j + 4 <= b_len) {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+    __m128i hit = _mm_cmpeq_epi32(va, vb);
+    hit = _mm_or_si128(hit, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+    hit = _mm_or_si128(hit, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+    hit = _mm_or_si128(hit, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+    int mask = _mm_movemask_ps(_mm_castsi128_ps(hit)); // 第 k 位表示 a[i + k] 在交集中
+
+    count += BIT_COUNT[mask];
+    if (vertex_triangles != nullptr) {
+      for (int k = 0; k < 4; ++k) {
+        if (mask & (1 << k)) {
+#pragma omp atomic
+          ++vertex_triangles[a[i + k]];
+        }
+      }
+    }
+
+    // 两组的元素各不相同，最大值较小的一组不可能再与后面的元素相交
+    int a_max = a[i + 3];
+    int b_max = b[j + 3];
+    i += (a_max <= b_max) << 2;
+    j += (b_max <= a_max) << 2;
+  }
+#endif
+
+  if (vertex_triangles == nullptr) {
+    while (i < a_len && j < b_len) {
+      int x = a[i];
+      int y = b[j];
+      count += (x == y);
+      i += (x <= y);
+      j += (y <= x);
+    }
+    return count;
+  }
+
+  while (i < a_len && j < b_len) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (a[i] > b[j]) {
+      ++j;
+    } else {
+#pragma omp atomic
+      ++vertex_triangles[a[i]];
+      ++count;
+      ++i;
+      ++j;
+    }
+  }
+  return count;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 辅助三角形计数：每条定向弧 u->v 与 u、v 的出边邻接段求交集，每个三角形恰好被数一次
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  degrees 输出每个顶点去掉自环和重边后的度数
+ * @param  vertex_triangles 不为空时输出每个顶点所在的三角形个数
+ * @return long long 三角形总数
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline long long AdjLsitgraph<T, E, H>::HelpCountTriangles(int *degrees, long long *vertex_triangles) const {
+  const int n = m_vertex_count;
+  CSRGraph<E> oriented;
+  HelpOrientByDegree(oriented, degrees);
+
+  if (vertex_triangles) {
+    for (int i = 0; i < n; ++i) {
+      vertex_triangles[i] = 0;
+    }
+  }
+
+  const int *offsets = oriented.GetOffsets();
+  const int *targets = oriented.GetTargets();
+
+  long long total = 0;
+#pragma omp parallel for schedule(dynamic, 64) reduction(+ : total)
+  for (int u = 0; u < n; ++u) {
+    for (int k = offsets[u]; k < offsets[u + 1]; ++k) {
+      int v = targets[k];
+      long long found = HelpIntersect(targets + offsets[u], offsets[u + 1] - offsets[u],
+                                      targets + offsets[v], offsets[v + 1] - offsets[v], vertex_triangles);
+      if (vertex_triangles && found > 0) {
+#pragma omp atomic
+        vertex_triangles[u] += found;
+#pragma omp atomic
+        vertex_triangles[v] += found;
+      }
+      total += found;
+    }
+  }
+
+  return total;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 三角形计数
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  vertex_triangles 不为空时输出每个顶点所在的三角形个数，长度为顶点数量
+ * @return long long 三角形总数，有向图返回 -1
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline long long AdjLsitgraph<T, E, H>::CountTriangles(long long *vertex_triangles) const {
+  if (m_is_directed) {
+    return -1;
+  }
+
+  int *degrees = new int[m_vertex_count > 0 ? m_vertex_count : 1];
+  long long total = HelpCountTriangles(degrees, vertex_triangles);
+  delete[] degrees;
+
+  return total;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 局部聚类系数：顶点的邻居之间实际存在的边数与可能存在的边数之比
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  coefficients 输出每个顶点的聚类系数，度数小于 2 的顶点为 0
+ * @return true
+ * @return false 有向图
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::ClusteringCoefficient(double *coefficients) const {
+  if (m_is_directed) {
+    return false;
+  }
+
+  const int n = m_vertex_count;
+  int *degrees = new int[n > 0 ? n : 1];
+  long long *vertex_triangles = new long long[n > 0 ? n : 1];
+  HelpCountTriangles(degrees, vertex_triangles);
+
+  for (int i = 0; i < n; ++i) {
+    long long degree = degrees[i];
+    coefficients[i] = degree < 2 ? 0.0 : 2.0 * vertex_triangles[i] / (degree * (degree - 1));
+  }
+
+  delete[] degrees;
+  delete[] vertex_triangles;
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 二分图最大匹配，先二染色求两部分，再在 CSR 快照上运行 Hopcroft-Karp
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  mate 输出每个顶点匹配到的顶点索引，未匹配为 -1
+ * @return int 匹配的边数，有向图或不是二分图时返回 -1
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline int AdjLsitgraph<T, E, H>::MaximumMatching(int *mate) const {
+  if (m_is_directed) {
+    return -1;
+  }
+
+  CSRGraph<E> csr;
+  ToCSRGraph(csr);
+
+  bool *is_left = new bool[m_vertex_count > 0 ? m_vertex_count : 1];
+  int matching = -1;
+  if (csr.Bipartition(is_left)) {
+    matching = csr.HopcroftKarp(is_left, mate);
+  }
+
+  delete[] is_left;
+  return matching;
+}
+
+/**
+ * *****************************************************************
+ * @brief : k 跳邻域，深度受限的广度优先搜索。访问标记放在哈希表中，队列就是输出的顶点表本身，
+ *          代价与邻域内的顶点数和它们的出边数成正比。有向图沿出边扩展
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  start_vertex
+ * @param  max_depth 最大跳数
+ * @param  vertices 输出邻域内的顶点索引，按广度优先的顺序，第一个是起始顶点
+ * @param  distances 输出与 vertices 一一对应的跳数，非降序
+ * @return int 邻域内的顶点个数，起始顶点非法时返回 -1
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline int AdjLsitgraph<T, E, H>::KHopNeighborhood(int start_vertex, int max_depth, SeqList<int> &vertices, SeqList<int> &distances) const {
+  vertices.Clear();
+  distances.Clear();
+  if (start_vertex < 0 || start_vertex >= m_vertex_count || m_vertexs[start_vertex].m_removed || max_depth < 0) {
+    return -1;
+  }
+
+  OpenHashMap<int, int> visited; // 已访问的顶点到跳数
+  visited.Insert(start_vertex, 0);
+  vertices.Append(start_vertex);
+  distances.Append(0);
+
+  // head 之前的顶点已经扩展过，SeqList 的下标从 1 开始
+  for (int head = 1; head <= vertices.GetLength(); ++head) {
+    int vertex = vertices[head];
+    int depth = distances[head];
+    if (depth == max_depth) {
+      break; // 之后的顶点跳数都不小于 max_depth
+    }
+
+    for (AdjListNode *current = m_vertexs[vertex].m_adj_list; current != nullptr; current = current->m_next) {
+      if (visited.Insert(current->m_dest, depth + 1)) {
+        vertices.Append(current->m_dest);
+        distances.Append(depth + 1);
+      }
+    }
+  }
+
+  return vertices.GetLength();
+}
+
+/**
+ * *****************************************************************
+ * @brief : 导出诱导子图：给定顶点之间的所有边或弧，顶点按给定的顺序编号。
+ *          只访问给定顶点的邻接表，旧索引到新索引的映射放在哈希表中
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  vertices 顶点索引，不能重复
+ * @param  count 顶点个数
+ * @param  subgraph 输出，原有内容被清空，有向或无向必须与本图相同
+ * @return true
+ * @return false 顶点非法或重复，或者子图的类型不同
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::ExtractSubgraph(const int *vertices, int count, AdjLsitgraph &subgraph) const {
+  if (subgraph.m_is_directed != m_is_directed || &subgraph == this) {
+    return false;
+  }
+
+  OpenHashMap<int, int> new_index(2 * count);
+  for (int i = 0; i < count; ++i) {
+    int v = vertices[i];
+    if (v < 0 || v >= m_vertex_count || m_vertexs[v].m_removed || !new_index.Insert(v, i)) {
+      return false;
+    }
+  }
+
+  subgraph.Clear();
+  subgraph.ReserveVertices(count);
+  for (int i = 0; i < count; ++i) {
+    subgraph.InsertVertex(m_vertexs[vertices[i]].m_data);
+  }
+
+  // 先收集子图中的弧，无向图每条边只取一个方向，由 InsertEdges 补上反向边
+  int arc_count = 0;
+  for (int pass = 0; pass < 2; ++pass) {
+    int *srcs = nullptr;
+    int *dests = nullptr;
+    E *weights = nullptr;
+    if (pass == 1) {
+      srcs = new int[arc_count > 0 ? arc_count : 1];
+      dests = new int[arc_count > 0 ? arc_count : 1];
+      weights = new E[arc_count > 0 ? arc_count : 1];
+    }
+
+    int pos = 0;
+    for (int i = 0; i < count; ++i) {
+      bool skip_loop = false; // 无向图的自环在邻接表中出现两次
+      for (AdjListNode *current = m_vertexs[vertices[i]].m_adj_list; current != nullptr; current = current->m_next) {
+        int j;
+        if (!new_index.Find(current->m_dest, j)) {
+          continue;
+        }
+        if (!m_is_directed) {
+          if (j < i) {
+            continue;
+          }
+          if (j == i) {
+            skip_loop = !skip_loop;
+            if (!skip_loop) {
+              continue;
+            }
+          }
+        }
+        if (pass == 1) {
+          srcs[pos] = i;
+          dests[pos] = j;
+          weights[pos] = current->m_weight;
+        }
+        ++pos;
+      }
+    }
+    arc_count = pos;
+
+    if (pass == 1) {
+      // 原图中的重边原样保留，不去重
+      subgraph.InsertEdges(srcs, dests, weights, arc_count, true);
+      delete[] srcs;
+      delete[] dests;
+      delete[] weights;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 导出诱导子图的 CSR 快照，与 ToCSRGraph 一样无向图的每条边占两条弧
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  vertices 顶点索引，不能重复，子图中顶点 i 对应 vertices[i]
+ * @param  count 顶点个数
+ * @param  subgraph 输出
+ * @return true
+ * @return false 顶点非法或重复
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::ExtractSubgraph(const int *vertices, int count, CSRGraph<E> &subgraph) const {
+  OpenHashMap<int, int> new_index(2 * count);
+  for (int i = 0; i < count; ++i) {
+    int v = vertices[i];
+    if (v < 0 || v >= m_vertex_count || m_vertexs[v].m_removed || !new_index.Insert(v, i)) {
+      return false;
+    }
+  }
+
+  // 第一遍统计每个顶点留下的弧数，第二遍填充
+  int arc_count = 0;
+  for (int i = 0; i < count; ++i) {
+    for (AdjListNode *current = m_vertexs[vertices[i]].m_adj_list; current != nullptr; current = current->m_next) {
+      if (new_index.Contains(current->m_dest)) {
+        ++arc_count;
+      }
+    }
+  }
+
+  subgraph.Resize(count, arc_count);
+  int *offsets = subgraph.GetOffsets();
+  int *targets = subgraph.GetTargets();
+  E *weights = subgraph.GetWeights();
+  int pos = 0;
+  for (int i = 0; i < count; ++i) {
+    offsets[i] = pos;
+    for (AdjListNode *current = m_vertexs[vertices[i]].m_adj_list; current != nullptr; current = current->m_next) {
+      int j;
+      if (new_index.Find(current->m_dest, j)) {
+        targets[pos] = j;
+        weights[pos] = current->m_weight;
+        ++pos;
+      }
+    }
+  }
+  offsets[count] = pos;
+
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 以 center 为中心、max_depth 跳以内的顶点的诱导子图（自我网络），中心是子图中的 0 号顶点
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  center
+ * @param  max_depth
+ * @param  subgraph 输出，有向或无向必须与本图相同
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::EgoNetwork(int center, int max_depth, AdjLsitgraph &subgraph) const {
+  SeqList<int> vertices;
+  SeqList<int> distances;
+  if (KHopNeighborhood(center, max_depth, vertices, distances) < 0) {
+    return false;
+  }
+
+  int count = vertices.GetLength();
+  int *members = new int[count];
+  for (int i = 0; i < count; ++i) {
+    members[i] = vertices[i + 1];
+  }
+  bool result = ExtractSubgraph(members, count, subgraph);
+
+  delete[] members;
+  return result;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 辅助最大流，全局重标号：从汇点在残量网络上反向广度优先搜索，高度取到汇点的距离，
+ *          到达不了汇点的顶点高度置为顶点数量
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  source
+ * @param  sink
+ * @param  offsets 残量网络的 CSR
+ * @param  targets
+ * @param  capacity 每条弧的剩余容量
+ * @param  reverse 每条弧的反向弧在数组中的位置
+ * @param  height 输出每个顶点的高度
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::HelpGlobalRelabel(int source, int sink, const int *offsets, const int *targets, const E *capacity,
+                                                    const int *reverse, int *height) const {
+  const int n = m_vertex_count;
+  for (int i = 0; i < n; ++i) {
+    height[i] = n;
+  }
+
+  SeqQueue<int> vertex_queue(n + 1);
+  height[sink] = 0;
+  vertex_queue.EnQueue(sink);
+
+  while (!vertex_queue.IsEmpty()) {
+    int v;
+    vertex_queue.DeQueue(v);
+    for (int a = offsets[v]; a < offsets[v + 1]; ++a) {
+      int u = targets[a];
+      // 弧 u->v 即 a 的反向弧，还有剩余容量时 u 能到达 v
+      if (height[u] == n && u != source && capacity[reverse[a]] > E()) {
+        height[u] = height[v] + 1;
+        vertex_queue.EnQueue(u);
+      }
+    }
+  }
+
+  height[source] = n;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 最大流，最高标号预流推进算法，带全局重标号和间隙优化。
+ *          残量网络用扁平的弧数组存储，每条弧记录反向弧的位置；只做第一阶段，
+ *          得到的预流值即最大流，残量网络上到达不了汇点的顶点构成最小割的源点一侧
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  source 源点
+ * @param  sink 汇点
+ * @param  max_flow 输出最大流的值
+ * @param  source_side 不为空时输出最小割，true 表示顶点在源点一侧
+ * @return true
+ * @return false 源点或汇点不合法
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjLsitgraph<T, E, H>::MaxFlow(int source, int sink, E &max_flow, bool *source_side) const {
+  max_flow = E();
+  if (source < 0 || source >= m_vertex_count || sink < 0 || sink >= m_vertex_count || source == sink) {
+    return false;
+  }
+
+  const int n = m_vertex_count;
+
+  // 构建残量网络：每条弧 u->v 对应正向弧（容量为权值）和反向弧（容量为 0）
+  int *offsets = new int[n + 1];
+  for (int i = 0; i <= n; ++i) {
+    offsets[i] = 0;
+  }
+  for (int u = 0; u < n; ++u) {
+    for (AdjListNode *current = m_vertexs[u].m_adj_list; current != nullptr; current = current->m_next) {
+      ++offsets[u + 1];
+      ++offsets[current->m_dest + 1];
+    }
+  }
+  for (int i = 1; i <= n; ++i) {
+    offsets[i] += offsets[i - 1];
+  }
+
+  int arc_count = offsets[n];
+  int *targets = new int[arc_count > 0 ? arc_count : 1];
+  int *reverse = new int[arc_count > 0 ? arc_count : 1];
+  E *capacity = new E[arc_count > 0 ? arc_count : 1];
+  int *position = new int[n];
+  for (int i = 0; i < n; ++i) {
+    position[i] = offsets[i];
+  }
+  for (int u = 0; u < n; ++u) {
+    for (AdjListNode *current = m_vertexs[u].m_adj_list; current != nullptr; current = current->m_next) {
+      int v = current->m_dest;
+      int forward = position[u]++;
+      int backward = position[v]++;
+      targets[forward] = v;
+      capacity[forward] = current->m_weight;
+      reverse[forward] = backward;
+      targets[backward] = u;
+      capacity[backward] = E();
+      reverse[backward] = forward;
+    }
+  }
+
+  int *height = new int[n];
+  E *excess = new E[n];
+  int *current_arc = new int[n];
+  int *height_count = new int[n + 1]; // 每个高度上的顶点数，用于间隙优化
+  int *bucket_head = new int[n + 1];  // 每个高度上的活跃顶点链表
+  int *bucket_next = new int[n];
+  int max_height = -1; // 活跃顶点的最大高度
+
+  for (int i = 0; i < n; ++i) {
+    excess[i] = E();
+  }
+
+  // 从源点出发的弧全部推满
+  for (int a = offsets[source]; a < offsets[source + 1]; ++a) {
+    E flow = capacity[a];
+    if (flow > E()) {
+      capacity[a] -= flow;
+      capacity[reverse[a]] += flow;
+      excess[targets[a]] += flow;
+      excess[source] -= flow;
+    }
+  }
+
+  // 全局重标号后重建高度计数和活跃顶点桶，每次都从这里开始
+  long long work = 0;
+  const long long relabel_threshold = 6LL * n + arc_count;
+  bool need_global_relabel = true;
+
+  while (true) {
+    if (need_global_relabel) {
+      HelpGlobalRelabel(source, sink, offsets, targets, capacity, reverse, height);
+      for (int h = 0; h <= n; ++h) {
+        height_count[h] = 0;
+        bucket_head[h] = -1;
+      }
+      max_height = -1;
+      for (int v = 0; v < n; ++v) {
+        current_arc[v] = offsets[v];
+        if (height[v] < n) {
+          ++height_count[height[v]];
+          if (v != sink && excess[v] > E()) {
+            bucket_next[v] = bucket_head[height[v]];
+            bucket_head[height[v]] = v;
+            if (height[v] > max_height) {
+              max_height = height[v];
+            }
+          }
+        }
+      }
+      work = 0;
+      need_global_relabel = false;
+    }
+
+    // 取出最高的活跃顶点
+    while (max_height >= 0 && bucket_head[max_height] == -1) {
+      --max_height;
+    }
+    if (max_height < 0) {
+      break;
+    }
+    int v = bucket_head[max_height];
+    bucket_head[max_height] = bucket_next[v];
+    if (height[v] != max_height) {
+      continue; // 间隙优化后已经被抬高的顶点
+    }
+
+    // 排出顶点 v 的全部盈余
+    while (excess[v] > E()) {
+      if (current_arc[v] == offsets[v + 1]) {
+        // 重标号：高度取可推进邻居的最小高度加一
+        int old_height = height[v];
+        int new_height = n;
+        for (int a = offsets[v]; a < offsets[v + 1]; ++a) {
+          if (capacity[a] > E() && height[targets[a]] + 1 < new_height) {
+            new_height = height[targets[a]] + 1;
+          }
+        }
+        work += offsets[v + 1] - offsets[v] + 12;
+
+        --height_count[old_height];
+        if (height_count[old_height] == 0) {
+          // 间隙优化：old_height 层空了，比它高的顶点都到达不了汇点
+          for (int u = 0; u < n; ++u) {
+            if (height[u] > old_height && height[u] < n) {
+              --height_count[height[u]];
+              height[u] = n;
+            }
+          }
+          new_height = n;
+        }
+
+        height[v] = new_height;
+        current_arc[v] = offsets[v];
+        if (new_height >= n) {
+          break;
+        }
+        ++height_count[new_height];
+        continue;
+      }
+
+      int a = current_arc[v];
+      int w = targets[a];
+      if (capacity[a] > E() && height[v] == height[w] + 1) {
+        E flow = excess[v] < capacity[a] ? excess[v] : capacity[a];
+        if (w != sink && w != source && !(excess[w] > E())) {
+          // w 变为活跃顶点
+          bucket_next[w] = bucket_head[height[w]];
+          bucket_head[height[w]] = w;
+          if (height[w] > max_height) {
+            max_height = height[w];
+          }
+        }
+        capacity[a] -= flow;
+        capacity[reverse[a]] += flow;
+        excess[v] -= flow;
+        excess[w] += flow;
+      } else {
+        ++current_arc[v];
+      }
+    }
+
+    if (work > relabel_threshold) {
+      need_global_relabel = true;
+    }
+  }
+
+  max_flow = excess[sink];
+
+  // 残量网络上到达不了汇点的顶点在源点一侧
+  if (source_side) {
+    HelpGlobalRelabel(source, sink, offsets, targets, capacity, reverse, height);
+    for (int v = 0; v < n; ++v) {
+      source_side[v] = height[v] >= n;
+    }
+  }
+
+  delete[] offsets;
+  delete[] targets;
+  delete[] reverse;
+  delete[] capacity;
+  delete[] position;
+  delete[] height;
+  delete[] excess;
+  delete[] current_arc;
+  delete[] height_count;
+  delete[] bucket_head;
+  delete[] bucket_next;
+
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 置空
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * *****************************************************************
+ */
+
+template <typename T, typename E, typename H>
+inline void AdjLsitgraph<T, E, H>::Clear() {
+  // 邻接表结点都来自结点块，整块释放即可，无需逐个删除
+  for (int i = 0; i < m_block_count; ++i) {
+    delete[] m_node_blocks[i];
+  }
+  m_block_count = 0;
+  m_free_nodes = nullptr;
+  m_free_count = 0;
+
+  // 将顶点的邻接表头指针置空
+  for (int i = 0; i < m_vertex_count; ++i) {
+    m_vertexs[i].m_adj_list = nullptr;
+    m_vertexs[i].m_in_list = nullptr;
+    m_vertexs[i].m_removed = false;
+    m_vertexs[i].m_in_degree = 0;
+  }
+
+  // 重置顶点和边的计数
+  m_vertex_count = 0;
+  m_edge_count = 0;
+  m_removed_count = 0;
+  m_vertex_index.Clear();
 }
 
 } // namespace bu_tools
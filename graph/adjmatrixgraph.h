@@ -19,7 +19,10 @@
 //#include "../tree/huffmantree.h"
 #include <limits>
 #include "unionfind.h"
+#include "openhashmap.h"
+#include "csrgraph.h"
 #include "../tree/priorityqueue.h"
+#include "traversalcontext.h"
 
 namespace bu_tools {
 
@@ -31,9 +34,10 @@ namespace bu_tools {
  * @brief :图（邻接矩阵）
  * @tparam T 顶点
  * @tparam E 权值
+ * @tparam H 顶点的哈希函数，用于按顶点查找索引
  * *****************************************************************
  */
-template <typename T, typename E>
+template <typename T, typename E, typename H = std::hash<T>>
 class AdjMatrixGraph {
   /*****************************************************************
 
@@ -87,6 +91,7 @@ protected:
   int m_edge_count;                    // 边或弧的数量
   T *m_vertexs;                        // 顶点数据数组
   TripletSparseMatrix<E> m_adj_matrix; // 邻接矩阵，存储边或弧的权值
+  OpenHashMap<T, int, H> m_vertex_index; // 顶点到索引的哈希表
 
   /*****************************************************************
 
@@ -97,10 +102,12 @@ protected:
 private:
   void HelpDepthFirstSearch(int vertex, void (*visit)(const T &vertex), bool *visited) const;
   void HelpBreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex), bool *visited) const;
+  template <typename F>
+  bool HelpDepthFirstSearch(int vertex, int depth, F &visit, TraversalContext &context) const;
   void HelpFloyd(E **distance, int **path) const;
 
 public:
-  AdjMatrixGraph(int vertex_count, bool is_directed) : m_is_directed(is_directed), m_edge_count(0), m_adj_matrix(vertex_count, vertex_count) {
+  AdjMatrixGraph(int vertex_count, bool is_directed) : m_is_directed(is_directed), m_edge_count(0), m_adj_matrix(vertex_count, vertex_count), m_vertex_index(2 * vertex_count) {
 
     // 动态分配顶点数组
     m_vertexs = new T[vertex_count];
@@ -130,12 +137,28 @@ public:
   void DepthFirstSearch(int start_vertex, void (*visit)(const T &vertex)) const;   // 深度优先遍历
   void BreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex)) const; // 广度优先遍历
 
+  // 复用遍历上下文：不分配内存，只访问起始顶点可达的部分，邻居按行二分定位，不再逐列探测
+  void DepthFirstSearch(int start_vertex, void (*visit)(const T &vertex), TraversalContext &context) const;   // 深度优先遍历
+  void BreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex), TraversalContext &context) const; // 广度优先遍历
+
+  // 任意可调用对象作为访问器，以 (顶点, 索引, 深度) 调用，返回 true 时立即停止遍历；可以内联，也可以带状态
+  template <typename F>
+  bool DepthFirstSearch(int start_vertex, F visit) const; // 深度优先遍历，返回是否被提前停止
+  template <typename F>
+  bool BreadthFirstSearch(int start_vertex, F visit) const; // 广度优先遍历，返回是否被提前停止
+  template <typename F>
+  bool DepthFirstSearch(int start_vertex, F visit, TraversalContext &context) const; // 复用遍历上下文
+  template <typename F>
+  bool BreadthFirstSearch(int start_vertex, F visit, TraversalContext &context) const; // 复用遍历上下文
+
   // 最短路径算法
   void Dijkstra(int start_vertex, E *distance) const; // Dijkstra 算法
+  void Dijkstra(int start_vertex, E *distance, TraversalContext &context) const; // 堆优化的 Dijkstra，只写入可达顶点
   void Floyd(E **distance, int **path) const;                    // Floyd 算法
 
   // // 拓扑排序
   bool TopologicalSort(T *sorted_vertices) const; // 拓扑排序
+  bool TopologicalSort(T *sorted_vertices, TraversalContext &context) const; // 拓扑排序，复用遍历上下文
 
   // // 最小生成树算法
   void Prim(int start_vertex, E *distance, int *path) const; // Prim 算法
@@ -148,6 +171,22 @@ public:
   int GetInDegree(int vertex) const;  // 获取顶点的入度
   int GetOutDegree(int vertex) const; // 获取顶点的出度
 
+  // 导出快照
+  void ToCSRGraph(CSRGraph<E> &csr) const; // 导出为 CSR 快照
+
+  // 矩阵形式的图算法，基于半环上的稀疏矩阵乘法
+  const TripletSparseMatrix<E> &GetAdjMatrix() const;         // 获取邻接矩阵
+  void BreadthFirstLevels(int start_vertex, int *level) const; // 按层广度优先，以已访问顶点为掩码做矩阵乘向量
+  bool BellmanFord(int start_vertex, E *distance) const;       // (min, +) 矩阵乘向量迭代，允许负权
+  long long CountTriangles() const;                            // 无向图的三角形个数
+
+  // 顶点重排
+  bool Relabel(const int *permutation);              // 按给定的映射重新编号顶点
+  bool Reorder(VertexOrder order, int *permutation); // 计算重排并重新编号，输出映射
+
+  // 二分图最大匹配（无向图）
+  int MaximumMatching(int *mate) const; // Hopcroft-Karp 最大匹配
+
   // 清空图
   void Clear(); // 清空图中的所有顶点和边
 };
@@ -165,13 +204,14 @@ public:
  * @brief : 辅助深度优先搜索
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex
  * @param  visit
  * @param  visited
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjMatrixGraph<T, E>::HelpDepthFirstSearch(int vertex, void (*visit)(const T &vertex), bool *visited) const {
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::HelpDepthFirstSearch(int vertex, void (*visit)(const T &vertex), bool *visited) const {
   // 标记当前顶点为已访问
   visited[vertex] = true;
 
@@ -192,13 +232,14 @@ inline void AdjMatrixGraph<T, E>::HelpDepthFirstSearch(int vertex, void (*visit)
  * @brief : 辅助广度优先搜索
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  start_vertex
  * @param  visit
  * @param  visited
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjMatrixGraph<T, E>::HelpBreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex), bool *visited) const {
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::HelpBreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex), bool *visited) const {
   // 创建队列并将起始顶点入队
   SeqQueue<int> vertex_queue(m_vertex_count);
   vertex_queue.EnQueue(start_vertex);
@@ -224,17 +265,50 @@ inline void AdjMatrixGraph<T, E>::HelpBreadthFirstSearch(int start_vertex, void
   }
 }
 
+/**
+ * *****************************************************************
+ * @brief : 辅助深度优先搜索，访问标记记在遍历上下文中，邻居取自三元组中该行的区间
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @tparam F
+ * @param  vertex
+ * @param  depth 深度优先树中的深度
+ * @param  visit
+ * @param  context
+ * @return true 访问器要求停止
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+template <typename F>
+inline bool AdjMatrixGraph<T, E, H>::HelpDepthFirstSearch(int vertex, int depth, F &visit, TraversalContext &context) const {
+  context.Visit(vertex);
+  if (visit(m_vertexs[vertex], vertex, depth)) {
+    return true;
+  }
+
+  typename TripletSparseMatrix<E>::Iterator row_end = m_adj_matrix.RowEnd(vertex);
+  for (typename TripletSparseMatrix<E>::Iterator it = m_adj_matrix.RowBegin(vertex); it != row_end; ++it) {
+    if (!context.IsVisited(it->m_col) && HelpDepthFirstSearch(it->m_col, depth + 1, visit, context)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /**
  * *****************************************************************
  * @brief : 辅助Floyd 算法，初始化两个矩阵
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  distance
  * @param  path
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjMatrixGraph<T, E>::HelpFloyd(E **distance, int **path) const {
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::HelpFloyd(E **distance, int **path) const {
   // 初始化距离矩阵和路径矩阵
   // distance[i][j] 表示顶点 i 到顶点 j 的最短路径长度
   // path[i][j] 表示从顶点 i 到顶点 j 的路径上，j 的前驱顶点
@@ -262,11 +336,12 @@ inline void AdjMatrixGraph<T, E>::HelpFloyd(E **distance, int **path) const {
  * @brief : Construct a new Adj Matrix Graph< T,  E>:: Adj Matrix Graph object
  * @tparam T 
  * @tparam E 
+ * @tparam H 
  * @param  other            
  * *****************************************************************
  */
-template <typename T, typename E>
-inline AdjMatrixGraph<T, E>::AdjMatrixGraph(const AdjMatrixGraph &other) {
+template <typename T, typename E, typename H>
+inline AdjMatrixGraph<T, E, H>::AdjMatrixGraph(const AdjMatrixGraph &other) {
   m_is_directed=other.m_is_directed;
   m_vertex_count=other.m_vertex_count;
   m_edge_count=other.m_edge_count;
@@ -277,6 +352,7 @@ inline AdjMatrixGraph<T, E>::AdjMatrixGraph(const AdjMatrixGraph &other) {
   }
 
   m_adj_matrix=other.m_adj_matrix;
+  m_vertex_index=other.m_vertex_index;
 }
 
 /**
@@ -284,10 +360,11 @@ inline AdjMatrixGraph<T, E>::AdjMatrixGraph(const AdjMatrixGraph &other) {
  * @brief : Destroy the Adj Matrix Graph< T,  E>:: Adj Matrix Graph object
  * @tparam T 
  * @tparam E 
+ * @tparam H 
  * *****************************************************************
  */
-template <typename T, typename E>
-inline AdjMatrixGraph<T, E>::~AdjMatrixGraph() {
+template <typename T, typename E, typename H>
+inline AdjMatrixGraph<T, E, H>::~AdjMatrixGraph() {
   delete [] m_vertexs;
   m_adj_matrix.Clear();
 }
@@ -297,11 +374,12 @@ inline AdjMatrixGraph<T, E>::~AdjMatrixGraph() {
  * @brief : 获取顶点数量
  * @tparam T
  * @tparam E
+ * @tparam H
  * @return int
  * *****************************************************************
  */
-template <typename T, typename E>
-inline int AdjMatrixGraph<T, E>::GetVertexCount() const {
+template <typename T, typename E, typename H>
+inline int AdjMatrixGraph<T, E, H>::GetVertexCount() const {
   return m_vertex_count;
 }
 
@@ -310,18 +388,17 @@ inline int AdjMatrixGraph<T, E>::GetVertexCount() const {
  * @brief : 插入顶点
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex
  * @return true
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjMatrixGraph<T, E>::InsertVertex(const T &vertex) {
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::InsertVertex(const T &vertex) {
   // 检查顶点是否已存在
-  for (int i = 0; i < m_vertex_count; ++i) {
-    if (m_vertexs[i] == vertex) {
-      return false; // 顶点已存在，插入失败
-    }
+  if (m_vertex_index.Contains(vertex)) {
+    return false; // 顶点已存在，插入失败
   }
 
   // 检查是否超过了当前的顶点容量
@@ -331,6 +408,7 @@ inline bool AdjMatrixGraph<T, E>::InsertVertex(const T &vertex) {
 
   // 插入顶点到顶点数组
   m_vertexs[m_vertex_count] = vertex;
+  m_vertex_index.Insert(vertex, m_vertex_count);
 
   // 更新顶点数量
   ++m_vertex_count;
@@ -343,13 +421,14 @@ inline bool AdjMatrixGraph<T, E>::InsertVertex(const T &vertex) {
  * @brief : 删除顶点，影响整体结构，会压缩整个矩阵
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex
  * @return true
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjMatrixGraph<T, E>::RemoveVertex(const T &vertex) {
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::RemoveVertex(const T &vertex) {
   int index = GetVertexIndex(vertex);
 
   // 如果顶点不存在，返回删除失败
@@ -365,8 +444,10 @@ inline bool AdjMatrixGraph<T, E>::RemoveVertex(const T &vertex) {
   }
 
   // 移动顶点数组，将后面的顶点向前移动
+  m_vertex_index.Remove(vertex);
   for (int i = index; i < m_vertex_count - 1; ++i) {
     m_vertexs[i] = m_vertexs[i + 1];
+    m_vertex_index.Insert(m_vertexs[i], i); // 同步哈希表中的索引
   }
 
   // 在邻接矩阵中，删除第 index 行和列后，将后续行和列向前移动
@@ -393,19 +474,17 @@ inline bool AdjMatrixGraph<T, E>::RemoveVertex(const T &vertex) {
  * @brief : 获取顶点的索引
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex
  * @return int 如果是-1，则不存在这个索引
  * *****************************************************************
  */
-template <typename T, typename E>
-inline int AdjMatrixGraph<T, E>::GetVertexIndex(const T &vertex) const {
+template <typename T, typename E, typename H>
+inline int AdjMatrixGraph<T, E, H>::GetVertexIndex(const T &vertex) const {
   // 查找顶点的索引
   int index = -1;
-  for (int i = 0; i < m_vertex_count; ++i) {
-    if (m_vertexs[i] == vertex) {
-      index = i;
-      break;
-    }
+  if (!m_vertex_index.Find(vertex, index)) {
+    index = -1;
   }
 
   return index;
@@ -416,14 +495,15 @@ inline int AdjMatrixGraph<T, E>::GetVertexIndex(const T &vertex) const {
  * @brief : 根据索引获取顶点
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  index 0开始
  * @param  vertex
  * @return true
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjMatrixGraph<T, E>::GetVertexByIndex(int index, T &vertex) const {
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::GetVertexByIndex(int index, T &vertex) const {
   if (index < 0 || index > m_vertex_count) {
     vertex = T();
     return false;
@@ -437,6 +517,7 @@ inline bool AdjMatrixGraph<T, E>::GetVertexByIndex(int index, T &vertex) const {
  * @brief : 插入边或弧
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex1
  * @param  vertex2
  * @param  weight
@@ -444,8 +525,8 @@ inline bool AdjMatrixGraph<T, E>::GetVertexByIndex(int index, T &vertex) const {
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjMatrixGraph<T, E>::InsertEdge(int vertex1, int vertex2, const E &weight) {
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::InsertEdge(int vertex1, int vertex2, const E &weight) {
   // 检查顶点索引是否有效
   if (vertex1 < 0 || vertex1 >= m_vertex_count || vertex2 < 0 || vertex2 >= m_vertex_count) {
     return false; // 无效的顶点索引
@@ -477,14 +558,15 @@ inline bool AdjMatrixGraph<T, E>::InsertEdge(int vertex1, int vertex2, const E &
  * @brief : 删除边或弧
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex1
  * @param  vertex2
  * @return true
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjMatrixGraph<T, E>::RemoveEdge(int vertex1, int vertex2) {
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::RemoveEdge(int vertex1, int vertex2) {
   if (m_adj_matrix.Remove(vertex1, vertex2)) {
     --m_edge_count;
     return true;
@@ -497,14 +579,15 @@ inline bool AdjMatrixGraph<T, E>::RemoveEdge(int vertex1, int vertex2) {
  * @brief : 判断边或弧是否存在
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex1
  * @param  vertex2
  * @return true
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjMatrixGraph<T, E>::IsEdgeExist(int vertex1, int vertex2) const {
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::IsEdgeExist(int vertex1, int vertex2) const {
   if (m_adj_matrix.IsNonZeroAt(vertex1, vertex2)) {
     return true;
   }
@@ -516,6 +599,7 @@ inline bool AdjMatrixGraph<T, E>::IsEdgeExist(int vertex1, int vertex2) const {
  * @brief : 获取边或弧的权值
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex1
  * @param  vertex2
  * @param  weight
@@ -523,8 +607,8 @@ inline bool AdjMatrixGraph<T, E>::IsEdgeExist(int vertex1, int vertex2) const {
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjMatrixGraph<T, E>::GetEdgeWeight(int vertex1, int vertex2, E &weight) const {
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::GetEdgeWeight(int vertex1, int vertex2, E &weight) const {
   if (m_adj_matrix.GetValue(vertex1, vertex2, weight)) {
     return true;
   }
@@ -536,6 +620,7 @@ inline bool AdjMatrixGraph<T, E>::GetEdgeWeight(int vertex1, int vertex2, E &wei
  * @brief : 设置边或弧的权值
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex1
  * @param  vertex2
  * @param  weight
@@ -543,8 +628,8 @@ inline bool AdjMatrixGraph<T, E>::GetEdgeWeight(int vertex1, int vertex2, E &wei
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjMatrixGraph<T, E>::SetEdgeWeight(int vertex1, int vertex2, const E &weight) {
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::SetEdgeWeight(int vertex1, int vertex2, const E &weight) {
   if (m_adj_matrix.Insert(vertex1, vertex2, weight)) {
     return true;
   }
@@ -556,12 +641,13 @@ inline bool AdjMatrixGraph<T, E>::SetEdgeWeight(int vertex1, int vertex2, const
  * @brief : 深度优先遍历
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  start_vertex
  * @param  visit            自定义处理顶点的函数
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjMatrixGraph<T, E>::DepthFirstSearch(int start_vertex, void (*visit)(const T &vertex)) const {
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::DepthFirstSearch(int start_vertex, void (*visit)(const T &vertex)) const {
   // 检查起始顶点是否合法
   if (start_vertex < 0 || start_vertex >= m_vertex_count) {
     return; // 非法的起始顶点
@@ -597,12 +683,13 @@ inline void AdjMatrixGraph<T, E>::DepthFirstSearch(int start_vertex, void (*visi
  * @brief : 广度优先遍历
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  start_vertex
  * @param  visit
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjMatrixGraph<T, E>::BreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex)) const {
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::BreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex)) const {
   // 检查起始顶点是否合法
   if (start_vertex < 0 || start_vertex >= m_vertex_count) {
     return; // 非法的起始顶点
@@ -633,18 +720,168 @@ inline void AdjMatrixGraph<T, E>::BreadthFirstSearch(int start_vertex, void (*vi
   delete[] visited;
 }
 
+/**
+ * *****************************************************************
+ * @brief : 深度优先遍历，复用遍历上下文。与不带上下文的版本不同，只访问从起始顶点可达的顶点，
+ *          遍历结束后可用 context.IsVisited 查询哪些顶点可达
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  start_vertex
+ * @param  visit            自定义处理顶点的函数
+ * @param  context          遍历上下文，容量不足时自动扩容
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::DepthFirstSearch(int start_vertex, void (*visit)(const T &vertex), TraversalContext &context) const {
+  DepthFirstSearch(start_vertex, [visit](const T &vertex, int, int) { visit(vertex); return false; }, context);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 广度优先遍历，复用遍历上下文，只访问从起始顶点可达的顶点，
+ *          遍历结束后可用 context.IsVisited 查询哪些顶点可达
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  start_vertex
+ * @param  visit            自定义处理顶点的函数
+ * @param  context          遍历上下文，容量不足时自动扩容
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::BreadthFirstSearch(int start_vertex, void (*visit)(const T &vertex), TraversalContext &context) const {
+  BreadthFirstSearch(start_vertex, [visit](const T &vertex, int, int) { visit(vertex); return false; }, context);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 深度优先遍历，访问器为任意可调用对象，只访问从起始顶点可达的顶点
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @tparam F bool(const T &vertex, int index, int depth)，返回 true 时停止遍历
+ * @param  start_vertex
+ * @param  visit
+ * @return true 被访问器提前停止
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+template <typename F>
+inline bool AdjMatrixGraph<T, E, H>::DepthFirstSearch(int start_vertex, F visit) const {
+  TraversalContext context(m_vertex_count);
+  return DepthFirstSearch(start_vertex, visit, context);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 广度优先遍历，访问器为任意可调用对象，只访问从起始顶点可达的顶点
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @tparam F bool(const T &vertex, int index, int depth)，返回 true 时停止遍历
+ * @param  start_vertex
+ * @param  visit
+ * @return true 被访问器提前停止
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+template <typename F>
+inline bool AdjMatrixGraph<T, E, H>::BreadthFirstSearch(int start_vertex, F visit) const {
+  TraversalContext context(m_vertex_count);
+  return BreadthFirstSearch(start_vertex, visit, context);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 深度优先遍历，访问器为任意可调用对象，复用遍历上下文
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @tparam F bool(const T &vertex, int index, int depth)，depth 为深度优先树中的深度，返回 true 时停止遍历
+ * @param  start_vertex
+ * @param  visit
+ * @param  context 遍历上下文，容量不足时自动扩容
+ * @return true 被访问器提前停止
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+template <typename F>
+inline bool AdjMatrixGraph<T, E, H>::DepthFirstSearch(int start_vertex, F visit, TraversalContext &context) const {
+  context.Reserve(m_vertex_count);
+  context.Reset();
+  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
+    return false; // 非法的起始顶点
+  }
+
+  return HelpDepthFirstSearch(start_vertex, 0, visit, context);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 广度优先遍历，访问器为任意可调用对象，复用遍历上下文，队列就是上下文中预分配的数组
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @tparam F bool(const T &vertex, int index, int depth)，depth 为跳数，返回 true 时停止遍历
+ * @param  start_vertex
+ * @param  visit
+ * @param  context 遍历上下文，容量不足时自动扩容
+ * @return true 被访问器提前停止
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+template <typename F>
+inline bool AdjMatrixGraph<T, E, H>::BreadthFirstSearch(int start_vertex, F visit, TraversalContext &context) const {
+  context.Reserve(m_vertex_count);
+  context.Reset();
+  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
+    return false; // 非法的起始顶点
+  }
+
+  // 每个顶点只入队一次，队列不会超过顶点个数；跳数记在暂存区
+  int *vertex_queue = context.GetBuffer();
+  int *depths = context.GetSlots();
+  int head = 0;
+  int tail = 0;
+  vertex_queue[tail++] = start_vertex;
+  depths[start_vertex] = 0;
+  context.Visit(start_vertex);
+
+  while (head < tail) {
+    int current_vertex = vertex_queue[head++];
+    if (visit(m_vertexs[current_vertex], current_vertex, depths[current_vertex])) {
+      return true;
+    }
+
+    typename TripletSparseMatrix<E>::Iterator row_end = m_adj_matrix.RowEnd(current_vertex);
+    for (typename TripletSparseMatrix<E>::Iterator it = m_adj_matrix.RowBegin(current_vertex); it != row_end; ++it) {
+      if (context.Visit(it->m_col)) {
+        depths[it->m_col] = depths[current_vertex] + 1;
+        vertex_queue[tail++] = it->m_col;
+      }
+    }
+  }
+  return false;
+}
+
 /**
  * *****************************************************************
  * @brief : Dijkstra 算法：用于在加权图中计算从起点顶点到其余顶点的最短路径
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  start_vertex 起始顶点的索引
  * @param  distance 保存从起点到各顶点的最短距离
  * @param  path 保存最短路径的前驱顶点索引，便于回溯路径
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjMatrixGraph<T, E>::Dijkstra(int start_vertex, E *distance) const {
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::Dijkstra(int start_vertex, E *distance) const {
   const E INF = std::numeric_limits<E>::max(); // 用于表示无穷大的值
 
   // 初始化distance
@@ -692,17 +929,239 @@ inline void AdjMatrixGraph<T, E>::Dijkstra(int start_vertex, E *distance) const
   delete[] visited; // 释放内存
 }
 
+/**
+ * *****************************************************************
+ * @brief : 堆优化的 Dijkstra 算法，复用遍历上下文中的索引堆，代价 O((V' + E') log V')，
+ *          V'、E' 为可达的顶点和边。只写入可达顶点的距离，其余位置保持原值不动，
+ *          结束后用 context.IsVisited 判断顶点是否可达。边的权值不能为负
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  start_vertex 起始顶点的索引
+ * @param  distance 保存从起点到各顶点的最短距离，长度不小于顶点数量
+ * @param  context 遍历上下文，容量不足时自动扩容
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::Dijkstra(int start_vertex, E *distance, TraversalContext &context) const {
+  context.Reserve(m_vertex_count);
+  context.Reset();
+  context.ClearHeap();
+  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
+    return; // 非法的起始顶点
+  }
+
+  distance[start_vertex] = 0;
+  context.Visit(start_vertex);
+  context.PushHeap(start_vertex, distance);
+
+  while (!context.IsHeapEmpty()) {
+    int u = context.PopHeap(distance); // 出堆即确定最短距离
+
+    typename TripletSparseMatrix<E>::Iterator row_end = m_adj_matrix.RowEnd(u);
+    for (typename TripletSparseMatrix<E>::Iterator it = m_adj_matrix.RowBegin(u); it != row_end; ++it) {
+      int v = it->m_col;
+      E new_dist = distance[u] + it->m_value;
+      if (context.Visit(v)) {
+        distance[v] = new_dist; // 第一次到达
+        context.PushHeap(v, distance);
+      } else if (context.IsInHeap(v) && new_dist < distance[v]) {
+        distance[v] = new_dist; // 松弛
+        context.DecreaseKey(v, distance);
+      }
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 获取邻接矩阵，用于直接做矩阵运算
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @return const TripletSparseMatrix<E>&
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline const TripletSparseMatrix<E> &AdjMatrixGraph<T, E, H>::GetAdjMatrix() const {
+  return m_adj_matrix;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 按层的广度优先搜索，每层一次 (or, second) 半环上的矩阵乘向量：
+ *          next = A^T * frontier，以已访问顶点的补集为掩码，已访问的行不再扫描。
+ *          有向图先转置一次，无向图的邻接矩阵本身对称
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  start_vertex 起始顶点的索引
+ * @param  level 保存各顶点的层数，起点为 0，不可达为 -1，长度不小于顶点数量
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::BreadthFirstLevels(int start_vertex, int *level) const {
+  for (int i = 0; i < m_vertex_count; ++i) {
+    level[i] = -1;
+  }
+  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
+    return; // 非法的起始顶点
+  }
+
+  TripletSparseMatrix<E> transpose;
+  const TripletSparseMatrix<E> *pull = &m_adj_matrix;
+  if (m_is_directed) {
+    m_adj_matrix.TransposeFast(transpose);
+    pull = &transpose;
+  }
+
+  const int n = m_adj_matrix.GetRows();
+  E *frontier = new E[n]();
+  E *next = new E[n];
+  bool *visited = new bool[n]();
+  frontier[start_vertex] = E(1);
+  visited[start_vertex] = true;
+  level[start_vertex] = 0;
+
+  for (int depth = 1;; ++depth) {
+    pull->template Multiply<OrSecondSemiring<E>>(frontier, next, visited, true);
+
+    bool expanded = false;
+    for (int i = 0; i < n; ++i) {
+      if (next[i] != E()) {
+        visited[i] = true;
+        level[i] = depth;
+        expanded = true;
+      }
+    }
+    if (!expanded) {
+      break;
+    }
+    std::swap(frontier, next); // 被屏蔽的位置已写入零，next 只含新一层
+  }
+
+  delete[] frontier;
+  delete[] next;
+  delete[] visited;
+}
+
+/**
+ * *****************************************************************
+ * @brief : Bellman-Ford 算法的矩阵形式：每轮 relaxed = A^T (min, +) distance，
+ *          再逐分量取较小值，没有变化时结束。每轮 O(e)，最多顶点数轮，允许负权
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  start_vertex 起始顶点的索引
+ * @param  distance 保存从起点到各顶点的最短距离，不可达为 numeric_limits<E>::max()
+ * @return true
+ * @return false 起始顶点非法，或存在从起点可达的负环
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::BellmanFord(int start_vertex, E *distance) const {
+  const E INF = std::numeric_limits<E>::max(); // 用于表示无穷大的值
+  for (int i = 0; i < m_vertex_count; ++i) {
+    distance[i] = INF;
+  }
+  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
+    return false; // 非法的起始顶点
+  }
+
+  TripletSparseMatrix<E> transpose;
+  const TripletSparseMatrix<E> *pull = &m_adj_matrix;
+  if (m_is_directed) {
+    m_adj_matrix.TransposeFast(transpose);
+    pull = &transpose;
+  }
+
+  const int n = m_adj_matrix.GetRows();
+  E *current = new E[n];
+  E *relaxed = new E[n];
+  std::fill(current, current + n, INF);
+  current[start_vertex] = 0;
+
+  // 第 k 轮后得到最多 k 条边的最短路径，第 m_vertex_count 轮仍有变化说明存在负环
+  bool changed = true;
+  for (int round = 0; changed && round < m_vertex_count; ++round) {
+    pull->template Multiply<MinPlusSemiring<E>>(current, relaxed);
+    changed = false;
+    for (int i = 0; i < n; ++i) {
+      if (relaxed[i] < current[i]) {
+        current[i] = relaxed[i];
+        changed = true;
+      }
+    }
+  }
+
+  std::copy(current, current + m_vertex_count, distance);
+  delete[] current;
+  delete[] relaxed;
+  return !changed;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 无向图的三角形个数。取邻接矩阵的严格下三角 L（值为 1），以 L 为掩码计算 L * L，
+ *          C[i][j] 为满足 i > k > j 的三角形 (i, k, j) 个数，每个三角形恰好计一次。
+ *          掩码使不是边的位置不做乘加
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @return long long 三角形个数，有向图返回 -1
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline long long AdjMatrixGraph<T, E, H>::CountTriangles() const {
+  if (m_is_directed) {
+    return -1;
+  }
+
+  const int n = m_adj_matrix.GetRows();
+  const int total = m_adj_matrix.GetTolal();
+  int *offsets = new int[n + 1];
+  int *indices = new int[total > 0 ? total : 1];
+  E *ones = new E[total > 0 ? total : 1];
+
+  int count = 0;
+  for (int i = 0; i < n; ++i) {
+    offsets[i] = count;
+    typename TripletSparseMatrix<E>::Iterator row_end = m_adj_matrix.RowEnd(i);
+    for (typename TripletSparseMatrix<E>::Iterator it = m_adj_matrix.RowBegin(i); it != row_end && it->m_col < i; ++it) {
+      indices[count] = it->m_col;
+      ones[count++] = E(1);
+    }
+  }
+  offsets[n] = count;
+
+  TripletSparseMatrix<E> lower;
+  lower.LoadCSR(n, n, offsets, indices, ones);
+  delete[] offsets;
+  delete[] indices;
+  delete[] ones;
+
+  TripletSparseMatrix<E> paths;
+  lower.template Multiply<PlusTimesSemiring<E>>(lower, paths, &lower);
+
+  long long triangles = 0;
+  for (typename TripletSparseMatrix<E>::Iterator it = paths.begin(); it != paths.end(); ++it) {
+    triangles += static_cast<long long>(it->m_value);
+  }
+  return triangles;
+}
+
 /**
  * *****************************************************************
  * @brief :Floyd 算法
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  distance
  * @param  path
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjMatrixGraph<T, E>::Floyd(E **distance, int **path) const {
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::Floyd(E **distance, int **path) const {
   HelpFloyd(distance, path); // 初始化矩阵
 
   // 开始 Floyd 核心算法
@@ -727,13 +1186,14 @@ inline void AdjMatrixGraph<T, E>::Floyd(E **distance, int **path) const {
  * @brief : 拓扑排序
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  sorted_vertices
  * @return true
  * @return false
  * *****************************************************************
  */
-template <typename T, typename E>
-inline bool AdjMatrixGraph<T, E>::TopologicalSort(T *sorted_vertices) const {
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::TopologicalSort(T *sorted_vertices) const {
 
   if (!m_is_directed) {
     delete[] sorted_vertices;
@@ -787,18 +1247,72 @@ inline bool AdjMatrixGraph<T, E>::TopologicalSort(T *sorted_vertices) const {
   return true; // 拓扑排序成功
 }
 
+/**
+ * *****************************************************************
+ * @brief : 拓扑排序，入度和队列都放在遍历上下文中。入度一次扫描三元组得到，
+ *          邻居按行区间访问，总代价 O(V + E)
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  sorted_vertices
+ * @param  context 遍历上下文，容量不足时自动扩容
+ * @return true
+ * @return false 无向图或有环
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::TopologicalSort(T *sorted_vertices, TraversalContext &context) const {
+  if (!m_is_directed) {
+    return false;
+  }
+
+  context.Reserve(m_vertex_count);
+  int *in_degrees = context.GetSlots();
+  int *zero_in_degree_queue = context.GetBuffer(); // 每个顶点只入队一次
+  int head = 0;
+  int tail = 0;
+
+  for (int i = 0; i < m_vertex_count; ++i) {
+    in_degrees[i] = 0;
+  }
+  for (typename TripletSparseMatrix<E>::Iterator it = m_adj_matrix.begin(); it != m_adj_matrix.end(); ++it) {
+    ++in_degrees[it->m_col];
+  }
+  for (int i = 0; i < m_vertex_count; ++i) {
+    if (in_degrees[i] == 0) {
+      zero_in_degree_queue[tail++] = i;
+    }
+  }
+
+  while (head < tail) {
+    int vertex = zero_in_degree_queue[head++];
+    sorted_vertices[head - 1] = m_vertexs[vertex];
+
+    typename TripletSparseMatrix<E>::Iterator row_end = m_adj_matrix.RowEnd(vertex);
+    for (typename TripletSparseMatrix<E>::Iterator it = m_adj_matrix.RowBegin(vertex); it != row_end; ++it) {
+      if (--in_degrees[it->m_col] == 0) {
+        zero_in_degree_queue[tail++] = it->m_col;
+      }
+    }
+  }
+
+  // 排序后的顶点数量小于图的顶点数量，说明存在环
+  return tail == m_vertex_count;
+}
+
 /**
  * *****************************************************************
  * @brief : Prim 算法
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  start_vertex
  * @param  distance
  * @param  path
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjMatrixGraph<T, E>::Prim(int start_vertex, E *distance, int *path) const {
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::Prim(int start_vertex, E *distance, int *path) const {
   if (start_vertex < 0 || start_vertex >= m_vertex_count) {
     delete[] distance;
     distance = nullptr;
@@ -857,11 +1371,12 @@ inline void AdjMatrixGraph<T, E>::Prim(int start_vertex, E *distance, int *path)
  * @brief : Kruskal 算法
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  matrix 存储最小生成树的边集合
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjMatrixGraph<T, E>::Kruskal(TripletSparseMatrix<E> &matrix) const {
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::Kruskal(TripletSparseMatrix<E> &matrix) const {
 
   //将所有的边放入优先队列中
   PriorityQueue<Edge> edges;
@@ -904,12 +1419,13 @@ inline void AdjMatrixGraph<T, E>::Kruskal(TripletSparseMatrix<E> &matrix) const
  * @brief : 顶点入度
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex
  * @return int              返回-1说明图是无向图或者给出的序号超出范围
  * *****************************************************************
  */
-template <typename T, typename E>
-inline int AdjMatrixGraph<T, E>::GetInDegree(int vertex) const {
+template <typename T, typename E, typename H>
+inline int AdjMatrixGraph<T, E, H>::GetInDegree(int vertex) const {
 
   if (vertex < 0 || vertex >= m_vertex_count || !m_is_directed) {
     return -1;
@@ -932,12 +1448,13 @@ inline int AdjMatrixGraph<T, E>::GetInDegree(int vertex) const {
  * @brief : 顶点出度
  * @tparam T
  * @tparam E
+ * @tparam H
  * @param  vertex
  * @return int
  * *****************************************************************
  */
-template <typename T, typename E>
-inline int AdjMatrixGraph<T, E>::GetOutDegree(int vertex) const {
+template <typename T, typename E, typename H>
+inline int AdjMatrixGraph<T, E, H>::GetOutDegree(int vertex) const {
   if (vertex < 0 || vertex >= m_vertex_count || !m_is_directed) {
     return -1;
   }
@@ -954,17 +1471,156 @@ inline int AdjMatrixGraph<T, E>::GetOutDegree(int vertex) const {
   return out_degree; // 返回出度
 }
 
+/**
+ * *****************************************************************
+ * @brief : 导出为 CSR 快照，三元组按行列有序，直接按行切分即可
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  csr
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::ToCSRGraph(CSRGraph<E> &csr) const {
+  csr.Resize(m_vertex_count, m_adj_matrix.GetTolal());
+
+  int *offsets = csr.GetOffsets();
+  int *targets = csr.GetTargets();
+  E *weights = csr.GetWeights();
+
+  for (int i = 0; i <= m_vertex_count; ++i) {
+    offsets[i] = 0;
+  }
+
+  int pos = 0;
+  for (auto it = m_adj_matrix.begin(); it != m_adj_matrix.end(); ++it) {
+    ++offsets[it->m_row + 1];
+    targets[pos] = it->m_col;
+    weights[pos] = it->m_value;
+    ++pos;
+  }
+
+  for (int i = 1; i <= m_vertex_count; ++i) {
+    offsets[i] += offsets[i - 1];
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 按给定的映射重新编号顶点，顶点数组和邻接矩阵一起重排
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  permutation permutation[旧索引] = 新索引，必须是 0 到顶点数量减一的一个排列
+ * @return true
+ * @return false 映射不是排列
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::Relabel(const int *permutation) {
+  const int n = m_vertex_count;
+
+  // 检查是否为排列
+  bool *seen = new bool[n > 0 ? n : 1];
+  for (int i = 0; i < n; ++i) {
+    seen[i] = false;
+  }
+  for (int i = 0; i < n; ++i) {
+    if (permutation[i] < 0 || permutation[i] >= n || seen[permutation[i]]) {
+      delete[] seen;
+      return false;
+    }
+    seen[permutation[i]] = true;
+  }
+  delete[] seen;
+
+  // 顶点数组，容量与邻接矩阵的行数一致
+  T *new_vertexs = new T[m_adj_matrix.GetRows()];
+  for (int i = 0; i < n; ++i) {
+    new_vertexs[permutation[i]] = m_vertexs[i];
+  }
+  delete[] m_vertexs;
+  m_vertexs = new_vertexs;
+
+  // 改写三元组的行列后重新排序
+  for (auto it = m_adj_matrix.begin(); it != m_adj_matrix.end(); ++it) {
+    it->m_row = permutation[it->m_row];
+    it->m_col = permutation[it->m_col];
+  }
+  m_adj_matrix.Sort();
+
+  // 重建顶点索引
+  m_vertex_index.Clear();
+  for (int i = 0; i < n; ++i) {
+    m_vertex_index.Insert(m_vertexs[i], i);
+  }
+
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 计算重排并重新编号
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  order 重排方式
+ * @param  permutation 输出 permutation[旧索引] = 新索引
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline bool AdjMatrixGraph<T, E, H>::Reorder(VertexOrder order, int *permutation) {
+  CSRGraph<E> csr;
+  ToCSRGraph(csr);
+  csr.ComputeOrder(order, permutation);
+
+  return Relabel(permutation);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 二分图最大匹配，先二染色求两部分，再在 CSR 快照上运行 Hopcroft-Karp
+ * @tparam T
+ * @tparam E
+ * @tparam H
+ * @param  mate 输出每个顶点匹配到的顶点索引，未匹配为 -1
+ * @return int 匹配的边数，有向图或不是二分图时返回 -1
+ * *****************************************************************
+ */
+template <typename T, typename E, typename H>
+inline int AdjMatrixGraph<T, E, H>::MaximumMatching(int *mate) const {
+  if (m_is_directed) {
+    return -1;
+  }
+
+  CSRGraph<E> csr;
+  ToCSRGraph(csr);
+
+  bool *is_left = new bool[m_vertex_count > 0 ? m_vertex_count : 1];
+  int matching = -1;
+  if (csr.Bipartition(is_left)) {
+    matching = csr.HopcroftKarp(is_left, mate);
+  }
+
+  delete[] is_left;
+  return matching;
+}
+
 /**
  * *****************************************************************
  * @brief : 清空图中的所有顶点和边
  * @tparam T
  * @tparam E
+ * @tparam H
  * *****************************************************************
  */
-template <typename T, typename E>
-inline void AdjMatrixGraph<T, E>::Clear() {
+template <typename T, typename E, typename H>
+inline void AdjMatrixGraph<T, E, H>::Clear() {
   delete[] m_vertexs;
   m_adj_matrix.Clear();
+  m_vertex_index.Clear();
 }
 
 } // namespace bu_tools
@@ -0,0 +1,534 @@
+/**
+ * ************************************************************************
+ * @filename: benchmark_graph.cpp
+ *
+ * @brief : 图的性能基准：合成 R-MAT、二维网格和 Erdős–Rényi 随机图，
+ *          分别装入 AdjLsitgraph 和 AdjMatrixGraph，测量构建、遍历、最短路径、
+ *          最小生成树和拓扑排序的耗时、吞吐量（边/秒）和常驻内存，输出 CSV 便于比较回归
+ *
+ *          用法: benchmark_graph [--generator rmat|grid|er|all] [--graph list|matrix|all]
+ *                                [--scale S] [--matrix-scale S] [--edge-factor F]
+ *                                [--repeat R] [--budget W] [--seed N]
+ *          顶点数为 2^S；邻接矩阵图的构建是 O(E^2)，单独用较小的 --matrix-scale。
+ *          每个操作按复杂度估算工作量，超过 --budget 的记为 skipped，不会卡住整轮测量。
+ *          计时请使用 Release 构建（-DCMAKE_BUILD_TYPE=Release）
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-18
+ *
+ * ************************************************************************
+ */
+
+#include "adjlistgraph.h"
+#include "adjmatrixgraph.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+参数与输出
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct Options {
+  std::string generator = "all"; // rmat、grid、er 或 all
+  std::string graph = "all";     // list、matrix 或 all
+  int scale = 14;                // 邻接表图的顶点数为 2^scale
+  int matrix_scale = 8;          // 邻接矩阵图的顶点数为 2^matrix_scale
+  int edge_factor = 8;           // R-MAT 和随机图的边数为 edge_factor * 顶点数
+  int repeat = 3;                // 每个操作重复次数，取最快的一次
+  double budget = 5e8;           // 单次操作估算工作量的上限
+  unsigned long long seed = 1;
+};
+
+// 一张合成图：无向边 src < dest，已去重、无自环
+struct EdgeList {
+  std::string generator;
+  int scale;
+  int vertex_count;
+  std::vector<int> srcs;
+  std::vector<int> dests;
+  std::vector<int> weights;
+};
+
+/**
+ * *****************************************************************
+ * @brief : 读取当前进程的常驻内存（/proc/self/status 的 VmRSS），不支持的平台返回 0
+ * @return long KB
+ * *****************************************************************
+ */
+long ReadRSSKiloBytes() {
+  FILE *file = std::fopen("/proc/self/status", "r");
+  if (file == nullptr) {
+    return 0;
+  }
+  char line[256];
+  long rss = 0;
+  while (std::fgets(line, sizeof(line), file) != nullptr) {
+    if (std::strncmp(line, "VmRSS:", 6) == 0) {
+      rss = std::strtol(line + 6, nullptr, 10);
+      break;
+    }
+  }
+  std::fclose(file);
+  return rss;
+}
+
+void PrintHeader() {
+  std::printf("class,generator,scale,vertices,edges,operation,status,seconds,edges_per_sec,rss_kb,rss_delta_kb\n");
+}
+
+/**
+ * *****************************************************************
+ * @brief : 测量一个操作：估算工作量超过预算时输出 skipped，否则重复执行取最快的一次
+ * @tparam F
+ * @param  class_name
+ * @param  graph
+ * @param  operation
+ * @param  cost 按复杂度估算的工作量
+ * @param  options
+ * @param  run
+ * *****************************************************************
+ */
+template <typename F>
+void Measure(const char *class_name, const EdgeList &graph, const char *operation, double cost, const Options &options,
+             F run) {
+  const long long edges = static_cast<long long>(graph.srcs.size());
+  if (cost > options.budget) {
+    std::printf("%s,%s,%d,%d,%lld,%s,skipped,0,0,%ld,0\n", class_name, graph.generator.c_str(), graph.scale,
+                graph.vertex_count, edges, operation, ReadRSSKiloBytes());
+    std::fflush(stdout);
+    return;
+  }
+
+  long rss_before = ReadRSSKiloBytes();
+  double best = -1.0;
+  for (int r = 0; r < options.repeat; ++r) {
+    auto begin = std::chrono::steady_clock::now();
+    run();
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    if (best < 0 || seconds < best) {
+      best = seconds;
+    }
+  }
+  long rss_after = ReadRSSKiloBytes();
+
+  double throughput = best > 0 ? static_cast<double>(edges) / best : 0.0;
+  std::printf("%s,%s,%d,%d,%lld,%s,ok,%.6f,%.0f,%ld,%ld\n", class_name, graph.generator.c_str(), graph.scale,
+              graph.vertex_count, edges, operation, best, throughput, rss_after, rss_after - rss_before);
+  std::fflush(stdout);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+图的生成
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * *****************************************************************
+ * @brief : 无向化、去掉自环和重边，并附上 1 到 100 的随机权值
+ * @param  graph
+ * @param  pairs
+ * @param  rng
+ * *****************************************************************
+ */
+void Finish(EdgeList &graph, std::vector<std::pair<int, int>> &pairs, std::mt19937_64 &rng) {
+  for (auto &edge : pairs) {
+    if (edge.first > edge.second) {
+      std::swap(edge.first, edge.second);
+    }
+  }
+  std::sort(pairs.begin(), pairs.end());
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+  std::uniform_int_distribution<int> weight(1, 100);
+  for (const auto &edge : pairs) {
+    if (edge.first == edge.second) {
+      continue;
+    }
+    graph.srcs.push_back(edge.first);
+    graph.dests.push_back(edge.second);
+    graph.weights.push_back(weight(rng));
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : R-MAT（Kronecker）图，象限概率 a=0.57, b=0.19, c=0.19, d=0.05，度数呈幂律分布
+ * @param  scale 顶点数为 2^scale
+ * @param  edge_factor
+ * @param  seed
+ * @return EdgeList
+ * *****************************************************************
+ */
+EdgeList GenerateRMAT(int scale, int edge_factor, unsigned long long seed) {
+  EdgeList graph;
+  graph.generator = "rmat";
+  graph.scale = scale;
+  graph.vertex_count = 1 << scale;
+
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  const double a = 0.57, b = 0.19, c = 0.19;
+  long long edge_count = static_cast<long long>(edge_factor) * graph.vertex_count;
+
+  std::vector<std::pair<int, int>> pairs;
+  pairs.reserve(edge_count);
+  for (long long k = 0; k < edge_count; ++k) {
+    int src = 0, dest = 0;
+    for (int bit = 0; bit < scale; ++bit) {
+      double p = uniform(rng);
+      if (p < a) {
+        // 左上象限
+      } else if (p < a + b) {
+        dest |= 1 << bit;
+      } else if (p < a + b + c) {
+        src |= 1 << bit;
+      } else {
+        src |= 1 << bit;
+        dest |= 1 << bit;
+      }
+    }
+    pairs.push_back(std::make_pair(src, dest));
+  }
+
+  Finish(graph, pairs, rng);
+  return graph;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 二维网格，每个顶点连向右边和下边的邻居，直径大、度数均匀
+ * @param  scale 顶点数为 2^scale
+ * @param  seed
+ * @return EdgeList
+ * *****************************************************************
+ */
+EdgeList GenerateGrid(int scale, unsigned long long seed) {
+  EdgeList graph;
+  graph.generator = "grid";
+  graph.scale = scale;
+  graph.vertex_count = 1 << scale;
+
+  const int rows = 1 << (scale / 2);
+  const int cols = graph.vertex_count / rows;
+  std::vector<std::pair<int, int>> pairs;
+  pairs.reserve(2 * graph.vertex_count);
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) {
+      int v = r * cols + c;
+      if (c + 1 < cols) {
+        pairs.push_back(std::make_pair(v, v + 1));
+      }
+      if (r + 1 < rows) {
+        pairs.push_back(std::make_pair(v, v + cols));
+      }
+    }
+  }
+
+  std::mt19937_64 rng(seed);
+  Finish(graph, pairs, rng);
+  return graph;
+}
+
+/**
+ * *****************************************************************
+ * @brief : Erdős–Rényi G(n, m) 随机图，均匀随机选取端点
+ * @param  scale 顶点数为 2^scale
+ * @param  edge_factor
+ * @param  seed
+ * @return EdgeList
+ * *****************************************************************
+ */
+EdgeList GenerateErdosRenyi(int scale, int edge_factor, unsigned long long seed) {
+  EdgeList graph;
+  graph.generator = "er";
+  graph.scale = scale;
+  graph.vertex_count = 1 << scale;
+
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<int> vertex(0, graph.vertex_count - 1);
+  long long edge_count = static_cast<long long>(edge_factor) * graph.vertex_count;
+
+  std::vector<std::pair<int, int>> pairs;
+  pairs.reserve(edge_count);
+  for (long long k = 0; k < edge_count; ++k) {
+    pairs.push_back(std::make_pair(vertex(rng), vertex(rng)));
+  }
+
+  Finish(graph, pairs, rng);
+  return graph;
+}
+
+EdgeList Generate(const std::string &generator, int scale, const Options &options) {
+  if (generator == "rmat") {
+    return GenerateRMAT(scale, options.edge_factor, options.seed);
+  }
+  if (generator == "grid") {
+    return GenerateGrid(scale, options.seed);
+  }
+  return GenerateErdosRenyi(scale, options.edge_factor, options.seed);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+基准
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// 函数指针版本的遍历需要一个全局的访问函数，累加顶点防止被优化掉
+long long g_visit_sum = 0;
+void Touch(const int &vertex) {
+  g_visit_sum += vertex;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 邻接表图：无向图上测遍历、最短路径和最小生成树，有向无环图（小索引指向大索引）上测拓扑排序
+ * @param  graph
+ * @param  options
+ * *****************************************************************
+ */
+void BenchmarkList(const EdgeList &graph, const Options &options) {
+  typedef bu_tools::AdjLsitgraph<int, int> Graph;
+  const char *name = "AdjLsitgraph";
+  const int n = graph.vertex_count;
+  const int m = static_cast<int>(graph.srcs.size());
+  const double V = n, E = m;
+  const double log_v = std::log2(V + 1);
+
+  Graph *undirected = nullptr;
+  Measure(name, graph, "build", E, options, [&]() {
+    delete undirected;
+    undirected = new Graph(false, n);
+    undirected->ReserveEdges(2 * m);
+    for (int i = 0; i < n; ++i) {
+      undirected->InsertVertex(i);
+    }
+    undirected->InsertEdges(graph.srcs.data(), graph.dests.data(), graph.weights.data(), m, true);
+  });
+  if (undirected == nullptr) {
+    return;
+  }
+
+  bu_tools::TraversalContext context(n);
+  std::vector<int> distance(n);
+
+  Measure(name, graph, "bfs", V + E, options, [&]() { undirected->BreadthFirstSearch(0, Touch); });
+  Measure(name, graph, "bfs_context", V + E, options, [&]() {
+    undirected->BreadthFirstSearch(0, [](const int &vertex, int, int) { g_visit_sum += vertex; return false; }, context);
+  });
+  Measure(name, graph, "bfs_distance", V + E, options, [&]() { undirected->BreadthFirstDistance(0, distance.data()); });
+  Measure(name, graph, "dfs", V + E, options, [&]() { undirected->DepthFirstSearch(0, Touch); });
+  Measure(name, graph, "dfs_context", V + E, options, [&]() {
+    undirected->DepthFirstSearch(0, [](const int &vertex, int, int) { g_visit_sum += vertex; return false; }, context);
+  });
+  Measure(name, graph, "dijkstra", V * V + V * E, options, [&]() { undirected->Dijkstra(0, distance.data()); });
+  Measure(name, graph, "dijkstra_context", (V + E) * log_v, options,
+          [&]() { undirected->Dijkstra(0, distance.data(), context); });
+
+  Measure(name, graph, "floyd", V * V * V + V * E, options, [&]() {
+    int **dist = new int *[n];
+    int **path = new int *[n];
+    for (int i = 0; i < n; ++i) {
+      dist[i] = new int[n];
+      path[i] = new int[n];
+    }
+    undirected->Floyd(dist, path);
+    for (int i = 0; i < n; ++i) {
+      delete[] dist[i];
+      delete[] path[i];
+    }
+    delete[] dist;
+    delete[] path;
+  });
+  Measure(name, graph, "prim", V * V + V * E, options, [&]() {
+    bu_tools::TripletSparseMatrix<int> tree(n, n);
+    undirected->Prim(0, tree);
+  });
+  Measure(name, graph, "kruskal", E * log_v + V * V, options, [&]() {
+    bu_tools::TripletSparseMatrix<int> tree(n, n);
+    undirected->Kruskal(tree);
+  });
+  delete undirected;
+
+  Graph dag(true, n);
+  dag.ReserveEdges(m);
+  for (int i = 0; i < n; ++i) {
+    dag.InsertVertex(i);
+  }
+  dag.InsertEdges(graph.srcs.data(), graph.dests.data(), graph.weights.data(), m, true);
+  std::vector<int> sorted(n);
+  Measure(name, graph, "toposort", V + E, options, [&]() { dag.TopologicalSort(sorted.data()); });
+  Measure(name, graph, "toposort_context", V + E, options,
+          [&]() { dag.TopologicalSort(sorted.data(), context); });
+}
+
+/**
+ * *****************************************************************
+ * @brief : 邻接矩阵图：三元组按行列有序插入是 O(E)，原有的遍历对每对顶点探测一次三元组，
+ *          工作量按 V^2 * E 估算；复用上下文的版本按行二分定位邻居
+ * @param  graph
+ * @param  options
+ * *****************************************************************
+ */
+void BenchmarkMatrix(const EdgeList &graph, const Options &options) {
+  typedef bu_tools::AdjMatrixGraph<int, int> Graph;
+  const char *name = "AdjMatrixGraph";
+  const int n = graph.vertex_count;
+  const int m = static_cast<int>(graph.srcs.size());
+  const double V = n, E = m;
+  const double log_v = std::log2(V + 1);
+
+  Graph *undirected = nullptr;
+  Measure(name, graph, "build", E * E, options, [&]() {
+    delete undirected;
+    undirected = new Graph(n, false);
+    for (int i = 0; i < n; ++i) {
+      undirected->InsertVertex(i);
+    }
+    for (int k = 0; k < m; ++k) {
+      undirected->InsertEdge(graph.srcs[k], graph.dests[k], graph.weights[k]);
+    }
+  });
+  if (undirected == nullptr) {
+    return;
+  }
+
+  bu_tools::TraversalContext context(n);
+  std::vector<int> distance(n);
+  std::vector<int> path(n);
+
+  Measure(name, graph, "bfs", V * V * E, options, [&]() { undirected->BreadthFirstSearch(0, Touch); });
+  Measure(name, graph, "bfs_context", (V + E) * log_v, options, [&]() {
+    undirected->BreadthFirstSearch(0, [](const int &vertex, int, int) { g_visit_sum += vertex; return false; }, context);
+  });
+  Measure(name, graph, "dfs", V * V * E, options, [&]() { undirected->DepthFirstSearch(0, Touch); });
+  Measure(name, graph, "dfs_context", (V + E) * log_v, options, [&]() {
+    undirected->DepthFirstSearch(0, [](const int &vertex, int, int) { g_visit_sum += vertex; return false; }, context);
+  });
+  Measure(name, graph, "dijkstra", V * V * E, options, [&]() { undirected->Dijkstra(0, distance.data()); });
+  Measure(name, graph, "dijkstra_context", (V + E) * log_v, options,
+          [&]() { undirected->Dijkstra(0, distance.data(), context); });
+
+  Measure(name, graph, "floyd", V * V * V + V * V * E, options, [&]() {
+    int **dist = new int *[n];
+    int **floyd_path = new int *[n];
+    for (int i = 0; i < n; ++i) {
+      dist[i] = new int[n];
+      floyd_path[i] = new int[n];
+    }
+    undirected->Floyd(dist, floyd_path);
+    for (int i = 0; i < n; ++i) {
+      delete[] dist[i];
+      delete[] floyd_path[i];
+    }
+    delete[] dist;
+    delete[] floyd_path;
+  });
+  Measure(name, graph, "prim", V * V * E, options, [&]() { undirected->Prim(0, distance.data(), path.data()); });
+  Measure(name, graph, "kruskal", E * log_v + V * V, options, [&]() {
+    bu_tools::TripletSparseMatrix<int> tree(n, n);
+    undirected->Kruskal(tree);
+  });
+  delete undirected;
+
+  if (E * E > options.budget) {
+    Measure(name, graph, "toposort", E * E, options, []() {});
+    Measure(name, graph, "toposort_context", E * E, options, []() {});
+    return;
+  }
+  Graph dag(n, true);
+  for (int i = 0; i < n; ++i) {
+    dag.InsertVertex(i);
+  }
+  for (int k = 0; k < m; ++k) {
+    dag.InsertEdge(graph.srcs[k], graph.dests[k], graph.weights[k]);
+  }
+  std::vector<int> sorted(n);
+  Measure(name, graph, "toposort", V * V * E, options, [&]() { dag.TopologicalSort(sorted.data()); });
+  Measure(name, graph, "toposort_context", V + E, options, [&]() { dag.TopologicalSort(sorted.data(), context); });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+主函数
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ParseOptions(int argc, const char *argv[], Options &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string key = argv[i];
+    if (i + 1 >= argc) {
+      return false;
+    }
+    const char *value = argv[++i];
+    if (key == "--generator") {
+      options.generator = value;
+    } else if (key == "--graph") {
+      options.graph = value;
+    } else if (key == "--scale") {
+      options.scale = std::atoi(value);
+    } else if (key == "--matrix-scale") {
+      options.matrix_scale = std::atoi(value);
+    } else if (key == "--edge-factor") {
+      options.edge_factor = std::atoi(value);
+    } else if (key == "--repeat") {
+      options.repeat = std::atoi(value);
+    } else if (key == "--budget") {
+      options.budget = std::atof(value);
+    } else if (key == "--seed") {
+      options.seed = std::strtoull(value, nullptr, 10);
+    } else {
+      return false;
+    }
+  }
+  return options.scale > 0 && options.scale < 31 && options.matrix_scale > 0 && options.matrix_scale < 31 &&
+         options.edge_factor > 0 && options.repeat > 0;
+}
+
+int main(int argc, const char *argv[]) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    std::fprintf(stderr,
+                 "usage: %s [--generator rmat|grid|er|all] [--graph list|matrix|all] [--scale S] [--matrix-scale S]\n"
+                 "          [--edge-factor F] [--repeat R] [--budget W] [--seed N]\n",
+                 argv[0]);
+    return 1;
+  }
+
+  const char *generators[] = {"rmat", "grid", "er"};
+  PrintHeader();
+  for (const char *generator : generators) {
+    if (options.generator != "all" && options.generator != generator) {
+      continue;
+    }
+    if (options.graph == "all" || options.graph == "list") {
+      BenchmarkList(Generate(generator, options.scale, options), options);
+    }
+    if (options.graph == "all" || options.graph == "matrix") {
+      BenchmarkMatrix(Generate(generator, options.matrix_scale, options), options);
+    }
+  }
+
+  std::fprintf(stderr, "checksum %lld\n", g_visit_sum);
+  return 0;
+}
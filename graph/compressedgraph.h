@@ -0,0 +1,686 @@
+/**
+ * ************************************************************************
+ * @filename: compressedgraph.h
+ *
+ * @brief : 图的压缩邻接表（差分 + 变长整数编码）只读快照
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-13
+ *
+ * ************************************************************************
+ */
+
+#ifndef _COMPRESSEDGRAPH_H_
+#define _COMPRESSEDGRAPH_H_
+
+#include "../queue/seqqueue/seqqueue.h"
+#include "csrgraph.h"
+#include <algorithm>
+#include <climits>
+
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 图的压缩邻接表：每个顶点的邻接顶点按索引升序排列后，第一个存与顶点自身之差（zigzag），
+ *          之后存与前一个邻接顶点之差，差值用变长整数编码，每字节低 7 位是数据、最高位表示后面还有字节。
+ *          重排（逆 Cuthill-McKee 等）之后差值大多只占一个字节。权值按同样的顺序存放在并行数组中，
+ *          也可以不存权值
+ * @tparam E 权值
+ * *****************************************************************
+ */
+template <typename E>
+class CompressedGraph {
+  /*****************************************************************
+
+  数据域
+
+  *****************************************************************/
+protected:
+  int m_vertex_count;        // 顶点数量
+  long long m_edge_count;    // 弧的数量（无向图每条边占两条弧）
+  long long *m_byte_offsets; // 每个顶点编码段在 m_bytes 中的起始位置，长度 m_vertex_count + 1
+  long long *m_arc_offsets;  // 每个顶点第一条弧的序号，长度 m_vertex_count + 1，也用于定位权值
+  unsigned char *m_bytes;    // 编码后的邻接顶点
+  E *m_weights;              // 与弧一一对应的权值，不存权值时为 nullptr
+
+  /*****************************************************************
+
+  成员函数的声明
+
+  *****************************************************************/
+private:
+  static int HelpVarintSize(unsigned long long value);
+  static unsigned char *HelpEncode(unsigned long long value, unsigned char *out);
+  static void HelpSortSegment(const int *targets, int degree, int *order);
+  void HelpEncodeSegments(const int *targets, const E *weights, bool with_weights);
+
+public:
+  /**
+   * *****************************************************************
+   * @brief : 逐个解码某个顶点的邻接顶点，解码状态可以随时保存，供深度优先等需要中断的遍历使用
+   * *****************************************************************
+   */
+  class NeighborCursor {
+  private:
+    const unsigned char *m_pos; // 下一个字节
+    const E *m_weight;          // 下一个权值，不存权值时为 nullptr
+    int m_prev;                 // 上一个解码出的顶点，开始时为顶点自身
+    int m_remaining;            // 剩余的邻接顶点个数
+    bool m_first;               // 下一个是否是第一个邻接顶点
+
+  public:
+    NeighborCursor() : m_pos(nullptr), m_weight(nullptr), m_prev(0), m_remaining(0), m_first(false) {}
+    NeighborCursor(const CompressedGraph &graph, int vertex)
+        : m_pos(graph.m_bytes + graph.m_byte_offsets[vertex]),
+          m_weight(graph.m_weights ? graph.m_weights + graph.m_arc_offsets[vertex] : nullptr), m_prev(vertex),
+          m_remaining(static_cast<int>(graph.m_arc_offsets[vertex + 1] - graph.m_arc_offsets[vertex])), m_first(true) {}
+
+    bool HasNext() const { return m_remaining > 0; }
+
+    // 解码下一个邻接顶点，没有时返回 false
+    bool Next(int &dest) {
+      if (m_remaining == 0) {
+        return false;
+      }
+      --m_remaining;
+
+      // 单字节是最常见的情况，单独走快速路径
+      unsigned long long value = *m_pos++;
+      if (value & 0x80) {
+        value &= 0x7F;
+        int shift = 7;
+        unsigned char byte;
+        do {
+          byte = *m_pos++;
+          value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+          shift += 7;
+        } while (byte & 0x80);
+      }
+
+      if (m_first) {
+        m_first = false;
+        long long delta = static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+        m_prev = static_cast<int>(m_prev + delta);
+      } else {
+        m_prev += static_cast<int>(value);
+      }
+      if (m_weight) {
+        ++m_weight;
+      }
+      dest = m_prev;
+      return true;
+    }
+
+    // 解码下一个邻接顶点及权值，不存权值时权值为 E()
+    bool Next(int &dest, E &weight) {
+      const E *current = m_weight;
+      if (!Next(dest)) {
+        return false;
+      }
+      weight = current ? *current : E();
+      return true;
+    }
+  };
+
+  CompressedGraph() : m_vertex_count(0), m_edge_count(0), m_byte_offsets(nullptr), m_arc_offsets(nullptr), m_bytes(nullptr), m_weights(nullptr) {}
+  CompressedGraph(const CompressedGraph &other);
+  CompressedGraph &operator=(const CompressedGraph &other);
+
+  //移动构造函数
+  CompressedGraph(CompressedGraph &&other) noexcept
+      : m_vertex_count(other.m_vertex_count), m_edge_count(other.m_edge_count), m_byte_offsets(other.m_byte_offsets),
+        m_arc_offsets(other.m_arc_offsets), m_bytes(other.m_bytes), m_weights(other.m_weights) {
+    other.m_vertex_count = 0;
+    other.m_edge_count = 0;
+    other.m_byte_offsets = nullptr;
+    other.m_arc_offsets = nullptr;
+    other.m_bytes = nullptr;
+    other.m_weights = nullptr;
+  }
+
+  virtual ~CompressedGraph() {
+    Clear();
+  }
+
+  void Build(const CSRGraph<E> &csr, bool with_weights = true); // 由 CSR 快照构建
+  // 由 64 位偏移的邻接数组构建
+  bool Build(int vertex_count, const long long *offsets, const int *targets, const E *weights = nullptr);
+  // 由按源顶点有序的弧数组构建，不需要先建立邻接表
+  bool Build(int vertex_count, const int *srcs, const int *dests, const E *weights, long long count);
+  void Clear();                                                  // 释放存储空间
+
+  // 访问邻接顶点
+  int DecodeNeighbors(int vertex, int *neighbors) const;        // 把邻接顶点整段解码到数组，返回个数
+  template <typename F>
+  void ForEachNeighbor(int vertex, F visit) const;               // 依次以 (邻接顶点, 权值) 调用 visit
+
+  // 遍历
+  void DepthFirstSearch(int start_vertex, void (*visit)(int vertex)) const;   // 深度优先遍历
+  void BreadthFirstSearch(int start_vertex, void (*visit)(int vertex)) const; // 广度优先遍历
+
+  int GetVertexCount() const { return m_vertex_count; }
+  long long GetEdgeCount() const { return m_edge_count; }
+  int GetDegree(int vertex) const { return static_cast<int>(m_arc_offsets[vertex + 1] - m_arc_offsets[vertex]); }
+  bool HasWeights() const { return m_weights != nullptr; }
+  long long GetMemoryBytes() const; // 占用的字节数
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+成员函数的定义
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * *****************************************************************
+ * @brief : 变长整数编码后的字节数
+ * @tparam E
+ * @param  value
+ * @return int
+ * *****************************************************************
+ */
+template <typename E>
+inline int CompressedGraph<E>::HelpVarintSize(unsigned long long value) {
+  int size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 变长整数编码
+ * @tparam E
+ * @param  value
+ * @param  out 写入位置
+ * @return unsigned char* 写完之后的位置
+ * *****************************************************************
+ */
+template <typename E>
+inline unsigned char *CompressedGraph<E>::HelpEncode(unsigned long long value, unsigned char *out) {
+  while (value >= 0x80) {
+    *out++ = static_cast<unsigned char>(value | 0x80);
+    value >>= 7;
+  }
+  *out++ = static_cast<unsigned char>(value);
+  return out;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 求邻接段按邻接顶点升序的下标顺序，相同的邻接顶点保持原来的顺序
+ * @tparam E
+ * @param  targets 邻接段
+ * @param  degree 邻接段长度
+ * @param  order 输出下标顺序
+ * *****************************************************************
+ */
+template <typename E>
+inline void CompressedGraph<E>::HelpSortSegment(const int *targets, int degree, int *order) {
+  for (int k = 0; k < degree; ++k) {
+    order[k] = k;
+  }
+  if (!std::is_sorted(targets, targets + degree)) {
+    std::sort(order, order + degree, [targets](int a, int b) { return targets[a] < targets[b] || (targets[a] == targets[b] && a < b); });
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : Construct a new CompressedGraph< E>:: CompressedGraph object
+ * @tparam E
+ * @param  other
+ * *****************************************************************
+ */
+template <typename E>
+inline CompressedGraph<E>::CompressedGraph(const CompressedGraph &other)
+    : m_vertex_count(0), m_edge_count(0), m_byte_offsets(nullptr), m_arc_offsets(nullptr), m_bytes(nullptr), m_weights(nullptr) {
+  *this = other;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 重载赋值运算符
+ * @tparam E
+ * @param  other
+ * @return CompressedGraph<E>&
+ * *****************************************************************
+ */
+template <typename E>
+inline CompressedGraph<E> &CompressedGraph<E>::operator=(const CompressedGraph &other) {
+  if (this != &other) {
+    Clear();
+    if (other.m_byte_offsets == nullptr) {
+      return *this;
+    }
+
+    m_vertex_count = other.m_vertex_count;
+    m_edge_count = other.m_edge_count;
+    long long byte_count = other.m_byte_offsets[m_vertex_count];
+    m_byte_offsets = new long long[m_vertex_count + 1];
+    m_arc_offsets = new long long[m_vertex_count + 1];
+    m_bytes = new unsigned char[byte_count > 0 ? byte_count : 1];
+    for (int i = 0; i <= m_vertex_count; ++i) {
+      m_byte_offsets[i] = other.m_byte_offsets[i];
+      m_arc_offsets[i] = other.m_arc_offsets[i];
+    }
+    for (long long i = 0; i < byte_count; ++i) {
+      m_bytes[i] = other.m_bytes[i];
+    }
+    if (other.m_weights) {
+      m_weights = new E[m_edge_count > 0 ? m_edge_count : 1];
+      for (long long i = 0; i < m_edge_count; ++i) {
+        m_weights[i] = other.m_weights[i];
+      }
+    }
+  }
+
+  return *this;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 对 m_arc_offsets 划分好的各邻接段编码。第一遍并行统计每个顶点编码后的字节数，
+ *          求前缀和后第二遍并行编码；邻接段不要求有序，编码时按邻接顶点升序排列，权值随之调整顺序
+ * @tparam E
+ * @param  targets 邻接顶点，第 v 段为 [m_arc_offsets[v], m_arc_offsets[v + 1])
+ * @param  weights 与 targets 对应的权值，为 nullptr 时不保存权值
+ * @param  with_weights 是否保存权值
+ * *****************************************************************
+ */
+template <typename E>
+inline void CompressedGraph<E>::HelpEncodeSegments(const int *targets, const E *weights, bool with_weights) {
+  const int n = m_vertex_count;
+  m_byte_offsets = new long long[n + 1];
+
+  int max_degree = 0;
+  for (int v = 0; v < n; ++v) {
+    max_degree = std::max(max_degree, static_cast<int>(m_arc_offsets[v + 1] - m_arc_offsets[v]));
+  }
+
+  for (int pass = 0; pass < 2; ++pass) {
+#pragma omp parallel
+    {
+      // 每个线程一份排序用的下标数组
+      int *order = new int[max_degree > 0 ? max_degree : 1];
+
+#pragma omp for schedule(dynamic, 1024)
+      for (int v = 0; v < n; ++v) {
+        const int *segment = targets + m_arc_offsets[v];
+        int degree = static_cast<int>(m_arc_offsets[v + 1] - m_arc_offsets[v]);
+        HelpSortSegment(segment, degree, order);
+
+        unsigned char *out = pass == 0 ? nullptr : m_bytes + m_byte_offsets[v];
+        long long size = 0;
+        int prev = v;
+        for (int k = 0; k < degree; ++k) {
+          int dest = segment[order[k]];
+          unsigned long long value;
+          if (k == 0) {
+            long long delta = static_cast<long long>(dest) - prev;
+            value = (static_cast<unsigned long long>(delta) << 1) ^ static_cast<unsigned long long>(delta >> 63);
+          } else {
+            value = static_cast<unsigned long long>(dest - prev);
+          }
+          prev = dest;
+
+          if (pass == 0) {
+            size += HelpVarintSize(value);
+          } else {
+            out = HelpEncode(value, out);
+            if (m_weights) {
+              m_weights[m_arc_offsets[v] + k] = weights[m_arc_offsets[v] + order[k]];
+            }
+          }
+        }
+        if (pass == 0) {
+          m_byte_offsets[v + 1] = size;
+        }
+      }
+
+      delete[] order;
+    }
+
+    if (pass == 0) {
+      // 字节数的前缀和
+      m_byte_offsets[0] = 0;
+      for (int v = 0; v < n; ++v) {
+        m_byte_offsets[v + 1] += m_byte_offsets[v];
+      }
+      long long byte_count = m_byte_offsets[n];
+      m_bytes = new unsigned char[byte_count > 0 ? byte_count : 1];
+      if (with_weights && weights != nullptr) {
+        m_weights = new E[m_edge_count > 0 ? m_edge_count : 1];
+      }
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 由 CSR 快照构建，CSR 的邻接段不要求有序
+ * @tparam E
+ * @param  csr
+ * @param  with_weights 是否保存权值
+ * *****************************************************************
+ */
+template <typename E>
+inline void CompressedGraph<E>::Build(const CSRGraph<E> &csr, bool with_weights) {
+  Clear();
+
+  const int n = csr.GetVertexCount();
+  const int *offsets = csr.GetOffsets();
+
+  m_vertex_count = n;
+  m_edge_count = csr.GetEdgeCount();
+  m_arc_offsets = new long long[n + 1];
+  for (int v = 0; v <= n; ++v) {
+    m_arc_offsets[v] = offsets[v];
+  }
+
+  HelpEncodeSegments(csr.GetTargets(), csr.GetWeights(), with_weights);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 由 64 位偏移的邻接数组构建，弧的总数可以超过 int 的范围，每个顶点的度不能超过。
+ *          邻接段不要求有序，无向图每条边在两端各给一次。先整体检查，出错时图不变
+ * @tparam E
+ * @param  vertex_count 顶点数
+ * @param  offsets 第 v 个顶点的邻接段为 [offsets[v], offsets[v + 1])，长度 vertex_count + 1，offsets[0] 为 0
+ * @param  targets 邻接顶点
+ * @param  weights 与 targets 对应的权值，为 nullptr 时不保存权值
+ * @return true
+ * @return false 偏移不是从 0 开始单调不减，或度超过 int 的范围，或邻接顶点越界
+ * *****************************************************************
+ */
+template <typename E>
+inline bool CompressedGraph<E>::Build(int vertex_count, const long long *offsets, const int *targets, const E *weights) {
+  if (vertex_count < 0 || offsets[0] != 0) {
+    return false;
+  }
+  for (int v = 0; v < vertex_count; ++v) {
+    long long degree = offsets[v + 1] - offsets[v];
+    if (degree < 0 || degree > INT_MAX) {
+      return false;
+    }
+  }
+
+  const long long edge_count = offsets[vertex_count];
+  bool valid = true;
+#pragma omp parallel for reduction(&& : valid) schedule(static)
+  for (long long k = 0; k < edge_count; ++k) {
+    valid = valid && targets[k] >= 0 && targets[k] < vertex_count;
+  }
+  if (!valid) {
+    return false;
+  }
+
+  Clear();
+  m_vertex_count = vertex_count;
+  m_edge_count = edge_count;
+  m_arc_offsets = new long long[vertex_count + 1];
+  std::copy(offsets, offsets + vertex_count + 1, m_arc_offsets);
+  HelpEncodeSegments(targets, weights, true);
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 由按源顶点有序的弧数组构建，例如边表文件按源顶点排序后顺序读入的结果。一遍扫描得到 64 位偏移，
+ *          不需要先建立邻接表或 CSR 快照；同一源顶点的弧不要求按目标顶点有序。先整体检查，出错时图不变
+ * @tparam E
+ * @param  vertex_count 顶点数
+ * @param  srcs 弧的源顶点，单调不减
+ * @param  dests 弧的目标顶点
+ * @param  weights 弧的权值，为 nullptr 时不保存权值
+ * @param  count 弧的数量，无向图每条边两个方向各算一条
+ * @return true
+ * @return false 顶点越界，或源顶点无序，或某个顶点的度超过 int 的范围
+ * *****************************************************************
+ */
+template <typename E>
+inline bool CompressedGraph<E>::Build(int vertex_count, const int *srcs, const int *dests, const E *weights,
+                                      long long count) {
+  if (vertex_count < 0 || count < 0) {
+    return false;
+  }
+
+  bool valid = true;
+#pragma omp parallel for reduction(&& : valid) schedule(static)
+  for (long long k = 0; k < count; ++k) {
+    valid = valid && srcs[k] >= 0 && srcs[k] < vertex_count && dests[k] >= 0 && dests[k] < vertex_count &&
+            (k == 0 || srcs[k - 1] <= srcs[k]);
+  }
+  if (!valid) {
+    return false;
+  }
+
+  // 第 k 条弧是源顶点 s 的第一条弧时，上一个源顶点之后到 s 为止的各顶点都从 k 开始
+  long long *offsets = new long long[vertex_count + 1];
+  int previous = -1;
+  for (long long k = 0; k < count; ++k) {
+    for (int v = previous + 1; v <= srcs[k]; ++v) {
+      offsets[v] = k;
+    }
+    previous = srcs[k];
+  }
+  for (int v = previous + 1; v <= vertex_count; ++v) {
+    offsets[v] = count;
+  }
+  for (int v = 0; v < vertex_count; ++v) {
+    if (offsets[v + 1] - offsets[v] > INT_MAX) {
+      delete[] offsets;
+      return false;
+    }
+  }
+
+  Clear();
+  m_vertex_count = vertex_count;
+  m_edge_count = count;
+  m_arc_offsets = offsets;
+  HelpEncodeSegments(dests, weights, true);
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 释放存储空间
+ * @tparam E
+ * *****************************************************************
+ */
+template <typename E>
+inline void CompressedGraph<E>::Clear() {
+  delete[] m_byte_offsets;
+  delete[] m_arc_offsets;
+  delete[] m_bytes;
+  delete[] m_weights;
+  m_byte_offsets = nullptr;
+  m_arc_offsets = nullptr;
+  m_bytes = nullptr;
+  m_weights = nullptr;
+  m_vertex_count = 0;
+  m_edge_count = 0;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 把邻接顶点整段解码到数组，批量处理邻居时比逐个调用回调少了间接调用
+ * @tparam E
+ * @param  vertex
+ * @param  neighbors 输出邻接顶点，长度至少为顶点的度
+ * @return int 邻接顶点个数
+ * *****************************************************************
+ */
+template <typename E>
+inline int CompressedGraph<E>::DecodeNeighbors(int vertex, int *neighbors) const {
+  const unsigned char *pos = m_bytes + m_byte_offsets[vertex];
+  const unsigned char *end = m_bytes + m_byte_offsets[vertex + 1];
+  int count = 0;
+  int prev = vertex;
+  while (pos < end) {
+    unsigned long long value = *pos++;
+    if (value & 0x80) {
+      value &= 0x7F;
+      int shift = 7;
+      unsigned char byte;
+      do {
+        byte = *pos++;
+        value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+        shift += 7;
+      } while (byte & 0x80);
+    }
+
+    if (count == 0) {
+      long long delta = static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+      prev = static_cast<int>(prev + delta);
+    } else {
+      prev += static_cast<int>(value);
+    }
+    neighbors[count++] = prev;
+  }
+
+  return count;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 依次以 (邻接顶点, 权值) 调用 visit，不存权值时权值为 E()
+ * @tparam E
+ * @tparam F 可调用对象，形如 void(int dest, const E &weight)
+ * @param  vertex
+ * @param  visit
+ * *****************************************************************
+ */
+template <typename E>
+template <typename F>
+inline void CompressedGraph<E>::ForEachNeighbor(int vertex, F visit) const {
+  NeighborCursor cursor(*this, vertex);
+  int dest;
+  E weight;
+  while (cursor.Next(dest, weight)) {
+    visit(dest, weight);
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 深度优先遍历，只访问从起始顶点可达的顶点。用显式栈保存每层的解码游标，
+ *          访问顺序与递归版本相同，大图上也不会栈溢出
+ * @tparam E
+ * @param  start_vertex
+ * @param  visit 自定义处理顶点的函数
+ * *****************************************************************
+ */
+template <typename E>
+inline void CompressedGraph<E>::DepthFirstSearch(int start_vertex, void (*visit)(int vertex)) const {
+  // 检查起始顶点是否合法
+  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
+    return; // 非法的起始顶点
+  }
+
+  bool *visited = new bool[m_vertex_count];
+  for (int i = 0; i < m_vertex_count; ++i) {
+    visited[i] = false;
+  }
+  // 每个顶点至多入栈一次
+  NeighborCursor *stack = new NeighborCursor[m_vertex_count];
+  int top = 0;
+
+  visited[start_vertex] = true;
+  visit(start_vertex);
+  stack[top++] = NeighborCursor(*this, start_vertex);
+
+  while (top > 0) {
+    int dest;
+    if (!stack[top - 1].Next(dest)) {
+      --top;
+      continue;
+    }
+    if (!visited[dest]) {
+      visited[dest] = true;
+      visit(dest);
+      stack[top++] = NeighborCursor(*this, dest);
+    }
+  }
+
+  delete[] stack;
+  delete[] visited;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 广度优先遍历，从起始顶点开始，之后依次从未访问的顶点开始，保证每个连通分量都被访问
+ * @tparam E
+ * @param  start_vertex
+ * @param  visit 自定义处理顶点的函数
+ * *****************************************************************
+ */
+template <typename E>
+inline void CompressedGraph<E>::BreadthFirstSearch(int start_vertex, void (*visit)(int vertex)) const {
+  // 检查起始顶点是否合法
+  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
+    return; // 非法的起始顶点
+  }
+
+  bool *visited = new bool[m_vertex_count];
+  for (int i = 0; i < m_vertex_count; ++i) {
+    visited[i] = false;
+  }
+  SeqQueue<int> vertex_queue(m_vertex_count + 1);
+
+  for (int i = 0; i < m_vertex_count; ++i) {
+    int root = (start_vertex + i) % m_vertex_count;
+    if (visited[root]) {
+      continue;
+    }
+
+    visited[root] = true;
+    vertex_queue.EnQueue(root);
+    while (!vertex_queue.IsEmpty()) {
+      int current_vertex;
+      vertex_queue.DeQueue(current_vertex);
+      visit(current_vertex);
+
+      NeighborCursor cursor(*this, current_vertex);
+      int dest;
+      while (cursor.Next(dest)) {
+        if (!visited[dest]) {
+          visited[dest] = true;
+          vertex_queue.EnQueue(dest);
+        }
+      }
+    }
+  }
+
+  delete[] visited;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 占用的字节数，不含对象本身
+ * @tparam E
+ * @return long long
+ * *****************************************************************
+ */
+template <typename E>
+inline long long CompressedGraph<E>::GetMemoryBytes() const {
+  if (m_byte_offsets == nullptr) {
+    return 0;
+  }
+  long long bytes = 2 * static_cast<long long>(m_vertex_count + 1) * sizeof(long long) + m_byte_offsets[m_vertex_count];
+  if (m_weights) {
+    bytes += m_edge_count * static_cast<long long>(sizeof(E));
+  }
+  return bytes;
+}
+
+} // namespace bu_tools
+
+#endif // _COMPRESSEDGRAPH_H_
@@ -0,0 +1,589 @@
+/**
+ * ************************************************************************
+ * @filename: csrgraph.h
+ *
+ * @brief : 图的压缩稀疏行（CSR）快照
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-10
+ *
+ * ************************************************************************
+ */
+
+#ifndef _CSRGRAPH_H_
+#define _CSRGRAPH_H_
+
+#include "../queue/seqqueue/seqqueue.h"
+#include <algorithm>
+
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 顶点重排的方式
+ * *****************************************************************
+ */
+enum class VertexOrder {
+  BreadthFirst,        // 广度优先的访问顺序
+  DegreeDescending,    // 度数从大到小
+  ReverseCuthillMcKee, // 逆 Cuthill-McKee，压缩带宽
+};
+
+/**
+ * *****************************************************************
+ * @brief : 图的 CSR 快照：顶点 v 的邻接顶点存放在 m_targets[m_offsets[v], m_offsets[v + 1]) 中，
+ *          与邻接表相比没有指针，适合只读的批量计算
+ * @tparam E 权值
+ * *****************************************************************
+ */
+template <typename E>
+class CSRGraph {
+  /*****************************************************************
+
+  数据域
+
+  *****************************************************************/
+protected:
+  int m_vertex_count; // 顶点数量
+  int m_edge_count;   // 弧的数量（无向图每条边占两条弧）
+  int *m_offsets;     // 每个顶点邻接段的起始位置，长度 m_vertex_count + 1
+  int *m_targets;     // 邻接顶点
+  E *m_weights;       // 与 m_targets 一一对应的权值
+
+  /*****************************************************************
+
+  成员函数的声明
+
+  *****************************************************************/
+public:
+  CSRGraph() : m_vertex_count(0), m_edge_count(0), m_offsets(nullptr), m_targets(nullptr), m_weights(nullptr) {}
+  CSRGraph(const CSRGraph &other);
+  CSRGraph &operator=(const CSRGraph &other);
+
+  //移动构造函数
+  CSRGraph(CSRGraph &&other) noexcept : m_vertex_count(other.m_vertex_count), m_edge_count(other.m_edge_count),
+                                         m_offsets(other.m_offsets), m_targets(other.m_targets), m_weights(other.m_weights) {
+    other.m_vertex_count = 0;
+    other.m_edge_count = 0;
+    other.m_offsets = nullptr;
+    other.m_targets = nullptr;
+    other.m_weights = nullptr;
+  }
+
+  virtual ~CSRGraph() {
+    Clear();
+  }
+
+  void Resize(int vertex_count, int edge_count); // 重新分配存储空间，内容未初始化
+  void Build(int vertex_count, const int *srcs, const int *dests, const E *weights, int count); // 由弧的数组构建
+  void Transpose(CSRGraph &result) const;        // 求所有弧反向后的图
+  void SortNeighbors();                          // 每个顶点的邻接顶点按索引升序排列
+  void Clear();                                  // 释放存储空间
+
+  // 顶点重排
+  void ComputeOrder(VertexOrder order, int *permutation) const; // 计算重排，permutation[旧索引] = 新索引
+
+  // 二分图
+  bool Bipartition(bool *is_left) const;                 // 二染色，求二分图的两部分
+  int HopcroftKarp(const bool *is_left, int *mate) const; // 最大匹配
+
+  int GetVertexCount() const { return m_vertex_count; }
+  int GetEdgeCount() const { return m_edge_count; }
+  int GetDegree(int vertex) const { return m_offsets[vertex + 1] - m_offsets[vertex]; }
+  const int *GetNeighbors(int vertex) const { return m_targets + m_offsets[vertex]; }
+  const E *GetWeights(int vertex) const { return m_weights + m_offsets[vertex]; }
+
+  // 直接访问底层数组，供构建者填充
+  int *GetOffsets() { return m_offsets; }
+  int *GetTargets() { return m_targets; }
+  E *GetWeights() { return m_weights; }
+  const int *GetOffsets() const { return m_offsets; }
+  const int *GetTargets() const { return m_targets; }
+  const E *GetWeights() const { return m_weights; }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+成员函数的定义
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * *****************************************************************
+ * @brief : Construct a new CSRGraph< E>:: CSRGraph object
+ * @tparam E
+ * @param  other
+ * *****************************************************************
+ */
+template <typename E>
+inline CSRGraph<E>::CSRGraph(const CSRGraph &other) : m_vertex_count(0), m_edge_count(0), m_offsets(nullptr), m_targets(nullptr), m_weights(nullptr) {
+  *this = other;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 重载赋值运算符
+ * @tparam E
+ * @param  other
+ * @return CSRGraph<E>&
+ * *****************************************************************
+ */
+template <typename E>
+inline CSRGraph<E> &CSRGraph<E>::operator=(const CSRGraph &other) {
+  if (this != &other) {
+    Resize(other.m_vertex_count, other.m_edge_count);
+    for (int i = 0; i <= m_vertex_count; ++i) {
+      m_offsets[i] = other.m_offsets[i];
+    }
+    for (int i = 0; i < m_edge_count; ++i) {
+      m_targets[i] = other.m_targets[i];
+      m_weights[i] = other.m_weights[i];
+    }
+  }
+
+  return *this;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 重新分配存储空间，内容未初始化
+ * @tparam E
+ * @param  vertex_count
+ * @param  edge_count
+ * *****************************************************************
+ */
+template <typename E>
+inline void CSRGraph<E>::Resize(int vertex_count, int edge_count) {
+  Clear();
+
+  m_vertex_count = vertex_count;
+  m_edge_count = edge_count;
+  m_offsets = new int[m_vertex_count + 1];
+  m_targets = new int[m_edge_count > 0 ? m_edge_count : 1];
+  m_weights = new E[m_edge_count > 0 ? m_edge_count : 1];
+  m_offsets[0] = 0;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 由弧的数组构建，按源顶点计数排序，同一源顶点的弧保持输入顺序
+ * @tparam E
+ * @param  vertex_count
+ * @param  srcs
+ * @param  dests
+ * @param  weights
+ * @param  count
+ * *****************************************************************
+ */
+template <typename E>
+inline void CSRGraph<E>::Build(int vertex_count, const int *srcs, const int *dests, const E *weights, int count) {
+  Resize(vertex_count, count);
+
+  for (int i = 0; i <= m_vertex_count; ++i) {
+    m_offsets[i] = 0;
+  }
+  for (int i = 0; i < count; ++i) {
+    ++m_offsets[srcs[i] + 1];
+  }
+  for (int i = 1; i <= m_vertex_count; ++i) {
+    m_offsets[i] += m_offsets[i - 1];
+  }
+
+  // 借用 position 记录每个顶点下一个写入位置
+  int *position = new int[m_vertex_count > 0 ? m_vertex_count : 1];
+  for (int i = 0; i < m_vertex_count; ++i) {
+    position[i] = m_offsets[i];
+  }
+  for (int i = 0; i < count; ++i) {
+    int pos = position[srcs[i]]++;
+    m_targets[pos] = dests[i];
+    m_weights[pos] = weights[i];
+  }
+
+  delete[] position;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 求所有弧反向后的图，即每个顶点的入边邻接段，计数排序，线性时间
+ * @tparam E
+ * @param  result
+ * *****************************************************************
+ */
+template <typename E>
+inline void CSRGraph<E>::Transpose(CSRGraph &result) const {
+  result.Resize(m_vertex_count, m_edge_count);
+
+  int *offsets = result.m_offsets;
+  for (int i = 0; i <= m_vertex_count; ++i) {
+    offsets[i] = 0;
+  }
+  for (int i = 0; i < m_edge_count; ++i) {
+    ++offsets[m_targets[i] + 1];
+  }
+  for (int i = 1; i <= m_vertex_count; ++i) {
+    offsets[i] += offsets[i - 1];
+  }
+
+  int *position = new int[m_vertex_count > 0 ? m_vertex_count : 1];
+  for (int i = 0; i < m_vertex_count; ++i) {
+    position[i] = offsets[i];
+  }
+
+  // 按源顶点顺序扫描，反向后每个邻接段天然升序
+  for (int u = 0; u < m_vertex_count; ++u) {
+    for (int k = m_offsets[u]; k < m_offsets[u + 1]; ++k) {
+      int pos = position[m_targets[k]]++;
+      result.m_targets[pos] = u;
+      result.m_weights[pos] = m_weights[k];
+    }
+  }
+
+  delete[] position;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 每个顶点的邻接顶点按索引升序排列，权值随之移动
+ * @tparam E
+ * *****************************************************************
+ */
+template <typename E>
+inline void CSRGraph<E>::SortNeighbors() {
+  // 两次转置即可得到有序的邻接段，线性时间
+  CSRGraph transposed;
+  Transpose(transposed);
+  transposed.Transpose(*this);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 计算顶点重排，弧当作无向边处理（出边和入边都算邻居），让相邻的顶点编号也相近
+ * @tparam E
+ * @param  order 重排方式
+ * @param  permutation 输出 permutation[旧索引] = 新索引
+ * *****************************************************************
+ */
+template <typename E>
+inline void CSRGraph<E>::ComputeOrder(VertexOrder order, int *permutation) const {
+  const int n = m_vertex_count;
+  if (n == 0) {
+    return;
+  }
+
+  CSRGraph transposed;
+  Transpose(transposed);
+  const int *in_offsets = transposed.m_offsets;
+  const int *in_targets = transposed.m_targets;
+
+  int *degree = new int[n];
+  for (int v = 0; v < n; ++v) {
+    degree[v] = m_offsets[v + 1] - m_offsets[v] + in_offsets[v + 1] - in_offsets[v];
+  }
+
+  int *sequence = new int[n]; // sequence[新索引] = 旧索引
+  if (order == VertexOrder::DegreeDescending) {
+    for (int v = 0; v < n; ++v) {
+      sequence[v] = v;
+    }
+    std::stable_sort(sequence, sequence + n, [degree](int a, int b) { return degree[a] > degree[b]; });
+  } else {
+    bool is_rcm = order == VertexOrder::ReverseCuthillMcKee;
+    int *level = new int[n];  // 寻找伪外围顶点时的层次
+    bool *visited = new bool[n];
+    for (int v = 0; v < n; ++v) {
+      visited[v] = false;
+      level[v] = -1;
+    }
+
+    int count = 0;
+    for (int start = 0; start < n; ++start) {
+      if (visited[start]) {
+        continue;
+      }
+
+      int root = start;
+      if (is_rcm) {
+        // 伪外围顶点：反复从最远层中度数最小的顶点出发做广度优先，直到离心率不再增大
+        int eccentricity = -1;
+        for (int round = 0; round < 8; ++round) {
+          int head = count, tail = count;
+          sequence[tail++] = root;
+          level[root] = 0;
+          while (head < tail) {
+            int u = sequence[head++];
+            for (int pass = 0; pass < 2; ++pass) {
+              const int *offsets = pass == 0 ? m_offsets : in_offsets;
+              const int *targets = pass == 0 ? m_targets : in_targets;
+              for (int k = offsets[u]; k < offsets[u + 1]; ++k) {
+                int v = targets[k];
+                if (level[v] == -1) {
+                  level[v] = level[u] + 1;
+                  sequence[tail++] = v;
+                }
+              }
+            }
+          }
+
+          int depth = level[sequence[tail - 1]];
+          int candidate = root;
+          for (int i = tail - 1; i >= count && level[sequence[i]] == depth; --i) {
+            if (degree[sequence[i]] < degree[candidate] || candidate == root) {
+              candidate = sequence[i];
+            }
+          }
+          for (int i = count; i < tail; ++i) {
+            level[sequence[i]] = -1;
+          }
+
+          if (depth <= eccentricity) {
+            break;
+          }
+          eccentricity = depth;
+          root = candidate;
+        }
+      }
+
+      // 广度优先编号，RCM 中邻居按度数从小到大入队
+      int head = count;
+      sequence[count++] = root;
+      visited[root] = true;
+      while (head < count) {
+        int u = sequence[head++];
+        int first = count;
+        for (int pass = 0; pass < 2; ++pass) {
+          const int *offsets = pass == 0 ? m_offsets : in_offsets;
+          const int *targets = pass == 0 ? m_targets : in_targets;
+          for (int k = offsets[u]; k < offsets[u + 1]; ++k) {
+            int v = targets[k];
+            if (!visited[v]) {
+              visited[v] = true;
+              sequence[count++] = v;
+            }
+          }
+        }
+        if (is_rcm) {
+          std::sort(sequence + first, sequence + count, [degree](int a, int b) {
+            return degree[a] < degree[b] || (degree[a] == degree[b] && a < b);
+          });
+        }
+      }
+    }
+
+    if (is_rcm) {
+      std::reverse(sequence, sequence + n);
+    }
+
+    delete[] level;
+    delete[] visited;
+  }
+
+  for (int i = 0; i < n; ++i) {
+    permutation[sequence[i]] = i;
+  }
+
+  delete[] sequence;
+  delete[] degree;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 二染色，把弧当作无向边处理
+ * @tparam E
+ * @param  is_left 输出每个顶点所在的一侧
+ * @return true
+ * @return false 存在奇环，不是二分图
+ * *****************************************************************
+ */
+template <typename E>
+inline bool CSRGraph<E>::Bipartition(bool *is_left) const {
+  const int n = m_vertex_count;
+  int *color = new int[n > 0 ? n : 1];
+  for (int i = 0; i < n; ++i) {
+    color[i] = -1;
+  }
+
+  SeqQueue<int> vertex_queue(n + 1);
+  bool is_bipartite = true;
+  for (int start = 0; start < n && is_bipartite; ++start) {
+    if (color[start] != -1) {
+      continue;
+    }
+    color[start] = 0;
+    vertex_queue.EnQueue(start);
+    while (!vertex_queue.IsEmpty()) {
+      int u;
+      vertex_queue.DeQueue(u);
+      for (int k = m_offsets[u]; k < m_offsets[u + 1]; ++k) {
+        int v = m_targets[k];
+        if (color[v] == -1) {
+          color[v] = 1 - color[u];
+          vertex_queue.EnQueue(v);
+        } else if (color[v] == color[u]) {
+          is_bipartite = false;
+        }
+      }
+    }
+  }
+
+  for (int i = 0; i < n; ++i) {
+    is_left[i] = color[i] == 0;
+  }
+
+  delete[] color;
+  return is_bipartite;
+}
+
+/**
+ * *****************************************************************
+ * @brief : Hopcroft-Karp 最大匹配：每轮先从左侧未匹配顶点广度优先分层，
+ *          再沿层次用显式栈深度优先找一组互不相交的最短增广路
+ * @tparam E
+ * @param  is_left 每个顶点是否在左侧，只使用左侧顶点的邻接段
+ * @param  mate 输出每个顶点匹配到的顶点，未匹配为 -1
+ * @return int 匹配的边数
+ * *****************************************************************
+ */
+template <typename E>
+inline int CSRGraph<E>::HopcroftKarp(const bool *is_left, int *mate) const {
+  const int n = m_vertex_count;
+  const int INF = n + 1;
+  for (int i = 0; i < n; ++i) {
+    mate[i] = -1;
+  }
+
+  // 先贪心匹配，减少增广的轮数
+  int matching = 0;
+  for (int u = 0; u < n; ++u) {
+    if (!is_left[u]) {
+      continue;
+    }
+    for (int k = m_offsets[u]; k < m_offsets[u + 1]; ++k) {
+      int v = m_targets[k];
+      if (!is_left[v] && mate[v] == -1) {
+        mate[u] = v;
+        mate[v] = u;
+        ++matching;
+        break;
+      }
+    }
+  }
+
+  int *dist = new int[n > 0 ? n : 1];        // 左侧顶点的层次
+  int *current_arc = new int[n > 0 ? n : 1]; // 深度优先时每个左侧顶点下一条待试的弧
+  int *stack = new int[n > 0 ? n : 1];       // 增广路上的左侧顶点
+  int *via = new int[n > 0 ? n : 1];         // 栈中每个左侧顶点选择的右侧顶点
+  int *queue = new int[n > 0 ? n : 1];
+
+  while (true) {
+    // 广度优先分层
+    int head = 0, tail = 0;
+    for (int u = 0; u < n; ++u) {
+      if (is_left[u] && mate[u] == -1) {
+        dist[u] = 0;
+        queue[tail++] = u;
+      } else {
+        dist[u] = INF;
+      }
+    }
+
+    bool found = false;
+    while (head < tail) {
+      int u = queue[head++];
+      for (int k = m_offsets[u]; k < m_offsets[u + 1]; ++k) {
+        int v = m_targets[k];
+        if (is_left[v]) {
+          continue;
+        }
+        int w = mate[v];
+        if (w == -1) {
+          found = true;
+        } else if (dist[w] == INF) {
+          dist[w] = dist[u] + 1;
+          queue[tail++] = w;
+        }
+      }
+    }
+
+    if (!found) {
+      break;
+    }
+
+    // 深度优先找增广路
+    for (int u = 0; u < n; ++u) {
+      current_arc[u] = m_offsets[u];
+    }
+
+    for (int root = 0; root < n; ++root) {
+      if (!is_left[root] || mate[root] != -1) {
+        continue;
+      }
+
+      int top = 0;
+      stack[0] = root;
+      while (top >= 0) {
+        int x = stack[top];
+        if (current_arc[x] == m_offsets[x + 1]) {
+          dist[x] = INF; // 从 x 出发找不到增广路，本轮不再访问
+          --top;
+          continue;
+        }
+
+        int v = m_targets[current_arc[x]++];
+        if (is_left[v]) {
+          continue;
+        }
+
+        int w = mate[v];
+        if (w == -1) {
+          // 找到增广路，沿栈翻转匹配
+          via[top] = v;
+          for (int i = 0; i <= top; ++i) {
+            mate[stack[i]] = via[i];
+            mate[via[i]] = stack[i];
+          }
+          ++matching;
+          break;
+        }
+
+        if (dist[w] == dist[x] + 1) {
+          via[top] = v;
+          stack[++top] = w;
+        }
+      }
+    }
+  }
+
+  delete[] dist;
+  delete[] current_arc;
+  delete[] stack;
+  delete[] via;
+  delete[] queue;
+
+  return matching;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 释放存储空间
+ * @tparam E
+ * *****************************************************************
+ */
+template <typename E>
+inline void CSRGraph<E>::Clear() {
+  delete[] m_offsets;
+  delete[] m_targets;
+  delete[] m_weights;
+  m_offsets = nullptr;
+  m_targets = nullptr;
+  m_weights = nullptr;
+  m_vertex_count = 0;
+  m_edge_count = 0;
+}
+
+} // namespace bu_tools
+
+#endif // _CSRGRAPH_H_
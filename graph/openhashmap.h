@@ -0,0 +1,377 @@
+/**
+ * ************************************************************************
+ * @filename: openhashmap.h
+ *
+ * @brief : 开放定址哈希表（线性探测）
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-08
+ *
+ * ************************************************************************
+ */
+
+#ifndef _OPENHASHMAP_H_
+#define _OPENHASHMAP_H_
+
+#include <cstddef>
+#include <functional>
+
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 开放定址哈希表，线性探测，删除时后移填补，不留墓碑
+ * @tparam K 键
+ * @tparam V 值
+ * @tparam H 键的哈希函数
+ * *****************************************************************
+ */
+template <typename K, typename V, typename H = std::hash<K>>
+class OpenHashMap {
+  /*****************************************************************
+
+  数据域
+
+  *****************************************************************/
+protected:
+  K *m_keys;      // 键数组
+  V *m_values;    // 值数组
+  bool *m_used;   // 槽位是否被占用
+  int m_capacity; // 槽位个数，始终是 2 的幂
+  int m_size;     // 键值对个数
+  H m_hasher;     // 哈希函数
+
+  /*****************************************************************
+
+  成员函数的声明
+
+  *****************************************************************/
+private:
+  int Slot(const K &key) const;
+  void Rehash(int new_capacity);
+
+public:
+  OpenHashMap(int capacity = 16) : m_capacity(16), m_size(0) {
+    while (m_capacity < capacity) {
+      m_capacity *= 2;
+    }
+    m_keys = new K[m_capacity];
+    m_values = new V[m_capacity];
+    m_used = new bool[m_capacity];
+    for (int i = 0; i < m_capacity; ++i) {
+      m_used[i] = false;
+    }
+  }
+  OpenHashMap(const OpenHashMap &other);
+  OpenHashMap &operator=(const OpenHashMap &other);
+  virtual ~OpenHashMap() {
+    delete[] m_keys;
+    delete[] m_values;
+    delete[] m_used;
+  }
+
+  void Reserve(int size);                     // 预留空间
+  bool Insert(const K &key, const V &value);  // 插入，键已存在时更新值
+  bool Find(const K &key, V &value) const;    // 查找
+  bool Contains(const K &key) const;          // 是否存在
+  bool Remove(const K &key);                  // 删除
+  int GetSize() const;                        // 键值对个数
+  void Clear();                               // 置空，保留槽位数组
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+成员函数的定义
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * *****************************************************************
+ * @brief : 计算键的起始槽位，对哈希值再做一次乘法散列，避免整数键的哈希值过于集中
+ * @tparam K
+ * @tparam V
+ * @tparam H
+ * @param  key
+ * @return int
+ * *****************************************************************
+ */
+template <typename K, typename V, typename H>
+inline int OpenHashMap<K, V, H>::Slot(const K &key) const {
+  unsigned long long hash = static_cast<unsigned long long>(m_hasher(key));
+  hash *= 0x9E3779B97F4A7C15ULL;
+  return static_cast<int>((hash >> 32) & static_cast<unsigned long long>(m_capacity - 1));
+}
+
+/**
+ * *****************************************************************
+ * @brief : 扩容并重新散列
+ * @tparam K
+ * @tparam V
+ * @tparam H
+ * @param  new_capacity
+ * *****************************************************************
+ */
+template <typename K, typename V, typename H>
+inline void OpenHashMap<K, V, H>::Rehash(int new_capacity) {
+  K *old_keys = m_keys;
+  V *old_values = m_values;
+  bool *old_used = m_used;
+  int old_capacity = m_capacity;
+
+  m_capacity = new_capacity;
+  m_keys = new K[m_capacity];
+  m_values = new V[m_capacity];
+  m_used = new bool[m_capacity];
+  for (int i = 0; i < m_capacity; ++i) {
+    m_used[i] = false;
+  }
+
+  for (int i = 0; i < old_capacity; ++i) {
+    if (old_used[i]) {
+      int slot = Slot(old_keys[i]);
+      while (m_used[slot]) {
+        slot = (slot + 1) & (m_capacity - 1);
+      }
+      m_keys[slot] = old_keys[i];
+      m_values[slot] = old_values[i];
+      m_used[slot] = true;
+    }
+  }
+
+  delete[] old_keys;
+  delete[] old_values;
+  delete[] old_used;
+}
+
+/**
+ * *****************************************************************
+ * @brief : Construct a new Open Hash Map< K, V, H>:: Open Hash Map object
+ * @tparam K
+ * @tparam V
+ * @tparam H
+ * @param  other
+ * *****************************************************************
+ */
+template <typename K, typename V, typename H>
+inline OpenHashMap<K, V, H>::OpenHashMap(const OpenHashMap &other) : m_capacity(other.m_capacity), m_size(other.m_size), m_hasher(other.m_hasher) {
+  m_keys = new K[m_capacity];
+  m_values = new V[m_capacity];
+  m_used = new bool[m_capacity];
+  for (int i = 0; i < m_capacity; ++i) {
+    m_used[i] = other.m_used[i];
+    if (m_used[i]) {
+      m_keys[i] = other.m_keys[i];
+      m_values[i] = other.m_values[i];
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 重载赋值运算符
+ * @tparam K
+ * @tparam V
+ * @tparam H
+ * @param  other
+ * @return OpenHashMap<K, V, H>&
+ * *****************************************************************
+ */
+template <typename K, typename V, typename H>
+inline OpenHashMap<K, V, H> &OpenHashMap<K, V, H>::operator=(const OpenHashMap &other) {
+  if (this != &other) {
+    delete[] m_keys;
+    delete[] m_values;
+    delete[] m_used;
+
+    m_capacity = other.m_capacity;
+    m_size = other.m_size;
+    m_hasher = other.m_hasher;
+
+    m_keys = new K[m_capacity];
+    m_values = new V[m_capacity];
+    m_used = new bool[m_capacity];
+    for (int i = 0; i < m_capacity; ++i) {
+      m_used[i] = other.m_used[i];
+      if (m_used[i]) {
+        m_keys[i] = other.m_keys[i];
+        m_values[i] = other.m_values[i];
+      }
+    }
+  }
+
+  return *this;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 预留空间，保证装入 size 个键后装载因子不超过 1/2
+ * @tparam K
+ * @tparam V
+ * @tparam H
+ * @param  size
+ * *****************************************************************
+ */
+template <typename K, typename V, typename H>
+inline void OpenHashMap<K, V, H>::Reserve(int size) {
+  int new_capacity = m_capacity;
+  while (new_capacity < 2 * size) {
+    new_capacity *= 2;
+  }
+  if (new_capacity != m_capacity) {
+    Rehash(new_capacity);
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 插入，键已存在时更新值
+ * @tparam K
+ * @tparam V
+ * @tparam H
+ * @param  key
+ * @param  value
+ * @return true 插入了新的键
+ * @return false 键已存在，只更新了值
+ * *****************************************************************
+ */
+template <typename K, typename V, typename H>
+inline bool OpenHashMap<K, V, H>::Insert(const K &key, const V &value) {
+  // 装载因子超过 1/2 时扩容
+  if (2 * (m_size + 1) > m_capacity) {
+    Rehash(m_capacity * 2);
+  }
+
+  int slot = Slot(key);
+  while (m_used[slot]) {
+    if (m_keys[slot] == key) {
+      m_values[slot] = value;
+      return false;
+    }
+    slot = (slot + 1) & (m_capacity - 1);
+  }
+
+  m_keys[slot] = key;
+  m_values[slot] = value;
+  m_used[slot] = true;
+  ++m_size;
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 查找
+ * @tparam K
+ * @tparam V
+ * @tparam H
+ * @param  key
+ * @param  value
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename K, typename V, typename H>
+inline bool OpenHashMap<K, V, H>::Find(const K &key, V &value) const {
+  int slot = Slot(key);
+  while (m_used[slot]) {
+    if (m_keys[slot] == key) {
+      value = m_values[slot];
+      return true;
+    }
+    slot = (slot + 1) & (m_capacity - 1);
+  }
+  return false;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 是否存在
+ * @tparam K
+ * @tparam V
+ * @tparam H
+ * @param  key
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename K, typename V, typename H>
+inline bool OpenHashMap<K, V, H>::Contains(const K &key) const {
+  V value;
+  return Find(key, value);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 删除，把后面同一探测序列上的键前移，保证查找不会提前中断
+ * @tparam K
+ * @tparam V
+ * @tparam H
+ * @param  key
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename K, typename V, typename H>
+inline bool OpenHashMap<K, V, H>::Remove(const K &key) {
+  int mask = m_capacity - 1;
+  int slot = Slot(key);
+  while (m_used[slot] && !(m_keys[slot] == key)) {
+    slot = (slot + 1) & mask;
+  }
+  if (!m_used[slot]) {
+    return false;
+  }
+
+  int hole = slot;
+  int next = (hole + 1) & mask;
+  while (m_used[next]) {
+    int home = Slot(m_keys[next]);
+    // home 不在 (hole, next] 区间内时，next 上的键可以前移到 hole
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      m_keys[hole] = m_keys[next];
+      m_values[hole] = m_values[next];
+      hole = next;
+    }
+    next = (next + 1) & mask;
+  }
+
+  m_used[hole] = false;
+  --m_size;
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 键值对个数
+ * @tparam K
+ * @tparam V
+ * @tparam H
+ * @return int
+ * *****************************************************************
+ */
+template <typename K, typename V, typename H>
+inline int OpenHashMap<K, V, H>::GetSize() const {
+  return m_size;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 置空，保留槽位数组
+ * @tparam K
+ * @tparam V
+ * @tparam H
+ * *****************************************************************
+ */
+template <typename K, typename V, typename H>
+inline void OpenHashMap<K, V, H>::Clear() {
+  for (int i = 0; i < m_capacity; ++i) {
+    m_used[i] = false;
+  }
+  m_size = 0;
+}
+
+} // namespace bu_tools
+
+#endif // _OPENHASHMAP_H_
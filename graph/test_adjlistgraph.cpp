@@ -15,6 +15,7 @@
 #include "adjlistgraph.h"
 #include <iomanip>
 #include <iostream>
+#include <string>
 
 // using std::cin;
 using std::cout;
@@ -30,6 +31,21 @@ void PrintPath(int start, int end, int **path);
  void test_TopologicalSort();
  void test_Prim();
 void test_Kruskal();
+void test_InsertEdges();
+void test_GetVertexIndex();
+void test_PageRank();
+void test_CountTriangles();
+void test_MaxFlow();
+void test_MaximumMatching();
+void test_Reorder();
+void test_ToCompressedGraph();
+void test_LazyRemoval();
+void test_InEdgeIndex();
+void test_EgoNetwork();
+void test_TraversalContext();
+void test_Visitor();
+void test_SetEdgeWeight();
+void test_CompressedFromEdges();
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 /*
@@ -45,6 +61,21 @@ int main(int argc, const char* argv[]) {
    //test_TopologicalSort();
   //test_Prim();
    test_Kruskal();
+  //test_InsertEdges();
+  //test_GetVertexIndex();
+  //test_PageRank();
+  //test_CountTriangles();
+  //test_MaxFlow();
+  //test_MaximumMatching();
+  //test_Reorder();
+  //test_ToCompressedGraph();
+  //test_LazyRemoval();
+  //test_InEdgeIndex();
+  //test_EgoNetwork();
+  //test_TraversalContext();
+  //test_Visitor();
+  test_SetEdgeWeight();
+  test_CompressedFromEdges();
 
   return 0;
 }
@@ -268,4 +299,547 @@ void test_Kruskal(){
     cout << "\n";
     ++index;
   }
-}
\ No newline at end of file
+}
+
+void test_InsertEdges(){
+  int vertex_count = 5;
+  bool is_directed = false;
+
+  bu_tools::AdjLsitgraph<char, int> graph(is_directed);
+
+  // 预留空间，避免插入过程中反复扩容
+  graph.ReserveVertices(vertex_count);
+  graph.ReserveEdges(6);
+
+  graph.InsertVertex('A'); // 0
+  graph.InsertVertex('B'); // 1
+  graph.InsertVertex('C'); // 2
+  graph.InsertVertex('D'); // 3
+  graph.InsertVertex('E'); // 4
+
+  // 最后两条是重复的边，会被去掉
+  int srcs[] = {0, 0, 3, 2, 1, 3, 1, 2};
+  int dests[] = {1, 2, 4, 4, 3, 2, 0, 3};
+  int weights[] = {10, 5, 2, 3, 1, 2, 10, 2};
+
+  int inserted = graph.InsertEdges(srcs, dests, weights, 8);
+  cout << "插入的边数: " << inserted << "\n";
+
+  int distance[5];
+  graph.Dijkstra(0, distance);
+
+  for (int i = 0; i < 5; i++) {
+    char vertex;
+    graph.GetVertexByIndex(i, vertex);
+    cout << vertex << "  " << distance[i] << "\n";
+  }
+}
+
+void test_GetVertexIndex(){
+  bu_tools::AdjLsitgraph<std::string, int> graph(true);
+
+  graph.InsertVertex("user-1001"); // 0
+  graph.InsertVertex("user-1002"); // 1
+  graph.InsertVertex("user-1003"); // 2
+  graph.InsertVertex("user-1004"); // 3
+
+  // 重复的顶点插入失败
+  cout << "重复插入 user-1002: " << graph.InsertVertex("user-1002") << "\n";
+
+  graph.RemoveVertex("user-1002");
+
+  const char *keys[] = {"user-1001", "user-1002", "user-1003", "user-1004"};
+  for (int i = 0; i < 4; ++i) {
+    cout << keys[i] << "  " << graph.GetVertexIndex(keys[i]) << "\n";
+  }
+}
+
+void test_PageRank(){
+  int vertex_count = 5;
+  bool is_directed = true;
+
+  bu_tools::AdjLsitgraph<char, int> graph(is_directed, vertex_count);
+
+  graph.InsertVertex('A'); // 0
+  graph.InsertVertex('B'); // 1
+  graph.InsertVertex('C'); // 2
+  graph.InsertVertex('D'); // 3
+  graph.InsertVertex('E'); // 4，没有出边的悬挂顶点
+
+  graph.InsertEdge(0, 1, 1);
+  graph.InsertEdge(0, 2, 1);
+  graph.InsertEdge(1, 2, 1);
+  graph.InsertEdge(2, 0, 1);
+  graph.InsertEdge(3, 2, 1);
+  graph.InsertEdge(2, 4, 1);
+
+  double scores[5];
+  int iteration = graph.PageRank(scores);
+  cout << "PageRank 迭代次数: " << iteration << "\n";
+  for (int i = 0; i < vertex_count; ++i) {
+    char vertex;
+    graph.GetVertexByIndex(i, vertex);
+    cout << vertex << "  " << scores[i] << "\n";
+  }
+
+  int sources[] = {3};
+  iteration = graph.PersonalizedPageRank(sources, 1, scores);
+  cout << "\n以 D 为源的个性化 PageRank 迭代次数: " << iteration << "\n";
+  for (int i = 0; i < vertex_count; ++i) {
+    char vertex;
+    graph.GetVertexByIndex(i, vertex);
+    cout << vertex << "  " << scores[i] << "\n";
+  }
+}
+
+void test_CountTriangles(){
+  int vertex_count = 5;
+  bool is_directed = false;
+
+  bu_tools::AdjLsitgraph<char, int> graph(is_directed, vertex_count);
+
+  graph.InsertVertex('A'); // 0
+  graph.InsertVertex('B'); // 1
+  graph.InsertVertex('C'); // 2
+  graph.InsertVertex('D'); // 3
+  graph.InsertVertex('E'); // 4
+
+  // A-B-C 与 A-C-D 两个三角形共用边 A-C
+  graph.InsertEdge(0, 1, 1);
+  graph.InsertEdge(1, 2, 1);
+  graph.InsertEdge(0, 2, 1);
+  graph.InsertEdge(2, 3, 1);
+  graph.InsertEdge(0, 3, 1);
+  graph.InsertEdge(3, 4, 1);
+
+  long long vertex_triangles[5];
+  double coefficients[5];
+  cout << "三角形总数: " << graph.CountTriangles(vertex_triangles) << "\n";
+  graph.ClusteringCoefficient(coefficients);
+
+  for (int i = 0; i < vertex_count; ++i) {
+    char vertex;
+    graph.GetVertexByIndex(i, vertex);
+    cout << vertex << "  " << vertex_triangles[i] << "  " << coefficients[i] << "\n";
+  }
+}
+
+void test_MaxFlow(){
+  int vertex_count = 6;
+  bool is_directed = true;
+
+  bu_tools::AdjLsitgraph<char, int> graph(is_directed, vertex_count);
+
+  graph.InsertVertex('S'); // 0
+  graph.InsertVertex('A'); // 1
+  graph.InsertVertex('B'); // 2
+  graph.InsertVertex('C'); // 3
+  graph.InsertVertex('D'); // 4
+  graph.InsertVertex('T'); // 5
+
+  // 权值即容量
+  graph.InsertEdge(0, 1, 16);
+  graph.InsertEdge(0, 2, 13);
+  graph.InsertEdge(1, 2, 10);
+  graph.InsertEdge(2, 1, 4);
+  graph.InsertEdge(1, 3, 12);
+  graph.InsertEdge(3, 2, 9);
+  graph.InsertEdge(2, 4, 14);
+  graph.InsertEdge(4, 3, 7);
+  graph.InsertEdge(3, 5, 20);
+  graph.InsertEdge(4, 5, 4);
+
+  int max_flow;
+  bool source_side[6];
+  graph.MaxFlow(0, 5, max_flow, source_side);
+
+  cout << "最大流: " << max_flow << "\n";
+  cout << "最小割源点一侧: ";
+  for (int i = 0; i < vertex_count; ++i) {
+    if (source_side[i]) {
+      char vertex;
+      graph.GetVertexByIndex(i, vertex);
+      cout << vertex << " ";
+    }
+  }
+  cout << "\n";
+}
+
+void test_MaximumMatching(){
+  int vertex_count = 6;
+  bool is_directed = false;
+
+  bu_tools::AdjLsitgraph<char, int> graph(is_directed, vertex_count);
+
+  // 左侧是工人 A B C，右侧是任务 X Y Z
+  graph.InsertVertex('A'); // 0
+  graph.InsertVertex('B'); // 1
+  graph.InsertVertex('C'); // 2
+  graph.InsertVertex('X'); // 3
+  graph.InsertVertex('Y'); // 4
+  graph.InsertVertex('Z'); // 5
+
+  graph.InsertEdge(0, 3, 1);
+  graph.InsertEdge(0, 4, 1);
+  graph.InsertEdge(1, 3, 1);
+  graph.InsertEdge(2, 4, 1);
+  graph.InsertEdge(2, 5, 1);
+
+  int mate[6];
+  cout << "最大匹配数: " << graph.MaximumMatching(mate) << "\n";
+  for (int i = 0; i < 3; ++i) {
+    char worker, task;
+    graph.GetVertexByIndex(i, worker);
+    graph.GetVertexByIndex(mate[i], task);
+    cout << worker << " -> " << (mate[i] == -1 ? '-' : task) << "\n";
+  }
+}
+
+void test_Reorder(){
+  int vertex_count = 6;
+  bool is_directed = false;
+
+  bu_tools::AdjLsitgraph<char, int> graph(is_directed, vertex_count);
+
+  // 一条被打乱编号的链 A - D - B - F - C - E
+  graph.InsertVertex('A'); // 0
+  graph.InsertVertex('B'); // 1
+  graph.InsertVertex('C'); // 2
+  graph.InsertVertex('D'); // 3
+  graph.InsertVertex('E'); // 4
+  graph.InsertVertex('F'); // 5
+
+  graph.InsertEdge(0, 3, 1);
+  graph.InsertEdge(3, 1, 2);
+  graph.InsertEdge(1, 5, 3);
+  graph.InsertEdge(5, 2, 4);
+  graph.InsertEdge(2, 4, 5);
+
+  int permutation[6];
+  graph.Reorder(bu_tools::VertexOrder::ReverseCuthillMcKee, permutation);
+
+  cout << "重排后的顶点顺序: ";
+  for (int i = 0; i < graph.GetVertexCount(); ++i) {
+    char vertex;
+    graph.GetVertexByIndex(i, vertex);
+    cout << vertex << " ";
+  }
+  cout << "\n";
+
+  cout << "重排后的边: \n";
+  for (int i = 0; i < graph.GetVertexCount(); ++i) {
+    for (int j = i + 1; j < graph.GetVertexCount(); ++j) {
+      int weight;
+      if (graph.GetEdgeWeight(i, j, weight)) {
+        char src, dest;
+        graph.GetVertexByIndex(i, src);
+        graph.GetVertexByIndex(j, dest);
+        cout << src << " - " << dest << " : " << weight << "\n";
+      }
+    }
+  }
+}
+
+void test_ToCompressedGraph(){
+  int vertex_count = 6;
+  bool is_directed = false;
+
+  bu_tools::AdjLsitgraph<char, int> graph(is_directed, vertex_count);
+
+  graph.InsertVertex('A'); // 0
+  graph.InsertVertex('B'); // 1
+  graph.InsertVertex('C'); // 2
+  graph.InsertVertex('D'); // 3
+  graph.InsertVertex('E'); // 4
+  graph.InsertVertex('F'); // 5
+
+  graph.InsertEdge(0, 1, 6);
+  graph.InsertEdge(0, 2, 1);
+  graph.InsertEdge(0, 3, 5);
+  graph.InsertEdge(1, 4, 3);
+  graph.InsertEdge(2, 4, 6);
+  graph.InsertEdge(3, 5, 2);
+  graph.InsertEdge(4, 5, 6);
+
+  bu_tools::CompressedGraph<int> compressed;
+  graph.ToCompressedGraph(compressed);
+  cout << "压缩后占用字节数: " << compressed.GetMemoryBytes() << "\n";
+
+  for (int i = 0; i < compressed.GetVertexCount(); ++i) {
+    cout << i << ":";
+    compressed.ForEachNeighbor(i, [](int dest, const int &weight) { cout << " " << dest << "(" << weight << ")"; });
+    cout << "\n";
+  }
+
+  cout << "深度优先遍历: ";
+  compressed.DepthFirstSearch(0, [](int vertex) { cout << vertex << " "; });
+  cout << "\n";
+  cout << "广度优先遍历: ";
+  compressed.BreadthFirstSearch(0, [](int vertex) { cout << vertex << " "; });
+  cout << "\n";
+}
+
+void test_LazyRemoval(){
+  int vertex_count = 6;
+  bool is_directed = true;
+
+  bu_tools::AdjLsitgraph<char, int> graph(is_directed, vertex_count);
+  graph.SetLazyRemoval(true);
+
+  graph.InsertVertex('A'); // 0
+  graph.InsertVertex('B'); // 1
+  graph.InsertVertex('C'); // 2
+  graph.InsertVertex('D'); // 3
+  graph.InsertVertex('E'); // 4
+  graph.InsertVertex('F'); // 5
+
+  graph.InsertEdge(0, 1, 1);
+  graph.InsertEdge(1, 2, 1);
+  graph.InsertEdge(2, 3, 1);
+  graph.InsertEdge(0, 4, 1);
+  graph.InsertEdge(4, 5, 1);
+  graph.InsertEdge(5, 3, 1);
+
+  // 删除后其余顶点的索引不变
+  graph.RemoveVertex('B');
+  graph.RemoveVertex('E');
+  cout << "删除 B、E 后 D 的索引: " << graph.GetVertexIndex('D') << "，存活顶点数: " << graph.GetLiveVertexCount() << "\n";
+  cout << "深度优先遍历: ";
+  graph.DepthFirstSearch(0, PrintVertex);
+  cout << "\n";
+
+  int mapping[6];
+  cout << "回收墓碑: " << graph.Compact(mapping) << "\n";
+  for (int i = 0; i < 6; ++i) {
+    cout << i << " -> " << mapping[i] << "\n";
+  }
+  cout << "压缩后 D 的索引: " << graph.GetVertexIndex('D') << "，顶点数: " << graph.GetVertexCount() << "\n";
+}
+
+void test_InEdgeIndex(){
+  int vertex_count = 6;
+  bool is_directed = true;
+
+  bu_tools::AdjLsitgraph<char, int> graph(is_directed, vertex_count);
+  graph.SetInEdgeIndex(true);
+
+  graph.InsertVertex('A'); // 0
+  graph.InsertVertex('B'); // 1
+  graph.InsertVertex('C'); // 2
+  graph.InsertVertex('D'); // 3
+  graph.InsertVertex('E'); // 4
+  graph.InsertVertex('F'); // 5
+
+  graph.InsertEdge(0, 1, 1);
+  graph.InsertEdge(0, 2, 2);
+  graph.InsertEdge(1, 3, 3);
+  graph.InsertEdge(2, 3, 4);
+  graph.InsertEdge(3, 4, 5);
+  graph.InsertEdge(5, 4, 6);
+
+  cout << "D 的入度: " << graph.GetInDegree(3) << "\n";
+  cout << "E 的前驱: ";
+  graph.ForEachPredecessor(4, [](int src, const int &weight) { cout << src << "(" << weight << ") "; });
+  cout << "\n";
+
+  int distance[6];
+  graph.BreadthFirstDistance(0, distance);
+  cout << "从 A 出发的跳数: ";
+  for (int i = 0; i < 6; ++i) {
+    cout << distance[i] << " ";
+  }
+  cout << "\n";
+}
+
+void test_EgoNetwork(){
+  int vertex_count = 7;
+  bool is_directed = false;
+
+  bu_tools::AdjLsitgraph<char, int> graph(is_directed, vertex_count);
+
+  graph.InsertVertex('A'); // 0
+  graph.InsertVertex('B'); // 1
+  graph.InsertVertex('C'); // 2
+  graph.InsertVertex('D'); // 3
+  graph.InsertVertex('E'); // 4
+  graph.InsertVertex('F'); // 5
+  graph.InsertVertex('G'); // 6
+
+  graph.InsertEdge(0, 1, 1);
+  graph.InsertEdge(0, 2, 2);
+  graph.InsertEdge(1, 2, 3);
+  graph.InsertEdge(2, 3, 4);
+  graph.InsertEdge(3, 4, 5);
+  graph.InsertEdge(4, 5, 6);
+  graph.InsertEdge(5, 6, 7);
+
+  bu_tools::SeqList<int> vertices;
+  bu_tools::SeqList<int> distances;
+  int count = graph.KHopNeighborhood(0, 2, vertices, distances);
+  cout << "A 的 2 跳邻域: ";
+  for (int i = 1; i <= count; ++i) {
+    char vertex;
+    graph.GetVertexByIndex(vertices[i], vertex);
+    cout << vertex << "(" << distances[i] << ") ";
+  }
+  cout << "\n";
+
+  bu_tools::AdjLsitgraph<char, int> ego(is_directed);
+  graph.EgoNetwork(0, 2, ego);
+  cout << "自我网络的边: \n";
+  for (int i = 0; i < ego.GetVertexCount(); ++i) {
+    for (int j = i + 1; j < ego.GetVertexCount(); ++j) {
+      int weight;
+      if (ego.GetEdgeWeight(i, j, weight)) {
+        char src, dest;
+        ego.GetVertexByIndex(i, src);
+        ego.GetVertexByIndex(j, dest);
+        cout << src << " - " << dest << " : " << weight << "\n";
+      }
+    }
+  }
+}
+
+void test_TraversalContext(){
+  int vertex_count = 6;
+  bool is_directed = true;
+
+  bu_tools::AdjLsitgraph<char, int> graph(is_directed, vertex_count);
+
+  graph.InsertVertex('A'); // 0
+  graph.InsertVertex('B'); // 1
+  graph.InsertVertex('C'); // 2
+  graph.InsertVertex('D'); // 3
+  graph.InsertVertex('E'); // 4
+  graph.InsertVertex('F'); // 5
+
+  graph.InsertEdge(0, 1, 4);
+  graph.InsertEdge(0, 2, 1);
+  graph.InsertEdge(2, 1, 2);
+  graph.InsertEdge(1, 3, 5);
+  graph.InsertEdge(4, 5, 3);
+
+  // 同一个上下文反复使用，每次遍历都不再分配内存
+  bu_tools::TraversalContext context(vertex_count);
+  for (int start = 0; start < 2; ++start) {
+    cout << "从 " << start << " 出发的深度优先: ";
+    graph.DepthFirstSearch(start, PrintVertex, context);
+    cout << "\n从 " << start << " 出发的广度优先: ";
+    graph.BreadthFirstSearch(start, PrintVertex, context);
+    cout << "\n";
+  }
+
+  int distance[6];
+  graph.Dijkstra(0, distance, context);
+  cout << "从 A 出发的最短距离: ";
+  for (int i = 0; i < vertex_count; ++i) {
+    if (context.IsVisited(i)) {
+      cout << distance[i] << " ";
+    } else {
+      cout << "- ";
+    }
+  }
+  cout << "\n";
+
+  char sorted_vertices[6];
+  if (graph.TopologicalSort(sorted_vertices, context)) {
+    cout << "拓扑排序: ";
+    for (int i = 0; i < vertex_count; ++i) {
+      cout << sorted_vertices[i] << " ";
+    }
+    cout << "\n";
+  }
+}
+
+void test_Visitor(){
+  int vertex_count = 6;
+  bool is_directed = false;
+
+  bu_tools::AdjLsitgraph<char, int> graph(is_directed, vertex_count);
+
+  graph.InsertVertex('A'); // 0
+  graph.InsertVertex('B'); // 1
+  graph.InsertVertex('C'); // 2
+  graph.InsertVertex('D'); // 3
+  graph.InsertVertex('E'); // 4
+  graph.InsertVertex('F'); // 5
+
+  graph.InsertEdge(0, 1, 1);
+  graph.InsertEdge(0, 2, 1);
+  graph.InsertEdge(1, 3, 1);
+  graph.InsertEdge(2, 4, 1);
+  graph.InsertEdge(4, 5, 1);
+
+  // 带状态的访问器：输出顶点、索引和跳数
+  cout << "广度优先（顶点 索引 跳数）: \n";
+  graph.BreadthFirstSearch(0, [](const char &vertex, int index, int depth) {
+    cout << vertex << " " << index << " " << depth << "\n";
+    return false;
+  });
+
+  // 找到目标顶点后立即停止
+  int visited_count = 0;
+  bool found = graph.DepthFirstSearch(0, [&visited_count](const char &vertex, int, int) {
+    ++visited_count;
+    return vertex == 'E';
+  });
+  cout << "深度优先找到 E: " << (found ? "是" : "否") << "，访问了 " << visited_count << " 个顶点\n";
+}
+
+void test_SetEdgeWeight(){
+  // 有向图维护入边表：改权值后前驱遍历读到的应是新值
+  bu_tools::AdjLsitgraph<char, int> directed(true, 4);
+  directed.SetInEdgeIndex(true);
+  directed.InsertVertex('A'); // 0
+  directed.InsertVertex('B'); // 1
+  directed.InsertVertex('C'); // 2
+  directed.InsertVertex('D'); // 3
+  directed.InsertEdge(0, 3, 1);
+  directed.InsertEdge(1, 3, 2);
+  directed.InsertEdge(2, 3, 3);
+
+  bool passed = directed.SetEdgeWeight(1, 3, 20) && !directed.SetEdgeWeight(3, 1, 5);
+  int weight = 0;
+  passed = passed && directed.GetEdgeWeight(1, 3, weight) && weight == 20;
+  cout << "D 的前驱: ";
+  directed.ForEachPredecessor(3, [&passed](int src, const int &weight) {
+    cout << src << "(" << weight << ") ";
+    passed = passed && weight == (src == 1 ? 20 : src + 1);
+  });
+  cout << "\n";
+
+  // 无向图：两个方向的权值都要更新
+  bu_tools::AdjLsitgraph<char, int> undirected(false, 3);
+  undirected.InsertVertex('A'); // 0
+  undirected.InsertVertex('B'); // 1
+  undirected.InsertVertex('C'); // 2
+  undirected.InsertEdge(0, 1, 1);
+  undirected.InsertEdge(1, 2, 2);
+
+  passed = passed && undirected.SetEdgeWeight(2, 1, 7);
+  passed = passed && undirected.GetEdgeWeight(1, 2, weight) && weight == 7;
+  passed = passed && undirected.GetEdgeWeight(2, 1, weight) && weight == 7;
+  undirected.ForEachPredecessor(2, [&passed](int src, const int &weight) { passed = passed && src == 1 && weight == 7; });
+  cout << "SetEdgeWeight: " << (passed ? "通过" : "失败") << "\n";
+}
+
+void test_CompressedFromEdges(){
+  // 按源顶点有序的弧数组直接构建，同一源顶点的弧不必有序
+  const int srcs[8] = {0, 0, 1, 1, 2, 2, 3, 4};
+  const int dests[8] = {3, 1, 0, 4, 4, 5, 0, 1};
+  const int weights[8] = {5, 6, 6, 3, 6, 2, 5, 3};
+
+  bu_tools::CompressedGraph<int> compressed;
+  bool built = compressed.Build(6, srcs, dests, weights, 8);
+  cout << "由弧数组构建: " << (built ? "成功" : "失败") << "，弧数: " << compressed.GetEdgeCount() << "\n";
+  for (int i = 0; i < compressed.GetVertexCount(); ++i) {
+    cout << i << ":";
+    compressed.ForEachNeighbor(i, [](int dest, const int &weight) { cout << " " << dest << "(" << weight << ")"; });
+    cout << "\n";
+  }
+
+  // 源顶点无序时拒绝，原来的图不变
+  const int unsorted[3] = {1, 0, 2};
+  built = compressed.Build(6, unsorted, dests, weights, 3);
+  cout << "源顶点无序: " << (built ? "成功" : "失败") << "，弧数仍为: " << compressed.GetEdgeCount() << "\n";
+}
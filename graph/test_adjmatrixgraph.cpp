@@ -30,6 +30,7 @@ void PrintPath(int start, int end, int **path);
 void test_TopologicalSort();
 void test_Prim();
 void test_Kruskal();
+void test_MatrixAlgorithms();
 
 /****************************************************************************************************
 
@@ -44,6 +45,7 @@ int main(int argc, const char *argv[]) {
   //test_TopologicalSort();
   //test_Prim();
   test_Kruskal();
+  test_MatrixAlgorithms();
 
   return 0;
 }
@@ -280,3 +282,37 @@ void test_Kruskal() {
     ++index;
   }
 }
+
+void test_MatrixAlgorithms() {
+  // 两个三角形 ABC、BCD 共用边 BC，E 只与 D 相连
+  bu_tools::AdjMatrixGraph<char, int> graph(5, false);
+  for (char vertex = 'A'; vertex <= 'E'; ++vertex) {
+    graph.InsertVertex(vertex);
+  }
+  graph.InsertEdge(0, 1, 4);
+  graph.InsertEdge(0, 2, 1);
+  graph.InsertEdge(1, 2, 2);
+  graph.InsertEdge(1, 3, 5);
+  graph.InsertEdge(2, 3, 8);
+  graph.InsertEdge(3, 4, 3);
+
+  int level[5];
+  int distance[5];
+  graph.BreadthFirstLevels(0, level);
+  graph.BellmanFord(0, distance);
+  cout << "顶点  层数  最短距离\n";
+  for (int i = 0; i < 5; ++i) {
+    char vertex;
+    graph.GetVertexByIndex(i, vertex);
+    cout << vertex << setw(6) << level[i] << setw(10) << distance[i] << "\n";
+  }
+  cout << "三角形个数：" << graph.CountTriangles() << "\n";
+
+  // 邻接矩阵的平方在 (min, +) 半环上是最多两条边的最短路径
+  const bu_tools::TripletSparseMatrix<int> &adj = graph.GetAdjMatrix();
+  bu_tools::TripletSparseMatrix<int> two_hops;
+  adj.Multiply<bu_tools::MinPlusSemiring<int>>(adj, two_hops);
+  int weight = 0;
+  two_hops.GetValue(0, 3, weight);
+  cout << "A 到 D 最多两条边的最短路径：" << weight << "\n";
+}
@@ -0,0 +1,107 @@
+/**
+ * ************************************************************************
+ * @filename: test_versionedgraph.cpp
+ * 
+ * @brief : 测试多版本动态图类
+ * 
+ * 
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-14
+ * 
+ * ************************************************************************
+ */
+
+#include "versionedgraph.h"
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+using std::cout;
+
+void test_Publish();
+void test_ConcurrentReaders();
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+主函数
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, const char* argv[]) {
+  test_Publish();
+  //test_ConcurrentReaders();
+
+  return 0;
+}
+
+void test_Publish(){
+  bu_tools::VersionedGraph<int> graph(false, 4);
+  int reader = graph.RegisterReader();
+
+  graph.InsertEdge(0, 1, 5);
+  graph.InsertEdge(1, 2, 3);
+  graph.InsertEdge(2, 3, 7);
+  cout << "发布版本: " << graph.Publish() << "\n";
+
+  // 旧快照在 Release 之前一直有效，不受之后发布的影响
+  const bu_tools::VersionedGraph<int>::Snapshot *snapshot = graph.Acquire(reader);
+
+  graph.RemoveEdge(1, 2);
+  graph.InsertEdge(0, 3, 1);
+  cout << "发布版本: " << graph.Publish() << "\n";
+
+  cout << "快照版本 " << snapshot->GetVersion() << " 的弧数: " << snapshot->GetEdgeCount() << "\n";
+  cout << "广度优先遍历: ";
+  snapshot->BreadthFirstSearch(0, [](int vertex) { cout << vertex << " "; });
+  cout << "\n";
+  graph.Release(reader);
+
+  snapshot = graph.Acquire(reader);
+  cout << "快照版本 " << snapshot->GetVersion() << " 的弧数: " << snapshot->GetEdgeCount() << "\n";
+  cout << "广度优先遍历: ";
+  snapshot->BreadthFirstSearch(0, [](int vertex) { cout << vertex << " "; });
+  cout << "\n";
+  graph.Release(reader);
+
+  graph.UnregisterReader(reader);
+}
+
+void test_ConcurrentReaders(){
+  const int vertex_count = 1000;
+  bu_tools::VersionedGraph<int> graph(true, vertex_count);
+  std::atomic<bool> stop(false);
+  std::atomic<int> inconsistent(0);
+
+  // 写者每次发布多接上一段链，读者检查看到的快照弧数与版本号一致
+  std::thread readers[4];
+  for (int t = 0; t < 4; ++t) {
+    readers[t] = std::thread([&graph, &stop, &inconsistent]() {
+      int reader = graph.RegisterReader();
+      while (!stop.load()) {
+        const bu_tools::VersionedGraph<int>::Snapshot *snapshot = graph.Acquire(reader);
+        long long arc_count = 0;
+        for (int v = 0; v < snapshot->GetVertexCount(); ++v) {
+          arc_count += snapshot->GetDegree(v);
+        }
+        if (arc_count != snapshot->GetVersion()) {
+          ++inconsistent;
+        }
+        graph.Release(reader);
+      }
+      graph.UnregisterReader(reader);
+    });
+  }
+
+  for (int v = 0; v + 1 < vertex_count; ++v) {
+    graph.InsertEdge(v, v + 1, v);
+    graph.Publish();
+  }
+  stop.store(true);
+  for (int t = 0; t < 4; ++t) {
+    readers[t].join();
+  }
+
+  cout << "最终版本: " << graph.GetVersion() << "，不一致的读取次数: " << inconsistent.load() << "\n";
+}
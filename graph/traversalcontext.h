@@ -0,0 +1,248 @@
+/**
+ * ************************************************************************
+ * @filename: traversalcontext.h
+ *
+ * @brief : 可重复使用的遍历上下文
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-16
+ *
+ * ************************************************************************
+ */
+
+#ifndef _TRAVERSALCONTEXT_H_
+#define _TRAVERSALCONTEXT_H_
+
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 遍历上下文：访问标记、队列（栈、堆）和每个顶点一个整数的暂存区都按顶点个数预先分配，
+ *          在多次遍历之间重复使用。访问标记带代数，开始新的遍历只需把代数加一，不必清空数组，
+ *          所以只访问少数顶点的局部遍历代价与访问到的顶点数成正比，也不再分配内存。
+ *          一个上下文同一时刻只能用于一次遍历，多线程时每个线程各用一个
+ * *****************************************************************
+ */
+class TraversalContext {
+  /*****************************************************************
+
+  数据域
+
+  *****************************************************************/
+protected:
+  unsigned int *m_stamps;     // 每个顶点最近一次被标记时的代数
+  int *m_buffer;              // 队列、栈或堆的存储
+  int *m_slots;               // 每个顶点一个整数的暂存区，只对本次遍历标记过的顶点有意义
+  unsigned int m_generation;  // 当前代数，从 1 开始
+  int m_capacity;             // 顶点容量
+  int m_heap_size;            // 用作索引堆时堆中的顶点个数
+
+  /*****************************************************************
+
+  成员函数的声明
+
+  *****************************************************************/
+public:
+  TraversalContext(int capacity = 0) : m_stamps(nullptr), m_buffer(nullptr), m_slots(nullptr), m_generation(1), m_capacity(0), m_heap_size(0) {
+    Reserve(capacity);
+  }
+  TraversalContext(const TraversalContext &other) = delete;
+  TraversalContext &operator=(const TraversalContext &other) = delete;
+  virtual ~TraversalContext() {
+    delete[] m_stamps;
+    delete[] m_buffer;
+    delete[] m_slots;
+  }
+
+  void Reserve(int capacity); // 保证至少能容纳 capacity 个顶点，扩容时清空标记
+  void Reset();               // 开始一次新的遍历，清空所有标记
+
+  // 标记
+  bool IsVisited(int vertex) const { return m_stamps[vertex] == m_generation; }
+  bool Visit(int vertex) {
+    if (m_stamps[vertex] == m_generation) {
+      return false;
+    }
+    m_stamps[vertex] = m_generation;
+    return true;
+  }
+
+  int GetCapacity() const { return m_capacity; }
+  int *GetBuffer() { return m_buffer; }
+  int *GetSlots() { return m_slots; }
+  const int *GetSlots() const { return m_slots; }
+
+  // 索引小根堆：堆存放在 m_buffer，顶点在堆中的位置存放在 m_slots，出堆后位置记为 -1
+  void ClearHeap() { m_heap_size = 0; }
+  bool IsHeapEmpty() const { return m_heap_size == 0; }
+  bool IsInHeap(int vertex) const { return m_slots[vertex] >= 0; } // 只对本次遍历标记过的顶点有意义
+  template <typename K>
+  void PushHeap(int vertex, const K *keys); // 按 keys[vertex] 入堆
+  template <typename K>
+  void DecreaseKey(int vertex, const K *keys); // keys[vertex] 变小之后调整位置
+  template <typename K>
+  int PopHeap(const K *keys); // 取出 keys 最小的顶点
+
+private:
+  template <typename K>
+  void HelpSiftUp(int position, const K *keys);
+  template <typename K>
+  void HelpSiftDown(int position, const K *keys);
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+成员函数的定义
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * *****************************************************************
+ * @brief : 保证至少能容纳 capacity 个顶点，容量按两倍增长，扩容时清空标记
+ * @param  capacity
+ * *****************************************************************
+ */
+inline void TraversalContext::Reserve(int capacity) {
+  if (capacity <= m_capacity) {
+    return;
+  }
+
+  int new_capacity = m_capacity > 0 ? m_capacity : 16;
+  while (new_capacity < capacity) {
+    new_capacity *= 2;
+  }
+
+  delete[] m_stamps;
+  delete[] m_buffer;
+  delete[] m_slots;
+  m_capacity = new_capacity;
+  m_stamps = new unsigned int[m_capacity];
+  m_buffer = new int[m_capacity];
+  m_slots = new int[m_capacity];
+  for (int i = 0; i < m_capacity; ++i) {
+    m_stamps[i] = 0;
+  }
+  m_generation = 1;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 开始一次新的遍历，代数加一即清空所有标记；代数回绕到 0 时才真正清空数组
+ * *****************************************************************
+ */
+inline void TraversalContext::Reset() {
+  ++m_generation;
+  if (m_generation == 0) {
+    for (int i = 0; i < m_capacity; ++i) {
+      m_stamps[i] = 0;
+    }
+    m_generation = 1;
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 堆中位置 position 的顶点向上调整
+ * @tparam K
+ * @param  position
+ * @param  keys
+ * *****************************************************************
+ */
+template <typename K>
+inline void TraversalContext::HelpSiftUp(int position, const K *keys) {
+  int vertex = m_buffer[position];
+  while (position > 0) {
+    int parent = (position - 1) / 2;
+    if (!(keys[vertex] < keys[m_buffer[parent]])) {
+      break;
+    }
+    m_buffer[position] = m_buffer[parent];
+    m_slots[m_buffer[position]] = position;
+    position = parent;
+  }
+  m_buffer[position] = vertex;
+  m_slots[vertex] = position;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 堆中位置 position 的顶点向下调整
+ * @tparam K
+ * @param  position
+ * @param  keys
+ * *****************************************************************
+ */
+template <typename K>
+inline void TraversalContext::HelpSiftDown(int position, const K *keys) {
+  int vertex = m_buffer[position];
+  while (true) {
+    int child = 2 * position + 1;
+    if (child >= m_heap_size) {
+      break;
+    }
+    if (child + 1 < m_heap_size && keys[m_buffer[child + 1]] < keys[m_buffer[child]]) {
+      ++child;
+    }
+    if (!(keys[m_buffer[child]] < keys[vertex])) {
+      break;
+    }
+    m_buffer[position] = m_buffer[child];
+    m_slots[m_buffer[position]] = position;
+    position = child;
+  }
+  m_buffer[position] = vertex;
+  m_slots[vertex] = position;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 顶点按 keys[vertex] 入堆，每个顶点每次遍历最多入堆一次
+ * @tparam K
+ * @param  vertex
+ * @param  keys
+ * *****************************************************************
+ */
+template <typename K>
+inline void TraversalContext::PushHeap(int vertex, const K *keys) {
+  m_buffer[m_heap_size] = vertex;
+  HelpSiftUp(m_heap_size++, keys);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 堆中顶点的 keys[vertex] 变小之后上调
+ * @tparam K
+ * @param  vertex
+ * @param  keys
+ * *****************************************************************
+ */
+template <typename K>
+inline void TraversalContext::DecreaseKey(int vertex, const K *keys) {
+  HelpSiftUp(m_slots[vertex], keys);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 取出堆顶，堆不能为空
+ * @tparam K
+ * @param  keys
+ * @return int 堆顶顶点，其位置记为 -1
+ * *****************************************************************
+ */
+template <typename K>
+inline int TraversalContext::PopHeap(const K *keys) {
+  int top = m_buffer[0];
+  m_slots[top] = -1;
+  if (--m_heap_size > 0) {
+    m_buffer[0] = m_buffer[m_heap_size];
+    HelpSiftDown(0, keys);
+  }
+  return top;
+}
+
+} // namespace bu_tools
+
+#endif // _TRAVERSALCONTEXT_H_
@@ -0,0 +1,792 @@
+/**
+ * ************************************************************************
+ * @filename: versionedgraph.h
+ *
+ * @brief : 支持批量更新和多版本快照的动态图，读者无锁
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-14
+ *
+ * ************************************************************************
+ */
+
+#ifndef _VERSIONEDGRAPH_H_
+#define _VERSIONEDGRAPH_H_
+
+#include "../queue/seqqueue/seqqueue.h"
+#include "csrgraph.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 多版本动态图，顶点用索引表示，只增不删。
+ *          写者把边的插入、删除先放进增量缓冲区，Publish 时一次性合并成新的不可变快照：
+ *          只有被修改的顶点重新分配邻接块，顶点按页分组，只有含被修改顶点的页被复制（写时复制），
+ *          其余的页和邻接块在新旧快照之间共享。
+ *          读者用 Acquire / Release 包住对快照的访问，期间快照不会被修改或释放，读者之间、读者与写者之间都不加锁。
+ *          被替换下来的页、邻接块和旧快照按纪元回收：退役时记下当时的全局纪元，
+ *          等所有正在读的读者登记的纪元都比它大之后才释放
+ * @tparam E 权值
+ * *****************************************************************
+ */
+template <typename E>
+class VersionedGraph {
+public:
+  static const int PAGE_BITS = 10;             // 每页顶点数的对数
+  static const int PAGE_SIZE = 1 << PAGE_BITS; // 每页的顶点数
+
+private:
+  // 一个顶点的邻接块，邻接顶点按索引升序，创建后不再修改
+  struct AdjBlock {
+    int m_degree;   // 邻接顶点个数
+    int *m_targets; // 邻接顶点
+    E *m_weights;   // 权值
+  };
+
+  // 增量缓冲区中的一条弧的更新
+  struct ArcUpdate {
+    int m_src;        // 源顶点
+    int m_dest;       // 目标顶点
+    E m_weight;       // 权值
+    bool m_remove;    // 是否是删除
+    int m_sequence;   // 在缓冲区中的先后次序，同一条弧后来的更新覆盖先前的
+  };
+
+public:
+  /**
+   * *****************************************************************
+   * @brief : 不可变快照，读者在 Acquire 与 Release 之间可以任意访问
+   * *****************************************************************
+   */
+  class Snapshot {
+    friend class VersionedGraph;
+
+  private:
+    long long m_version;  // 版本号
+    int m_vertex_count;   // 顶点数量
+    long long m_edge_count; // 弧的数量（无向图每条边占两条弧）
+    int m_page_count;     // 页数
+    AdjBlock ***m_pages;  // 页表，每页 PAGE_SIZE 个邻接块指针，没有邻接顶点时为 nullptr
+
+    Snapshot() : m_version(0), m_vertex_count(0), m_edge_count(0), m_page_count(0), m_pages(nullptr) {}
+    ~Snapshot() {
+      delete[] m_pages;
+    }
+
+    const AdjBlock *Block(int vertex) const {
+      return m_pages[vertex >> PAGE_BITS][vertex & (PAGE_SIZE - 1)];
+    }
+
+  public:
+    long long GetVersion() const { return m_version; }
+    int GetVertexCount() const { return m_vertex_count; }
+    long long GetEdgeCount() const { return m_edge_count; }
+
+    int GetDegree(int vertex) const {
+      const AdjBlock *block = Block(vertex);
+      return block ? block->m_degree : 0;
+    }
+    const int *GetNeighbors(int vertex) const {
+      const AdjBlock *block = Block(vertex);
+      return block ? block->m_targets : nullptr;
+    }
+    const E *GetWeights(int vertex) const {
+      const AdjBlock *block = Block(vertex);
+      return block ? block->m_weights : nullptr;
+    }
+
+    bool GetEdgeWeight(int src, int dest, E &weight) const;                     // 获取弧的权值
+    void DepthFirstSearch(int start_vertex, void (*visit)(int vertex)) const;   // 深度优先遍历
+    void BreadthFirstSearch(int start_vertex, void (*visit)(int vertex)) const; // 广度优先遍历
+  };
+
+private:
+  // 一次发布退役的对象，按纪元回收
+  struct RetiredBatch {
+    unsigned long long m_epoch; // 退役时的全局纪元
+    Snapshot *m_snapshot;       // 旧快照
+    AdjBlock **m_blocks;        // 被替换的邻接块
+    int m_block_count;
+    AdjBlock ***m_pages;        // 被复制的页
+    int m_page_count;
+    RetiredBatch *m_next;
+  };
+
+  /*****************************************************************
+
+  数据域
+
+  *****************************************************************/
+protected:
+  bool m_is_directed;                           // 是否为有向图
+  std::atomic<Snapshot *> m_current;            // 最新发布的快照
+  std::atomic<unsigned long long> m_global_epoch; // 全局纪元，每次发布加一，从 1 开始
+  std::atomic<unsigned long long> *m_reader_epochs; // 每个读者进入时登记的纪元，0 表示不在读
+  std::atomic<bool> *m_reader_used;             // 读者槽位是否已被注册
+  int m_max_readers;                            // 读者槽位个数
+
+  std::mutex m_write_mutex;     // 写者之间互斥
+  ArcUpdate *m_pending;         // 增量缓冲区
+  int m_pending_count;          // 缓冲区中的更新个数
+  int m_pending_capacity;       // 缓冲区容量
+  int m_pending_vertex_count;   // 发布后的顶点数量
+  RetiredBatch *m_retired;      // 尚未回收的退役对象，链表
+
+  /*****************************************************************
+
+  成员函数的声明
+
+  *****************************************************************/
+private:
+  void HelpPushUpdate(int src, int dest, const E &weight, bool remove);
+  void HelpReclaim();
+  static void HelpFreeBlock(AdjBlock *block);
+
+public:
+  VersionedGraph(bool is_directed, int vertex_count = 0, int max_readers = 64);
+  VersionedGraph(const VersionedGraph &other) = delete;
+  VersionedGraph &operator=(const VersionedGraph &other) = delete;
+  virtual ~VersionedGraph();
+
+  // 写者，可以多个线程同时调用
+  int InsertVertex();                                        // 插入顶点，返回新顶点的索引，发布后可见
+  bool InsertEdge(int src, int dest, const E &weight);       // 插入边或弧，已存在时更新权值
+  bool RemoveEdge(int src, int dest);                        // 删除边或弧
+  bool Load(const CSRGraph<E> &csr);                         // 把 CSR 快照中的弧全部放入缓冲区
+  long long Publish();                                       // 合并缓冲区并发布新快照，返回新版本号
+  int GetPendingCount();                                     // 缓冲区中尚未发布的更新个数
+  void Reclaim();                                            // 尝试回收退役对象
+
+  // 读者
+  int RegisterReader();                       // 注册读者，返回槽位，槽位用完时返回 -1
+  void UnregisterReader(int reader);          // 注销读者
+  const Snapshot *Acquire(int reader);        // 进入读，返回最新快照
+  void Release(int reader);                   // 退出读，之后不能再访问 Acquire 返回的快照
+
+  long long GetVersion() const;               // 最新发布的版本号
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+成员函数的定义
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * *****************************************************************
+ * @brief : 获取弧的权值，邻接块有序，二分查找
+ * @tparam E
+ * @param  src
+ * @param  dest
+ * @param  weight
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename E>
+inline bool VersionedGraph<E>::Snapshot::GetEdgeWeight(int src, int dest, E &weight) const {
+  if (src < 0 || src >= m_vertex_count || dest < 0 || dest >= m_vertex_count) {
+    return false;
+  }
+
+  const AdjBlock *block = Block(src);
+  if (block == nullptr) {
+    return false;
+  }
+  const int *end = block->m_targets + block->m_degree;
+  const int *pos = std::lower_bound(block->m_targets, end, dest);
+  if (pos == end || *pos != dest) {
+    return false;
+  }
+  weight = block->m_weights[pos - block->m_targets];
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 深度优先遍历，只访问从起始顶点可达的顶点，用显式栈保存每层下一个要看的邻接顶点
+ * @tparam E
+ * @param  start_vertex
+ * @param  visit 自定义处理顶点的函数
+ * *****************************************************************
+ */
+template <typename E>
+inline void VersionedGraph<E>::Snapshot::DepthFirstSearch(int start_vertex, void (*visit)(int vertex)) const {
+  // 检查起始顶点是否合法
+  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
+    return; // 非法的起始顶点
+  }
+
+  bool *visited = new bool[m_vertex_count];
+  for (int i = 0; i < m_vertex_count; ++i) {
+    visited[i] = false;
+  }
+  // 每个顶点至多入栈一次
+  int *stack_vertex = new int[m_vertex_count];
+  int *stack_next = new int[m_vertex_count];
+  int top = 0;
+
+  visited[start_vertex] = true;
+  visit(start_vertex);
+  stack_vertex[top] = start_vertex;
+  stack_next[top++] = 0;
+
+  while (top > 0) {
+    int vertex = stack_vertex[top - 1];
+    if (stack_next[top - 1] == GetDegree(vertex)) {
+      --top;
+      continue;
+    }
+    int dest = GetNeighbors(vertex)[stack_next[top - 1]++];
+    if (!visited[dest]) {
+      visited[dest] = true;
+      visit(dest);
+      stack_vertex[top] = dest;
+      stack_next[top++] = 0;
+    }
+  }
+
+  delete[] stack_vertex;
+  delete[] stack_next;
+  delete[] visited;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 广度优先遍历，从起始顶点开始，之后依次从未访问的顶点开始，保证每个连通分量都被访问
+ * @tparam E
+ * @param  start_vertex
+ * @param  visit 自定义处理顶点的函数
+ * *****************************************************************
+ */
+template <typename E>
+inline void VersionedGraph<E>::Snapshot::BreadthFirstSearch(int start_vertex, void (*visit)(int vertex)) const {
+  // 检查起始顶点是否合法
+  if (start_vertex < 0 || start_vertex >= m_vertex_count) {
+    return; // 非法的起始顶点
+  }
+
+  bool *visited = new bool[m_vertex_count];
+  for (int i = 0; i < m_vertex_count; ++i) {
+    visited[i] = false;
+  }
+  SeqQueue<int> vertex_queue(m_vertex_count + 1);
+
+  for (int i = 0; i < m_vertex_count; ++i) {
+    int root = (start_vertex + i) % m_vertex_count;
+    if (visited[root]) {
+      continue;
+    }
+
+    visited[root] = true;
+    vertex_queue.EnQueue(root);
+    while (!vertex_queue.IsEmpty()) {
+      int current_vertex;
+      vertex_queue.DeQueue(current_vertex);
+      visit(current_vertex);
+
+      const int *neighbors = GetNeighbors(current_vertex);
+      int degree = GetDegree(current_vertex);
+      for (int k = 0; k < degree; ++k) {
+        if (!visited[neighbors[k]]) {
+          visited[neighbors[k]] = true;
+          vertex_queue.EnQueue(neighbors[k]);
+        }
+      }
+    }
+  }
+
+  delete[] visited;
+}
+
+/**
+ * *****************************************************************
+ * @brief : Construct a new VersionedGraph< E>:: VersionedGraph object，发布一个只有顶点的初始快照
+ * @tparam E
+ * @param  is_directed
+ * @param  vertex_count
+ * @param  max_readers 读者槽位个数
+ * *****************************************************************
+ */
+template <typename E>
+inline VersionedGraph<E>::VersionedGraph(bool is_directed, int vertex_count, int max_readers)
+    : m_is_directed(is_directed), m_current(nullptr), m_global_epoch(1), m_max_readers(max_readers), m_pending(nullptr),
+      m_pending_count(0), m_pending_capacity(0), m_pending_vertex_count(vertex_count), m_retired(nullptr) {
+  m_reader_epochs = new std::atomic<unsigned long long>[m_max_readers];
+  m_reader_used = new std::atomic<bool>[m_max_readers];
+  for (int i = 0; i < m_max_readers; ++i) {
+    m_reader_epochs[i].store(0);
+    m_reader_used[i].store(false);
+  }
+
+  Snapshot *snapshot = new Snapshot();
+  snapshot->m_vertex_count = vertex_count;
+  snapshot->m_page_count = (vertex_count + PAGE_SIZE - 1) >> PAGE_BITS;
+  snapshot->m_pages = new AdjBlock **[snapshot->m_page_count > 0 ? snapshot->m_page_count : 1];
+  for (int p = 0; p < snapshot->m_page_count; ++p) {
+    snapshot->m_pages[p] = new AdjBlock *[PAGE_SIZE]();
+  }
+  m_current.store(snapshot);
+}
+
+/**
+ * *****************************************************************
+ * @brief : Destroy the VersionedGraph< E>:: VersionedGraph object，调用时不能再有读者
+ * @tparam E
+ * *****************************************************************
+ */
+template <typename E>
+inline VersionedGraph<E>::~VersionedGraph() {
+  // 退役对象与当前快照互不重叠，分别释放
+  while (m_retired != nullptr) {
+    RetiredBatch *batch = m_retired;
+    m_retired = batch->m_next;
+    for (int i = 0; i < batch->m_block_count; ++i) {
+      HelpFreeBlock(batch->m_blocks[i]);
+    }
+    for (int i = 0; i < batch->m_page_count; ++i) {
+      delete[] batch->m_pages[i];
+    }
+    delete[] batch->m_blocks;
+    delete[] batch->m_pages;
+    delete batch->m_snapshot;
+    delete batch;
+  }
+
+  Snapshot *snapshot = m_current.load();
+  for (int p = 0; p < snapshot->m_page_count; ++p) {
+    for (int i = 0; i < PAGE_SIZE; ++i) {
+      HelpFreeBlock(snapshot->m_pages[p][i]);
+    }
+    delete[] snapshot->m_pages[p];
+  }
+  delete snapshot;
+
+  delete[] m_pending;
+  delete[] m_reader_epochs;
+  delete[] m_reader_used;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 释放邻接块
+ * @tparam E
+ * @param  block
+ * *****************************************************************
+ */
+template <typename E>
+inline void VersionedGraph<E>::HelpFreeBlock(AdjBlock *block) {
+  if (block != nullptr) {
+    delete[] block->m_targets;
+    delete[] block->m_weights;
+    delete block;
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 把一条弧的更新放入缓冲区，调用者持有写锁
+ * @tparam E
+ * @param  src
+ * @param  dest
+ * @param  weight
+ * @param  remove
+ * *****************************************************************
+ */
+template <typename E>
+inline void VersionedGraph<E>::HelpPushUpdate(int src, int dest, const E &weight, bool remove) {
+  if (m_pending_count == m_pending_capacity) {
+    m_pending_capacity = m_pending_capacity == 0 ? 64 : m_pending_capacity * 2;
+    ArcUpdate *new_pending = new ArcUpdate[m_pending_capacity];
+    for (int i = 0; i < m_pending_count; ++i) {
+      new_pending[i] = m_pending[i];
+    }
+    delete[] m_pending;
+    m_pending = new_pending;
+  }
+
+  ArcUpdate &update = m_pending[m_pending_count];
+  update.m_src = src;
+  update.m_dest = dest;
+  update.m_weight = weight;
+  update.m_remove = remove;
+  update.m_sequence = m_pending_count;
+  ++m_pending_count;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 回收所有读者都已离开的退役对象，调用者持有写锁。
+ *          纪元为 r 的退役对象在所有正在读的读者登记的纪元都大于 r 时释放：
+ *          登记纪元大于 r 的读者一定是在替换快照之后才读取的快照指针
+ * @tparam E
+ * *****************************************************************
+ */
+template <typename E>
+inline void VersionedGraph<E>::HelpReclaim() {
+  unsigned long long min_epoch = m_global_epoch.load();
+  for (int i = 0; i < m_max_readers; ++i) {
+    unsigned long long epoch = m_reader_epochs[i].load();
+    if (epoch != 0 && epoch < min_epoch) {
+      min_epoch = epoch;
+    }
+  }
+
+  RetiredBatch **link = &m_retired;
+  while (*link != nullptr) {
+    RetiredBatch *batch = *link;
+    if (batch->m_epoch >= min_epoch) {
+      link = &batch->m_next;
+      continue;
+    }
+
+    *link = batch->m_next;
+    for (int i = 0; i < batch->m_block_count; ++i) {
+      HelpFreeBlock(batch->m_blocks[i]);
+    }
+    for (int i = 0; i < batch->m_page_count; ++i) {
+      delete[] batch->m_pages[i];
+    }
+    delete[] batch->m_blocks;
+    delete[] batch->m_pages;
+    delete batch->m_snapshot;
+    delete batch;
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 插入顶点
+ * @tparam E
+ * @return int 新顶点的索引，发布后可见
+ * *****************************************************************
+ */
+template <typename E>
+inline int VersionedGraph<E>::InsertVertex() {
+  std::lock_guard<std::mutex> lock(m_write_mutex);
+  return m_pending_vertex_count++;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 插入边或弧，已存在时更新权值，发布后可见
+ * @tparam E
+ * @param  src
+ * @param  dest
+ * @param  weight
+ * @return true
+ * @return false 顶点不存在
+ * *****************************************************************
+ */
+template <typename E>
+inline bool VersionedGraph<E>::InsertEdge(int src, int dest, const E &weight) {
+  std::lock_guard<std::mutex> lock(m_write_mutex);
+  if (src < 0 || src >= m_pending_vertex_count || dest < 0 || dest >= m_pending_vertex_count) {
+    return false;
+  }
+
+  HelpPushUpdate(src, dest, weight, false);
+  if (!m_is_directed && src != dest) {
+    HelpPushUpdate(dest, src, weight, false);
+  }
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 删除边或弧，发布后可见，弧不存在时发布时忽略
+ * @tparam E
+ * @param  src
+ * @param  dest
+ * @return true
+ * @return false 顶点不存在
+ * *****************************************************************
+ */
+template <typename E>
+inline bool VersionedGraph<E>::RemoveEdge(int src, int dest) {
+  std::lock_guard<std::mutex> lock(m_write_mutex);
+  if (src < 0 || src >= m_pending_vertex_count || dest < 0 || dest >= m_pending_vertex_count) {
+    return false;
+  }
+
+  HelpPushUpdate(src, dest, E(), true);
+  if (!m_is_directed && src != dest) {
+    HelpPushUpdate(dest, src, E(), true);
+  }
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 把 CSR 快照中的弧原样放入缓冲区（无向图的 CSR 已经含有两个方向的弧），顶点不够时补齐
+ * @tparam E
+ * @param  csr
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename E>
+inline bool VersionedGraph<E>::Load(const CSRGraph<E> &csr) {
+  std::lock_guard<std::mutex> lock(m_write_mutex);
+  if (csr.GetVertexCount() > m_pending_vertex_count) {
+    m_pending_vertex_count = csr.GetVertexCount();
+  }
+
+  for (int u = 0; u < csr.GetVertexCount(); ++u) {
+    const int *neighbors = csr.GetNeighbors(u);
+    const E *weights = csr.GetWeights(u);
+    for (int k = 0; k < csr.GetDegree(u); ++k) {
+      HelpPushUpdate(u, neighbors[k], weights[k], false);
+    }
+  }
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 合并缓冲区并发布新快照。更新按 (源顶点, 目标顶点, 次序) 排序，
+ *          每个被修改的顶点把旧邻接块与自己的更新归并成新邻接块，同一条弧只取最后一次更新
+ * @tparam E
+ * @return long long 新版本号，没有更新时返回当前版本号
+ * *****************************************************************
+ */
+template <typename E>
+inline long long VersionedGraph<E>::Publish() {
+  std::lock_guard<std::mutex> lock(m_write_mutex);
+
+  Snapshot *old_snapshot = m_current.load();
+  if (m_pending_count == 0 && m_pending_vertex_count == old_snapshot->m_vertex_count) {
+    return old_snapshot->m_version;
+  }
+
+  std::sort(m_pending, m_pending + m_pending_count, [](const ArcUpdate &a, const ArcUpdate &b) {
+    if (a.m_src != b.m_src) {
+      return a.m_src < b.m_src;
+    }
+    if (a.m_dest != b.m_dest) {
+      return a.m_dest < b.m_dest;
+    }
+    return a.m_sequence < b.m_sequence;
+  });
+
+  // 新快照的页表，旧页先共享
+  Snapshot *snapshot = new Snapshot();
+  snapshot->m_version = old_snapshot->m_version + 1;
+  snapshot->m_vertex_count = m_pending_vertex_count;
+  snapshot->m_page_count = (m_pending_vertex_count + PAGE_SIZE - 1) >> PAGE_BITS;
+  snapshot->m_pages = new AdjBlock **[snapshot->m_page_count > 0 ? snapshot->m_page_count : 1];
+  for (int p = 0; p < snapshot->m_page_count; ++p) {
+    snapshot->m_pages[p] = p < old_snapshot->m_page_count ? old_snapshot->m_pages[p] : new AdjBlock *[PAGE_SIZE]();
+  }
+
+  RetiredBatch *batch = new RetiredBatch();
+  batch->m_snapshot = old_snapshot;
+  batch->m_blocks = new AdjBlock *[m_pending_count > 0 ? m_pending_count : 1];
+  batch->m_block_count = 0;
+  batch->m_pages = new AdjBlock **[old_snapshot->m_page_count > 0 ? old_snapshot->m_page_count : 1];
+  batch->m_page_count = 0;
+
+  // 本次发布中已经复制过的旧页
+  bool *page_copied = new bool[snapshot->m_page_count > 0 ? snapshot->m_page_count : 1];
+  for (int p = 0; p < snapshot->m_page_count; ++p) {
+    page_copied[p] = p >= old_snapshot->m_page_count;
+  }
+
+  long long edge_count = old_snapshot->m_edge_count;
+  int begin = 0;
+  while (begin < m_pending_count) {
+    int src = m_pending[begin].m_src;
+    int end = begin;
+    while (end < m_pending_count && m_pending[end].m_src == src) {
+      ++end;
+    }
+
+    int page = src >> PAGE_BITS;
+    AdjBlock *old_block = snapshot->m_pages[page][src & (PAGE_SIZE - 1)];
+    int old_degree = old_block ? old_block->m_degree : 0;
+
+    // 归并旧邻接块和更新，新邻接块至多有 old_degree + (end - begin) 个邻接顶点
+    int capacity = old_degree + (end - begin);
+    int *targets = new int[capacity];
+    E *weights = new E[capacity];
+    int degree = 0;
+    int i = 0;
+    int j = begin;
+    while (i < old_degree || j < end) {
+      if (j == end || (i < old_degree && old_block->m_targets[i] < m_pending[j].m_dest)) {
+        targets[degree] = old_block->m_targets[i];
+        weights[degree++] = old_block->m_weights[i++];
+        continue;
+      }
+
+      // 同一条弧的最后一次更新
+      int dest = m_pending[j].m_dest;
+      while (j + 1 < end && m_pending[j + 1].m_dest == dest) {
+        ++j;
+      }
+      if (i < old_degree && old_block->m_targets[i] == dest) {
+        ++i; // 旧弧被覆盖或删除
+      }
+      if (!m_pending[j].m_remove) {
+        targets[degree] = dest;
+        weights[degree++] = m_pending[j].m_weight;
+      }
+      ++j;
+    }
+
+    AdjBlock *block = nullptr;
+    if (degree > 0) {
+      block = new AdjBlock();
+      block->m_degree = degree;
+      block->m_targets = targets;
+      block->m_weights = weights;
+    } else {
+      delete[] targets;
+      delete[] weights;
+    }
+    edge_count += degree - old_degree;
+
+    // 写时复制所在的页
+    if (!page_copied[page]) {
+      AdjBlock **new_page = new AdjBlock *[PAGE_SIZE];
+      for (int k = 0; k < PAGE_SIZE; ++k) {
+        new_page[k] = snapshot->m_pages[page][k];
+      }
+      batch->m_pages[batch->m_page_count++] = snapshot->m_pages[page];
+      snapshot->m_pages[page] = new_page;
+      page_copied[page] = true;
+    }
+    snapshot->m_pages[page][src & (PAGE_SIZE - 1)] = block;
+    if (old_block != nullptr) {
+      batch->m_blocks[batch->m_block_count++] = old_block;
+    }
+
+    begin = end;
+  }
+  snapshot->m_edge_count = edge_count;
+  delete[] page_copied;
+  m_pending_count = 0;
+
+  // 先替换快照，再推进纪元，之后登记的读者一定看到新快照
+  m_current.store(snapshot);
+  batch->m_epoch = m_global_epoch.fetch_add(1);
+  batch->m_next = m_retired;
+  m_retired = batch;
+
+  HelpReclaim();
+  return snapshot->m_version;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 缓冲区中尚未发布的更新个数，无向图每条边计两次
+ * @tparam E
+ * @return int
+ * *****************************************************************
+ */
+template <typename E>
+inline int VersionedGraph<E>::GetPendingCount() {
+  std::lock_guard<std::mutex> lock(m_write_mutex);
+  return m_pending_count;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 尝试回收退役对象，长时间没有发布而读者都已离开时可以主动调用
+ * @tparam E
+ * *****************************************************************
+ */
+template <typename E>
+inline void VersionedGraph<E>::Reclaim() {
+  std::lock_guard<std::mutex> lock(m_write_mutex);
+  HelpReclaim();
+}
+
+/**
+ * *****************************************************************
+ * @brief : 注册读者，每个读者线程占用一个槽位
+ * @tparam E
+ * @return int 槽位，槽位用完时返回 -1
+ * *****************************************************************
+ */
+template <typename E>
+inline int VersionedGraph<E>::RegisterReader() {
+  for (int i = 0; i < m_max_readers; ++i) {
+    bool expected = false;
+    if (m_reader_used[i].compare_exchange_strong(expected, true)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 注销读者
+ * @tparam E
+ * @param  reader
+ * *****************************************************************
+ */
+template <typename E>
+inline void VersionedGraph<E>::UnregisterReader(int reader) {
+  if (reader < 0 || reader >= m_max_readers) {
+    return;
+  }
+  m_reader_epochs[reader].store(0);
+  m_reader_used[reader].store(false);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 进入读：先登记当前纪元，再读取快照指针
+ * @tparam E
+ * @param  reader
+ * @return const Snapshot* 最新快照，在 Release 之前一直有效；槽位非法时返回 nullptr
+ * *****************************************************************
+ */
+template <typename E>
+inline const typename VersionedGraph<E>::Snapshot *VersionedGraph<E>::Acquire(int reader) {
+  if (reader < 0 || reader >= m_max_readers) {
+    return nullptr;
+  }
+  m_reader_epochs[reader].store(m_global_epoch.load());
+  return m_current.load();
+}
+
+/**
+ * *****************************************************************
+ * @brief : 退出读
+ * @tparam E
+ * @param  reader
+ * *****************************************************************
+ */
+template <typename E>
+inline void VersionedGraph<E>::Release(int reader) {
+  if (reader < 0 || reader >= m_max_readers) {
+    return;
+  }
+  m_reader_epochs[reader].store(0);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 最新发布的版本号
+ * @tparam E
+ * @return long long
+ * *****************************************************************
+ */
+template <typename E>
+inline long long VersionedGraph<E>::GetVersion() const {
+  return m_current.load()->m_version;
+}
+
+} // namespace bu_tools
+
+#endif // _VERSIONEDGRAPH_H_
@@ -0,0 +1,231 @@
+/**
+ * ************************************************************************
+ * @filename: sparseanalysis.h
+ *
+ * @brief : 稀疏矩阵的统计与结构分析
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-23
+ *
+ * ************************************************************************
+ */
+
+#ifndef _SPARSEANALYSIS_H_
+#define _SPARSEANALYSIS_H_
+
+#include "../csr/compressedsparsematrix.h"
+#include <algorithm>
+#include <cmath>
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 稀疏矩阵的统计结果。
+ *          行（列）非零元素个数的直方图按 2 的幂分桶：第 0 桶为空行，第 k 桶为 [2^(k-1), 2^k)
+ * *****************************************************************
+ */
+struct SparseStatistics {
+  static const int HISTOGRAM_BUCKETS = 32; // 直方图的桶数
+  static const int MAX_BLOCK_SIZE = 4;     // 统计块密度的最大块边长
+
+  int m_rows;           // 行数
+  int m_cols;           // 列数
+  long long m_total;    // 非零元素个数
+  double m_density;     // 非零元素占全部元素的比例
+
+  int m_row_min;        // 每行非零元素个数的最小值
+  int m_row_max;        // 每行非零元素个数的最大值
+  double m_row_mean;    // 每行非零元素个数的平均值
+  double m_row_stddev;  // 每行非零元素个数的标准差，与平均值相比越大行越不均匀
+  int m_empty_rows;     // 空行数
+  int m_col_min;        // 每列非零元素个数的最小值
+  int m_col_max;        // 每列非零元素个数的最大值
+  double m_col_mean;    // 每列非零元素个数的平均值
+  int m_empty_cols;     // 空列数
+  int m_row_histogram[HISTOGRAM_BUCKETS]; // 行非零元素个数的直方图
+  int m_col_histogram[HISTOGRAM_BUCKETS]; // 列非零元素个数的直方图
+
+  int m_lower_bandwidth; // 下带宽：非零元素 i - j 的最大值，没有时为 0
+  int m_upper_bandwidth; // 上带宽：非零元素 j - i 的最大值，没有时为 0
+  int m_diagonal_count;  // 对角线上的非零元素个数
+
+  // 块密度：按 B * B 分块时非零元素占所有非零块容量的比例，下标为 B，下标 0 不用。
+  // 接近 1 说明分块存储几乎不补零
+  double m_block_density[MAX_BLOCK_SIZE + 1];
+
+  // 对称性，只对方阵统计，否则为 0：
+  // 结构对称度为非对角非零元素中 (j, i) 也非零的比例，数值对称度为其中两者值相等的比例
+  double m_structural_symmetry;
+  double m_numerical_symmetry;
+};
+
+/**
+ * *****************************************************************
+ * @brief : 统计的辅助函数
+ * *****************************************************************
+ */
+class SparseAnalysisHelper {
+public:
+  // 非零元素个数所在的直方图桶
+  static int Bucket(int count) {
+    int bucket = 0;
+    while (count > 0 && bucket < SparseStatistics::HISTOGRAM_BUCKETS - 1) {
+      count >>= 1;
+      ++bucket;
+    }
+    return bucket;
+  }
+};
+
+/**
+ * *****************************************************************
+ * @brief : 统计块边长为 B 时的非零块个数：每个块行用标记数组数出不同的块列，按块行并行
+ * @tparam T
+ * @param  matrix
+ * @param  B 块边长
+ * @return long long 非零块个数
+ * *****************************************************************
+ */
+template <typename T>
+inline long long CountBlocks(const CSRSparseMatrix<T> &matrix, int B) {
+  const int rows = matrix.GetRows();
+  const int block_rows = (rows + B - 1) / B;
+  const int block_cols = (matrix.GetCols() + B - 1) / B;
+  const int *offsets = matrix.GetOffsets();
+  const int *indices = matrix.GetIndices();
+
+  long long blocks = 0;
+#pragma omp parallel num_threads(MatrixThreads(matrix.GetTotal())) reduction(+ : blocks)
+  {
+    int *mark = new int[block_cols > 0 ? block_cols : 1];
+    std::fill(mark, mark + block_cols, -1);
+#pragma omp for schedule(dynamic, 64)
+    for (int br = 0; br < block_rows; ++br) {
+      int end = offsets[std::min(rows, (br + 1) * B)];
+      for (int k = offsets[br * B]; k < end; ++k) {
+        int bc = indices[k] / B;
+        if (mark[bc] != br) {
+          mark[bc] = br;
+          ++blocks;
+        }
+      }
+    }
+    delete[] mark;
+  }
+  return blocks;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 分析 CSR 矩阵的结构，O(t * 块边长数 + 行数 + 列数)。其他格式先用 Convert 转换。
+ *          对称性借助转置（CSC 的列就是转置的行）逐行归并比较
+ * @tparam T
+ * @param  matrix 每行列号严格递增
+ * @param  statistics 统计结果
+ * *****************************************************************
+ */
+template <typename T>
+inline void Analyze(const CSRSparseMatrix<T> &matrix, SparseStatistics &statistics) {
+  const int rows = matrix.GetRows();
+  const int cols = matrix.GetCols();
+  const int total = matrix.GetTotal();
+  const int *offsets = matrix.GetOffsets();
+  const int *indices = matrix.GetIndices();
+  const T *values = matrix.GetValues();
+
+  statistics.m_rows = rows;
+  statistics.m_cols = cols;
+  statistics.m_total = total;
+  statistics.m_density = rows > 0 && cols > 0 ? static_cast<double>(total) / rows / cols : 0.0;
+  std::fill(statistics.m_row_histogram, statistics.m_row_histogram + SparseStatistics::HISTOGRAM_BUCKETS, 0);
+  std::fill(statistics.m_col_histogram, statistics.m_col_histogram + SparseStatistics::HISTOGRAM_BUCKETS, 0);
+
+  // 行统计和带宽
+  statistics.m_row_min = rows > 0 ? offsets[1] - offsets[0] : 0;
+  statistics.m_row_max = 0;
+  statistics.m_empty_rows = 0;
+  statistics.m_lower_bandwidth = 0;
+  statistics.m_upper_bandwidth = 0;
+  statistics.m_diagonal_count = 0;
+  double square_sum = 0.0;
+  for (int i = 0; i < rows; ++i) {
+    int count = offsets[i + 1] - offsets[i];
+    statistics.m_row_min = std::min(statistics.m_row_min, count);
+    statistics.m_row_max = std::max(statistics.m_row_max, count);
+    statistics.m_empty_rows += count == 0;
+    ++statistics.m_row_histogram[SparseAnalysisHelper::Bucket(count)];
+    square_sum += static_cast<double>(count) * count;
+
+    if (count > 0) {
+      // 列号有序，只看首尾
+      statistics.m_lower_bandwidth = std::max(statistics.m_lower_bandwidth, i - indices[offsets[i]]);
+      statistics.m_upper_bandwidth = std::max(statistics.m_upper_bandwidth, indices[offsets[i + 1] - 1] - i);
+      const int *found = std::lower_bound(indices + offsets[i], indices + offsets[i + 1], i);
+      statistics.m_diagonal_count += found != indices + offsets[i + 1] && *found == i;
+    }
+  }
+  statistics.m_row_mean = rows > 0 ? static_cast<double>(total) / rows : 0.0;
+  statistics.m_row_stddev =
+      rows > 0 ? std::sqrt(std::max(0.0, square_sum / rows - statistics.m_row_mean * statistics.m_row_mean)) : 0.0;
+
+  // 列统计，转置同时用于对称性
+  CSCSparseMatrix<T> transpose;
+  matrix.ConvertTo(transpose);
+  const int *t_offsets = transpose.GetOffsets();
+  const int *t_indices = transpose.GetIndices();
+  const T *t_values = transpose.GetValues();
+
+  statistics.m_col_min = cols > 0 ? t_offsets[1] - t_offsets[0] : 0;
+  statistics.m_col_max = 0;
+  statistics.m_empty_cols = 0;
+  for (int j = 0; j < cols; ++j) {
+    int count = t_offsets[j + 1] - t_offsets[j];
+    statistics.m_col_min = std::min(statistics.m_col_min, count);
+    statistics.m_col_max = std::max(statistics.m_col_max, count);
+    statistics.m_empty_cols += count == 0;
+    ++statistics.m_col_histogram[SparseAnalysisHelper::Bucket(count)];
+  }
+  statistics.m_col_mean = cols > 0 ? static_cast<double>(total) / cols : 0.0;
+
+  // 块密度
+  statistics.m_block_density[0] = 0.0;
+  for (int b = 1; b <= SparseStatistics::MAX_BLOCK_SIZE; ++b) {
+    long long blocks = CountBlocks(matrix, b);
+    statistics.m_block_density[b] = blocks > 0 ? static_cast<double>(total) / (blocks * b * b) : 0.0;
+  }
+
+  // 对称性：第 i 行与转置的第 i 行（第 i 列）逐个归并
+  statistics.m_structural_symmetry = 0.0;
+  statistics.m_numerical_symmetry = 0.0;
+  if (rows == cols) {
+    long long off_diagonal = 0;
+    long long matched = 0;
+    long long equal = 0;
+#pragma omp parallel for num_threads(MatrixThreads(total)) schedule(dynamic, 256) \
+    reduction(+ : off_diagonal, matched, equal)
+    for (int i = 0; i < rows; ++i) {
+      int q = t_offsets[i];
+      for (int p = offsets[i]; p < offsets[i + 1]; ++p) {
+        int j = indices[p];
+        if (j == i) {
+          continue;
+        }
+        ++off_diagonal;
+        while (q < t_offsets[i + 1] && t_indices[q] < j) {
+          ++q;
+        }
+        if (q < t_offsets[i + 1] && t_indices[q] == j) {
+          ++matched;
+          equal += values[p] == t_values[q];
+        }
+      }
+    }
+    statistics.m_structural_symmetry = off_diagonal > 0 ? static_cast<double>(matched) / off_diagonal : 1.0;
+    statistics.m_numerical_symmetry = off_diagonal > 0 ? static_cast<double>(equal) / off_diagonal : 1.0;
+  }
+}
+
+} // namespace bu_tools
+
+#endif // _SPARSEANALYSIS_H_
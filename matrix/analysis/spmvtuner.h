@@ -0,0 +1,229 @@
+/**
+ * ************************************************************************
+ * @filename: spmvtuner.h
+ *
+ * @brief : 稀疏矩阵乘向量的格式自动选择
+ *
+ *          在实际矩阵上逐个建立候选格式，对各自的 Multiply 计时，选出最快的一种。
+ *          统计结果用于剪枝：块密度过低的 BSR 补零太多，不必测
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-23
+ *
+ * ************************************************************************
+ */
+
+#ifndef _SPMVTUNER_H_
+#define _SPMVTUNER_H_
+
+#include "../bsr/bsrsparsematrix.h"
+#include "../csr/sparseconvert.h"
+#include "sparseanalysis.h"
+#include <chrono>
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 候选的存储格式
+ * *****************************************************************
+ */
+enum class SparseFormat {
+  Triplet, // 三元组表
+  Cross,   // 十字链表
+  CSR,     // 压缩行
+  CSC,     // 压缩列
+  BSR2,    // 2 * 2 分块压缩行
+  BSR3,    // 3 * 3 分块压缩行
+  BSR4,    // 4 * 4 分块压缩行
+};
+
+const int SPARSE_FORMAT_COUNT = 7; // 候选格式的个数
+
+inline const char *GetFormatName(SparseFormat format) {
+  static const char *names[SPARSE_FORMAT_COUNT] = {"Triplet", "Cross", "CSR", "CSC", "BSR2", "BSR3", "BSR4"};
+  return names[static_cast<int>(format)];
+}
+
+/**
+ * *****************************************************************
+ * @brief : SpMV 格式自动选择。建立格式的时间不计入，每种格式用完即释放，
+ *          同一时刻只多占用一份矩阵的内存
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+class SpMVTuner {
+  /*****************************************************************
+
+  数据域
+
+  *****************************************************************/
+protected:
+  int m_repeat;                          //每种格式计时的次数，取最短的一次
+  double m_min_block_density;            //BSR 候选要求的最低块密度
+  double m_seconds[SPARSE_FORMAT_COUNT]; //每种格式一次乘法的用时（秒），没有测的为 -1
+  SparseFormat m_best;                   //最快的格式
+  SparseStatistics m_statistics;         //最近一次分析的统计结果
+
+  /*****************************************************************
+
+  辅助函数
+
+  *****************************************************************/
+protected:
+  template <typename F>
+  double HelpTime(F run) const;
+  template <int B>
+  void HelpTimeBSR(const TripletSparseMatrix<T> &triplet, SparseFormat format, const T *x, T *y);
+
+  /*****************************************************************
+
+  接口
+
+  *****************************************************************/
+public:
+  explicit SpMVTuner(int repeat = 5, double min_block_density = 0.5);
+
+  SparseFormat Tune(const CSRSparseMatrix<T> &matrix); // 对所有候选格式计时，返回最快的一种
+  SparseFormat GetBest() const { return m_best; }
+  double GetSeconds(SparseFormat format) const { return m_seconds[static_cast<int>(format)]; }
+  const SparseStatistics &GetStatistics() const { return m_statistics; }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+成员函数的定义
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * *****************************************************************
+ * @brief : 构造函数
+ * @tparam T
+ * @param  repeat 每种格式计时的次数
+ * @param  min_block_density 块密度低于此值的 BSR 不参与计时
+ * *****************************************************************
+ */
+template <typename T>
+inline SpMVTuner<T>::SpMVTuner(int repeat, double min_block_density)
+    : m_repeat(repeat > 0 ? repeat : 1), m_min_block_density(min_block_density), m_best(SparseFormat::CSR),
+      m_statistics() {
+  std::fill(m_seconds, m_seconds + SPARSE_FORMAT_COUNT, -1.0);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 一次 run 的最短用时。先运行一次预热并估计用时，小矩阵每次计时连续运行多次，
+ *          使一次计时不短于约 1 毫秒，减小时钟精度的影响
+ * @tparam T
+ * @tparam F 无参数的可调用对象
+ * @param  run
+ * @return double 秒
+ * *****************************************************************
+ */
+template <typename T>
+template <typename F>
+inline double SpMVTuner<T>::HelpTime(F run) const {
+  auto begin = std::chrono::steady_clock::now();
+  run();
+  double warmup = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+  int inner = 1;
+  if (warmup < 1e-3) {
+    inner = warmup > 1e-6 ? static_cast<int>(1e-3 / warmup) + 1 : 1000;
+  }
+
+  double best = -1.0;
+  for (int r = 0; r < m_repeat; ++r) {
+    begin = std::chrono::steady_clock::now();
+    for (int k = 0; k < inner; ++k) {
+      run();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() / inner;
+    if (best < 0 || seconds < best) {
+      best = seconds;
+    }
+  }
+  return best;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 块密度足够时建立 B * B 的 BSR 并计时
+ * @tparam T
+ * @tparam B 块边长
+ * @param  triplet 同一矩阵的三元组表
+ * @param  format 对应的格式
+ * @param  x
+ * @param  y
+ * *****************************************************************
+ */
+template <typename T>
+template <int B>
+inline void SpMVTuner<T>::HelpTimeBSR(const TripletSparseMatrix<T> &triplet, SparseFormat format, const T *x,
+                                      T *y) {
+  if (m_statistics.m_block_density[B] < m_min_block_density) {
+    return;
+  }
+  BSRSparseMatrix<T, B> bsr;
+  bsr.Load(triplet);
+  m_seconds[static_cast<int>(format)] = HelpTime([&]() { bsr.Multiply(x, y); });
+}
+
+/**
+ * *****************************************************************
+ * @brief : 分析矩阵，再依次建立各候选格式并对 Multiply 计时，x 取全 1
+ * @tparam T
+ * @param  matrix
+ * @return SparseFormat 最快的格式
+ * *****************************************************************
+ */
+template <typename T>
+inline SparseFormat SpMVTuner<T>::Tune(const CSRSparseMatrix<T> &matrix) {
+  std::fill(m_seconds, m_seconds + SPARSE_FORMAT_COUNT, -1.0);
+  Analyze(matrix, m_statistics);
+
+  const int rows = matrix.GetRows();
+  const int cols = matrix.GetCols();
+  T *x = new T[cols > 0 ? cols : 1];
+  T *y = new T[rows > 0 ? rows : 1];
+  std::fill(x, x + cols, T(1));
+
+  m_seconds[static_cast<int>(SparseFormat::CSR)] = HelpTime([&]() { matrix.Multiply(x, y); });
+  {
+    CSCSparseMatrix<T> csc;
+    matrix.ConvertTo(csc);
+    m_seconds[static_cast<int>(SparseFormat::CSC)] = HelpTime([&]() { csc.Multiply(x, y); });
+  }
+  {
+    CrossSparseMatrix<T> cross(rows, cols);
+    Convert(matrix, cross);
+    m_seconds[static_cast<int>(SparseFormat::Cross)] = HelpTime([&]() { cross.Multiply(x, y); });
+  }
+  {
+    // BSR 由三元组表建立，先测三元组表再复用
+    TripletSparseMatrix<T> triplet;
+    Convert(matrix, triplet);
+    m_seconds[static_cast<int>(SparseFormat::Triplet)] = HelpTime([&]() { triplet.Multiply(x, y); });
+    HelpTimeBSR<2>(triplet, SparseFormat::BSR2, x, y);
+    HelpTimeBSR<3>(triplet, SparseFormat::BSR3, x, y);
+    HelpTimeBSR<4>(triplet, SparseFormat::BSR4, x, y);
+  }
+
+  delete[] x;
+  delete[] y;
+
+  m_best = SparseFormat::CSR;
+  for (int f = 0; f < SPARSE_FORMAT_COUNT; ++f) {
+    if (m_seconds[f] >= 0 && m_seconds[f] < m_seconds[static_cast<int>(m_best)]) {
+      m_best = static_cast<SparseFormat>(f);
+    }
+  }
+  return m_best;
+}
+
+} // namespace bu_tools
+
+#endif // _SPMVTUNER_H_
@@ -0,0 +1,178 @@
+/**
+ * ************************************************************************
+ * @filename: test_sparseanalysis.cpp
+ *
+ * @brief : 测试稀疏矩阵的统计分析和 SpMV 格式自动选择
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-23
+ *
+ * ************************************************************************
+ */
+
+#include "spmvtuner.h"
+#include <cstdlib>
+#include <iostream>
+
+using std::cout;
+
+void BuildBlockPoisson(int m, bu_tools::CSRSparseMatrix<double> &matrix);
+void BuildRandom(int n, int per_row, bu_tools::CSRSparseMatrix<double> &matrix);
+void PrintStatistics(const bu_tools::SparseStatistics &statistics);
+void test_Analyze();
+void test_Tune();
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+主函数
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, const char *argv[]) {
+  test_Analyze();
+  test_Tune();
+
+  return 0;
+}
+
+/**
+ * *****************************************************************
+ * @brief : m * m 网格上的五点差分，每个网格点 3 个自由度，相邻点之间是稠密的 3 * 3 块，矩阵对称
+ * @param  m
+ * @param  matrix
+ * *****************************************************************
+ */
+void BuildBlockPoisson(int m, bu_tools::CSRSparseMatrix<double> &matrix) {
+  const int n = m * m * 3;
+  int *offsets = new int[n + 1];
+  int *indices = new int[n * 15];
+  double *values = new double[n * 15];
+
+  int total = 0;
+  for (int node = 0; node < m * m; ++node) {
+    int i = node / m;
+    int j = node % m;
+    int neighbours[5];
+    int count = 0;
+    if (i > 0) {
+      neighbours[count++] = node - m;
+    }
+    if (j > 0) {
+      neighbours[count++] = node - 1;
+    }
+    neighbours[count++] = node;
+    if (j < m - 1) {
+      neighbours[count++] = node + 1;
+    }
+    if (i < m - 1) {
+      neighbours[count++] = node + m;
+    }
+
+    for (int a = 0; a < 3; ++a) {
+      offsets[node * 3 + a] = total;
+      for (int k = 0; k < count; ++k) {
+        for (int b = 0; b < 3; ++b) {
+          indices[total] = neighbours[k] * 3 + b;
+          values[total++] = neighbours[k] == node ? (a == b ? 12.0 : 1.0) : -1.0;
+        }
+      }
+    }
+  }
+  offsets[n] = total;
+
+  bu_tools::TripletSparseMatrix<double> triplet;
+  triplet.LoadCSR(n, n, offsets, indices, values);
+  bu_tools::Convert(triplet, matrix);
+  delete[] offsets;
+  delete[] indices;
+  delete[] values;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 每行 per_row 个随机位置（可能重复）的非对称矩阵
+ * @param  n
+ * @param  per_row
+ * @param  matrix
+ * *****************************************************************
+ */
+void BuildRandom(int n, int per_row, bu_tools::CSRSparseMatrix<double> &matrix) {
+  double *dense = new double[n * n]();
+  for (int i = 0; i < n; ++i) {
+    for (int k = 0; k < per_row; ++k) {
+      dense[i * n + std::rand() % n] = std::rand() % 9 + 1;
+    }
+  }
+  matrix.LoadDense(n, n, dense);
+  delete[] dense;
+}
+
+void PrintStatistics(const bu_tools::SparseStatistics &statistics) {
+  cout << statistics.m_rows << " * " << statistics.m_cols << "，非零元素 " << statistics.m_total << "，密度 "
+       << statistics.m_density << "\n";
+  cout << "每行非零元素 " << statistics.m_row_min << " ~ " << statistics.m_row_max << "，平均 "
+       << statistics.m_row_mean << "，标准差 " << statistics.m_row_stddev << "，空行 " << statistics.m_empty_rows
+       << "\n";
+  cout << "每列非零元素 " << statistics.m_col_min << " ~ " << statistics.m_col_max << "，平均 "
+       << statistics.m_col_mean << "，空列 " << statistics.m_empty_cols << "\n";
+  cout << "行直方图：";
+  for (int k = 0; k < bu_tools::SparseStatistics::HISTOGRAM_BUCKETS; ++k) {
+    if (statistics.m_row_histogram[k] > 0) {
+      cout << "[" << (k == 0 ? 0 : 1 << (k - 1)) << "," << (1 << k) << ")=" << statistics.m_row_histogram[k] << " ";
+    }
+  }
+  cout << "\n";
+  cout << "带宽 " << statistics.m_lower_bandwidth << " / " << statistics.m_upper_bandwidth << "，对角元 "
+       << statistics.m_diagonal_count << "\n";
+  cout << "块密度";
+  for (int b = 1; b <= bu_tools::SparseStatistics::MAX_BLOCK_SIZE; ++b) {
+    cout << " " << b << "*" << b << "=" << statistics.m_block_density[b];
+  }
+  cout << "\n";
+  cout << "结构对称度 " << statistics.m_structural_symmetry << "，数值对称度 " << statistics.m_numerical_symmetry
+       << "\n\n";
+}
+
+void test_Analyze() {
+  bu_tools::SparseStatistics statistics;
+
+  // 3 * 3 块结构：3 * 3 块密度为 1，完全对称
+  bu_tools::CSRSparseMatrix<double> block;
+  BuildBlockPoisson(20, block);
+  bu_tools::Analyze(block, statistics);
+  PrintStatistics(statistics);
+
+  // 随机矩阵：块密度低，几乎不对称
+  bu_tools::CSRSparseMatrix<double> random;
+  BuildRandom(300, 4, random);
+  bu_tools::Analyze(random, statistics);
+  PrintStatistics(statistics);
+}
+
+void test_Tune() {
+  bu_tools::CSRSparseMatrix<double> block;
+  BuildBlockPoisson(100, block);
+  bu_tools::CSRSparseMatrix<double> random;
+  BuildRandom(2000, 8, random);
+
+  bu_tools::SpMVTuner<double> tuner;
+  const bu_tools::CSRSparseMatrix<double> *matrices[2] = {&block, &random};
+  for (int i = 0; i < 2; ++i) {
+    bu_tools::SparseFormat best = tuner.Tune(*matrices[i]);
+    cout << matrices[i]->GetRows() << " 阶矩阵每次 SpMV 用时（微秒）：";
+    for (int f = 0; f < bu_tools::SPARSE_FORMAT_COUNT; ++f) {
+      bu_tools::SparseFormat format = static_cast<bu_tools::SparseFormat>(f);
+      double seconds = tuner.GetSeconds(format);
+      cout << bu_tools::GetFormatName(format) << "=";
+      if (seconds < 0) {
+        cout << "跳过 ";
+      } else {
+        cout << seconds * 1e6 << " ";
+      }
+    }
+    cout << "\n最快：" << bu_tools::GetFormatName(best) << "\n";
+  }
+}
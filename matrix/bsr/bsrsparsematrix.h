@@ -0,0 +1,519 @@
+/**
+ * ************************************************************************
+ * @filename: bsrsparsematrix.h
+ *
+ * @brief : 稀疏矩阵（分块压缩行 BSR）
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-21
+ *
+ * ************************************************************************
+ */
+
+#ifndef _BSRSPARSEMATRIX_H_
+#define _BSRSPARSEMATRIX_H_
+
+#include "../tuple/tripletsparsematrix.h"
+#include <algorithm>
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : B * B 稠密块的乘法核心，块内按行优先存放。通用版本是定长循环，
+ *          内层循环标记为 simd 由编译器向量化；常用的 3、4 在下面特化为完全展开
+ * @tparam T
+ * @tparam B 块的边长
+ * *****************************************************************
+ */
+template <typename T, int B>
+struct BSRBlockKernel {
+  // y[0, B) += block * x[0, B)
+  static void MultiplyVector(const T *block, const T *x, T *y) {
+    for (int i = 0; i < B; ++i) {
+      T sum = T();
+#pragma omp simd reduction(+ : sum)
+      for (int j = 0; j < B; ++j) {
+        sum += block[i * B + j] * x[j];
+      }
+      y[i] += sum;
+    }
+  }
+
+  // Y[0, B) += block * X[0, B)，X、Y 每行 k 个元素，行距分别为 x_stride、y_stride
+  static void MultiplyMatrix(const T *block, const T *x, int x_stride, T *y, int y_stride, int k) {
+    for (int i = 0; i < B; ++i) {
+      T *y_row = y + static_cast<long long>(i) * y_stride;
+      for (int j = 0; j < B; ++j) {
+        const T a = block[i * B + j];
+        const T *x_row = x + static_cast<long long>(j) * x_stride;
+#pragma omp simd
+        for (int l = 0; l < k; ++l) {
+          y_row[l] += a * x_row[l];
+        }
+      }
+    }
+  }
+};
+
+/**
+ * *****************************************************************
+ * @brief : 3 * 3 块，完全展开
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+struct BSRBlockKernel<T, 3> {
+  static void MultiplyVector(const T *block, const T *x, T *y) {
+    const T x0 = x[0], x1 = x[1], x2 = x[2];
+    y[0] += block[0] * x0 + block[1] * x1 + block[2] * x2;
+    y[1] += block[3] * x0 + block[4] * x1 + block[5] * x2;
+    y[2] += block[6] * x0 + block[7] * x1 + block[8] * x2;
+  }
+
+  static void MultiplyMatrix(const T *block, const T *x, int x_stride, T *y, int y_stride, int k) {
+    const T *x0 = x;
+    const T *x1 = x + x_stride;
+    const T *x2 = x + 2LL * x_stride;
+    T *y0 = y;
+    T *y1 = y + y_stride;
+    T *y2 = y + 2LL * y_stride;
+#pragma omp simd
+    for (int l = 0; l < k; ++l) {
+      const T a = x0[l], b = x1[l], c = x2[l];
+      y0[l] += block[0] * a + block[1] * b + block[2] * c;
+      y1[l] += block[3] * a + block[4] * b + block[5] * c;
+      y2[l] += block[6] * a + block[7] * b + block[8] * c;
+    }
+  }
+};
+
+/**
+ * *****************************************************************
+ * @brief : 4 * 4 块，完全展开
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+struct BSRBlockKernel<T, 4> {
+  static void MultiplyVector(const T *block, const T *x, T *y) {
+    const T x0 = x[0], x1 = x[1], x2 = x[2], x3 = x[3];
+    y[0] += block[0] * x0 + block[1] * x1 + block[2] * x2 + block[3] * x3;
+    y[1] += block[4] * x0 + block[5] * x1 + block[6] * x2 + block[7] * x3;
+    y[2] += block[8] * x0 + block[9] * x1 + block[10] * x2 + block[11] * x3;
+    y[3] += block[12] * x0 + block[13] * x1 + block[14] * x2 + block[15] * x3;
+  }
+
+  static void MultiplyMatrix(const T *block, const T *x, int x_stride, T *y, int y_stride, int k) {
+    const T *x0 = x;
+    const T *x1 = x + x_stride;
+    const T *x2 = x + 2LL * x_stride;
+    const T *x3 = x + 3LL * x_stride;
+    T *y0 = y;
+    T *y1 = y + y_stride;
+    T *y2 = y + 2LL * y_stride;
+    T *y3 = y + 3LL * y_stride;
+#pragma omp simd
+    for (int l = 0; l < k; ++l) {
+      const T a = x0[l], b = x1[l], c = x2[l], d = x3[l];
+      y0[l] += block[0] * a + block[1] * b + block[2] * c + block[3] * d;
+      y1[l] += block[4] * a + block[5] * b + block[6] * c + block[7] * d;
+      y2[l] += block[8] * a + block[9] * b + block[10] * c + block[11] * d;
+      y3[l] += block[12] * a + block[13] * b + block[14] * c + block[15] * d;
+    }
+  }
+};
+
+/**
+ * *****************************************************************
+ * @brief : 分块压缩行稀疏矩阵：矩阵划分为 B * B 的块，只存放含非零元素的块，块内稠密存放。
+ *          第 br 块行的块存放在 [m_offsets[br], m_offsets[br + 1]) 中，m_indices 为块列号，
+ *          每块 B * B 个值按行优先存放在 m_values 中。每 B * B 个值只需要一个下标，
+ *          块本身较满时比三元组表省去大部分下标。行列数不是 B 的倍数时末尾的块补零
+ * @tparam T
+ * @tparam B 块的边长
+ * *****************************************************************
+ */
+template <typename T, int B>
+class BSRSparseMatrix {
+  static_assert(B > 0, "block size must be positive");
+
+  /*****************************************************************
+
+  数据域
+
+  *****************************************************************/
+protected:
+  int m_rows;        //行数
+  int m_cols;        //列数
+  int m_block_rows;  //块行数
+  int m_block_cols;  //块列数
+  int m_block_total; //非零块个数
+  int *m_offsets;    //每个块行的起始位置，长度为块行数 + 1
+  int *m_indices;    //每个块的块列号
+  T *m_values;       //所有块的值，每块 B * B 个
+
+  /*****************************************************************
+
+  成员函数的声明
+
+  *****************************************************************/
+private:
+  void HelpMultiplyEdge(const T *block, int block_row, int block_col, const T *x, T *y) const;
+
+public:
+  BSRSparseMatrix() : m_rows(0), m_cols(0), m_block_rows(0), m_block_cols(0), m_block_total(0), m_offsets(nullptr),
+                      m_indices(nullptr), m_values(nullptr) {
+    Resize(0, 0, 0);
+  }
+  BSRSparseMatrix(const BSRSparseMatrix &other);
+  BSRSparseMatrix &operator=(const BSRSparseMatrix &other);
+
+  //移动构造函数
+  BSRSparseMatrix(BSRSparseMatrix &&other) noexcept
+      : m_rows(0), m_cols(0), m_block_rows(0), m_block_cols(0), m_block_total(0), m_offsets(nullptr),
+        m_indices(nullptr), m_values(nullptr) {
+    *this = std::move(other);
+  }
+
+  //移动赋值运算符
+  BSRSparseMatrix &operator=(BSRSparseMatrix &&other) noexcept {
+    if (this != &other) {
+      std::swap(m_rows, other.m_rows);
+      std::swap(m_cols, other.m_cols);
+      std::swap(m_block_rows, other.m_block_rows);
+      std::swap(m_block_cols, other.m_block_cols);
+      std::swap(m_block_total, other.m_block_total);
+      std::swap(m_offsets, other.m_offsets);
+      std::swap(m_indices, other.m_indices);
+      std::swap(m_values, other.m_values);
+    }
+    return *this;
+  }
+
+  virtual ~BSRSparseMatrix() {
+    delete[] m_offsets;
+    delete[] m_indices;
+    delete[] m_values;
+  }
+
+  void Resize(int r, int c, int block_total); // 重新分配存储空间，起始位置置零，下标和值未初始化
+  void Load(const TripletSparseMatrix<T> &matrix); // 由三元组表建立
+  int GetRows() const { return m_rows; }
+  int GetCols() const { return m_cols; }
+  int GetBlockRows() const { return m_block_rows; }
+  int GetBlockCols() const { return m_block_cols; }
+  int GetBlockTotal() const { return m_block_total; }
+  bool GetValue(int r, int c, T &e) const; // 块内补的零也返回 true
+
+  void Multiply(const T *x, T *y) const;              // y = A * x
+  void MultiplyMatrix(const T *x, T *y, int k) const; // Y = A * X，X 为列数 * k，Y 为行数 * k，都按行优先
+
+  // 直接访问底层数组
+  const int *GetOffsets() const { return m_offsets; }
+  const int *GetIndices() const { return m_indices; }
+  const T *GetValues() const { return m_values; }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+成员函数的定义
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * *****************************************************************
+ * @brief : 拷贝构造函数
+ * @tparam T
+ * @tparam B
+ * @param  other
+ * *****************************************************************
+ */
+template <typename T, int B>
+inline BSRSparseMatrix<T, B>::BSRSparseMatrix(const BSRSparseMatrix &other)
+    : m_rows(0), m_cols(0), m_block_rows(0), m_block_cols(0), m_block_total(0), m_offsets(nullptr),
+      m_indices(nullptr), m_values(nullptr) {
+  *this = other;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 重载赋值运算符
+ * @tparam T
+ * @tparam B
+ * @param  other
+ * @return BSRSparseMatrix&
+ * *****************************************************************
+ */
+template <typename T, int B>
+inline BSRSparseMatrix<T, B> &BSRSparseMatrix<T, B>::operator=(const BSRSparseMatrix &other) {
+  if (this != &other) {
+    Resize(other.m_rows, other.m_cols, other.m_block_total);
+    std::copy(other.m_offsets, other.m_offsets + m_block_rows + 1, m_offsets);
+    std::copy(other.m_indices, other.m_indices + m_block_total, m_indices);
+    std::copy(other.m_values, other.m_values + static_cast<long long>(m_block_total) * B * B, m_values);
+  }
+  return *this;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 重新分配存储空间，起始位置全部置零，下标和值未初始化，由调用者填充
+ * @tparam T
+ * @tparam B
+ * @param  r 行数
+ * @param  c 列数
+ * @param  block_total 非零块个数
+ * *****************************************************************
+ */
+template <typename T, int B>
+inline void BSRSparseMatrix<T, B>::Resize(int r, int c, int block_total) {
+  delete[] m_offsets;
+  delete[] m_indices;
+  delete[] m_values;
+
+  m_rows = r;
+  m_cols = c;
+  m_block_rows = (r + B - 1) / B;
+  m_block_cols = (c + B - 1) / B;
+  m_block_total = block_total;
+  m_offsets = new int[m_block_rows + 1]();
+  m_indices = new int[block_total > 0 ? block_total : 1];
+  m_values = new T[block_total > 0 ? static_cast<long long>(block_total) * B * B : 1];
+}
+
+/**
+ * *****************************************************************
+ * @brief : 由三元组表建立，替换原有内容。三元组按行有序，一个块行对应一段连续的三元组：
+ *          第一遍每个块行用标记数组数出不同的块列，求出起始位置；第二遍各块行把块列排好，
+ *          再把值散到块内。两遍都按块行并行，每个线程一份标记数组，O(t + 非零块数 * B * B)
+ * @tparam T
+ * @tparam B
+ * @param  matrix
+ * *****************************************************************
+ */
+template <typename T, int B>
+inline void BSRSparseMatrix<T, B>::Load(const TripletSparseMatrix<T> &matrix) {
+  typedef typename TripletSparseMatrix<T>::Iterator Iterator;
+  const int rows = matrix.GetRows();
+  const int cols = matrix.GetCols();
+  const int block_rows = (rows + B - 1) / B;
+  const int block_cols = (cols + B - 1) / B;
+  const int threads = MatrixThreads(matrix.GetTolal());
+
+  // 第一遍：数出每个块行中不同的块列，mark[块列] 记录最近一次出现在哪个块行
+  int *counts = new int[block_rows + 1]();
+#pragma omp parallel num_threads(threads)
+  {
+    int *mark = new int[block_cols > 0 ? block_cols : 1];
+    std::fill(mark, mark + block_cols, -1);
+#pragma omp for schedule(dynamic, 64)
+    for (int br = 0; br < block_rows; ++br) {
+      int count = 0;
+      Iterator end = matrix.RowBegin((br + 1) * B);
+      for (Iterator it = matrix.RowBegin(br * B); it != end; ++it) {
+        int bc = it->m_col / B;
+        if (mark[bc] != br) {
+          mark[bc] = br;
+          ++count;
+        }
+      }
+      counts[br + 1] = count;
+    }
+    delete[] mark;
+  }
+  for (int br = 0; br < block_rows; ++br) {
+    counts[br + 1] += counts[br];
+  }
+
+  Resize(rows, cols, counts[block_rows]);
+  std::copy(counts, counts + block_rows + 1, m_offsets);
+  delete[] counts;
+
+  // 第二遍：块列排序后记下每个块列在本块行中的位置，块清零后把值散进去
+#pragma omp parallel num_threads(threads)
+  {
+    int *mark = new int[block_cols > 0 ? block_cols : 1];
+    int *slot = new int[block_cols > 0 ? block_cols : 1];
+    std::fill(mark, mark + block_cols, -1);
+#pragma omp for schedule(dynamic, 64)
+    for (int br = 0; br < block_rows; ++br) {
+      Iterator begin = matrix.RowBegin(br * B);
+      Iterator end = matrix.RowBegin((br + 1) * B);
+      int position = m_offsets[br];
+      for (Iterator it = begin; it != end; ++it) {
+        int bc = it->m_col / B;
+        if (mark[bc] != br) {
+          mark[bc] = br;
+          m_indices[position++] = bc;
+        }
+      }
+      std::sort(m_indices + m_offsets[br], m_indices + m_offsets[br + 1]);
+
+      for (int k = m_offsets[br]; k < m_offsets[br + 1]; ++k) {
+        slot[m_indices[k]] = k;
+        T *block = m_values + static_cast<long long>(k) * B * B;
+        std::fill(block, block + B * B, T());
+      }
+      for (Iterator it = begin; it != end; ++it) {
+        T *block = m_values + static_cast<long long>(slot[it->m_col / B]) * B * B;
+        block[(it->m_row % B) * B + it->m_col % B] = it->m_value;
+      }
+    }
+    delete[] slot;
+    delete[] mark;
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 获取值，在块行内二分查找块列
+ * @tparam T
+ * @tparam B
+ * @param  r
+ * @param  c
+ * @param  e
+ * @return true 所在的块存在（块内补的零也算）
+ * @return false 越界或所在的块不存在
+ * *****************************************************************
+ */
+template <typename T, int B>
+inline bool BSRSparseMatrix<T, B>::GetValue(int r, int c, T &e) const {
+  if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) {
+    return false;
+  }
+
+  int br = r / B;
+  int bc = c / B;
+  const int *begin = m_indices + m_offsets[br];
+  const int *end = m_indices + m_offsets[br + 1];
+  const int *found = std::lower_bound(begin, end, bc);
+  if (found == end || *found != bc) {
+    return false;
+  }
+
+  e = m_values[static_cast<long long>(found - m_indices) * B * B + (r % B) * B + c % B];
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 越过矩阵边界的块（行列数不是 B 的倍数时的最后一个块行、块列），只用边界内的部分
+ * @tparam T
+ * @tparam B
+ * @param  block
+ * @param  block_row
+ * @param  block_col
+ * @param  x 整个向量
+ * @param  y 本块行的局部结果，长度 B
+ * *****************************************************************
+ */
+template <typename T, int B>
+inline void BSRSparseMatrix<T, B>::HelpMultiplyEdge(const T *block, int block_row, int block_col, const T *x, T *y) const {
+  int height = std::min(B, m_rows - block_row * B);
+  int width = std::min(B, m_cols - block_col * B);
+  const T *x_part = x + block_col * B;
+  for (int i = 0; i < height; ++i) {
+    for (int j = 0; j < width; ++j) {
+      y[i] += block[i * B + j] * x_part[j];
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 稀疏矩阵乘向量 y = A * x，按块行并行，每块调用按块大小特化的核心
+ * @tparam T
+ * @tparam B
+ * @param  x 长度为列数
+ * @param  y 长度为行数
+ * *****************************************************************
+ */
+template <typename T, int B>
+inline void BSRSparseMatrix<T, B>::Multiply(const T *x, T *y) const {
+  const int threads = MatrixThreads(static_cast<long long>(m_block_total) * B * B);
+  const bool ragged_cols = m_cols % B != 0;
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 64)
+  for (int br = 0; br < m_block_rows; ++br) {
+    T sum[B];
+    for (int i = 0; i < B; ++i) {
+      sum[i] = T();
+    }
+
+    bool ragged_row = (br + 1) * B > m_rows;
+    for (int k = m_offsets[br]; k < m_offsets[br + 1]; ++k) {
+      const T *block = m_values + static_cast<long long>(k) * B * B;
+      int bc = m_indices[k];
+      if (ragged_row || (ragged_cols && bc == m_block_cols - 1)) {
+        HelpMultiplyEdge(block, br, bc, x, sum);
+      } else {
+        BSRBlockKernel<T, B>::MultiplyVector(block, x + bc * B, sum);
+      }
+    }
+
+    int height = std::min(B, m_rows - br * B);
+    for (int i = 0; i < height; ++i) {
+      y[br * B + i] = sum[i];
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 稀疏矩阵乘稠密矩阵 Y = A * X，按块行并行。每个块对 X 的 B 行做一次
+ *          长度为 k 的向量化更新，A 的每个块只读一次
+ * @tparam T
+ * @tparam B
+ * @param  x 列数 * k，行优先
+ * @param  y 行数 * k，行优先
+ * @param  k X、Y 的列数
+ * *****************************************************************
+ */
+template <typename T, int B>
+inline void BSRSparseMatrix<T, B>::MultiplyMatrix(const T *x, T *y, int k) const {
+  const int threads = MatrixThreads(static_cast<long long>(m_block_total) * B * B * k);
+  const bool ragged_cols = m_cols % B != 0;
+
+#pragma omp parallel num_threads(threads)
+  {
+    T *buffer = new T[static_cast<long long>(B) * k]; // 本块行的结果，越界的块行也有 B 行可写
+
+#pragma omp for schedule(dynamic, 16)
+    for (int br = 0; br < m_block_rows; ++br) {
+      std::fill(buffer, buffer + static_cast<long long>(B) * k, T());
+
+      bool ragged_row = (br + 1) * B > m_rows;
+      for (int p = m_offsets[br]; p < m_offsets[br + 1]; ++p) {
+        const T *block = m_values + static_cast<long long>(p) * B * B;
+        int bc = m_indices[p];
+        const T *x_part = x + static_cast<long long>(bc) * B * k;
+        if (ragged_row || (ragged_cols && bc == m_block_cols - 1)) {
+          int height = std::min(B, m_rows - br * B);
+          int width = std::min(B, m_cols - bc * B);
+          for (int i = 0; i < height; ++i) {
+            for (int j = 0; j < width; ++j) {
+              const T a = block[i * B + j];
+              for (int l = 0; l < k; ++l) {
+                buffer[static_cast<long long>(i) * k + l] += a * x_part[static_cast<long long>(j) * k + l];
+              }
+            }
+          }
+        } else {
+          BSRBlockKernel<T, B>::MultiplyMatrix(block, x_part, k, buffer, k, k);
+        }
+      }
+
+      int height = std::min(B, m_rows - br * B);
+      std::copy(buffer, buffer + static_cast<long long>(height) * k, y + static_cast<long long>(br) * B * k);
+    }
+
+    delete[] buffer;
+  }
+}
+
+} // namespace bu_tools
+
+#endif // _BSRSPARSEMATRIX_H_
@@ -0,0 +1,114 @@
+/**
+ * ************************************************************************
+ * @filename: test_bsrsparsematrix.cpp
+ *
+ * @brief : 测试分块压缩行稀疏矩阵
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-21
+ *
+ * ************************************************************************
+ */
+
+#include "bsrsparsematrix.h"
+#include <iomanip>
+#include <iostream>
+
+using std::cout;
+using std::setw;
+
+void test_Load();
+void test_Multiply();
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+主函数
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, const char *argv[]) {
+  test_Load();
+  test_Multiply();
+
+  return 0;
+}
+
+void test_Load() {
+  // 7 * 7 的矩阵，按 3 * 3 分块，最后一个块行、块列补零
+  bu_tools::TripletSparseMatrix<int> triplet(7, 7);
+  triplet.Insert(0, 0, 1);
+  triplet.Insert(1, 1, 2);
+  triplet.Insert(2, 2, 3);
+  triplet.Insert(0, 4, 4);
+  triplet.Insert(4, 1, 5);
+  triplet.Insert(6, 6, 6);
+  triplet.Insert(5, 3, 7);
+
+  bu_tools::BSRSparseMatrix<int, 3> bsr;
+  bsr.Load(triplet);
+  cout << "块行数 " << bsr.GetBlockRows() << "，块列数 " << bsr.GetBlockCols() << "，非零块 " << bsr.GetBlockTotal() << "\n";
+
+  for (int i = 0; i < bsr.GetRows(); ++i) {
+    for (int j = 0; j < bsr.GetCols(); ++j) {
+      int value = 0;
+      if (bsr.GetValue(i, j, value)) {
+        cout << setw(4) << value;
+      } else {
+        cout << setw(4) << ".";
+      }
+    }
+    cout << "\n";
+  }
+  cout << "（. 表示所在的块不存在）\n\n";
+}
+
+void test_Multiply() {
+  // 块三对角矩阵，每块 4 * 4
+  const int block_count = 3;
+  const int n = block_count * 4;
+  bu_tools::TripletSparseMatrix<double> triplet(n, n, n * 12);
+  for (int b = 0; b < block_count; ++b) {
+    for (int nb = b - 1; nb <= b + 1; ++nb) {
+      if (nb < 0 || nb >= block_count) {
+        continue;
+      }
+      for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+          triplet.Insert(b * 4 + i, nb * 4 + j, nb == b ? (i == j ? 4.0 : 1.0) : -1.0);
+        }
+      }
+    }
+  }
+
+  bu_tools::BSRSparseMatrix<double, 4> bsr;
+  bsr.Load(triplet);
+
+  double x[n];
+  double y[n];
+  for (int i = 0; i < n; ++i) {
+    x[i] = 1.0;
+  }
+  bsr.Multiply(x, y);
+  cout << "A * 1 =";
+  for (int i = 0; i < n; ++i) {
+    cout << " " << y[i];
+  }
+  cout << "\n";
+
+  // X 的两列分别为全 1 和下标
+  double xs[n * 2];
+  double ys[n * 2];
+  for (int i = 0; i < n; ++i) {
+    xs[i * 2] = 1.0;
+    xs[i * 2 + 1] = i;
+  }
+  bsr.MultiplyMatrix(xs, ys, 2);
+  cout << "A * X 第二列 =";
+  for (int i = 0; i < n; ++i) {
+    cout << " " << ys[i * 2 + 1];
+  }
+  cout << "\n";
+}
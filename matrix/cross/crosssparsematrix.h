@@ -14,6 +14,7 @@
 #ifndef _CROSSSPARSEMATRIX_H_
 #define _CROSSSPARSEMATRIX_H_
 
+#include "../matrixthreads.h"
 #include <algorithm>
 namespace bu_tools {
 
@@ -52,6 +53,27 @@ private:
 
   typedef Node *NodePointer;
 
+  /*****************************************************************
+
+  嵌套行索引类：一行的结点按列有序存放在数组中，查找时二分，列号单独存放以减少指针跳转
+
+  *****************************************************************/
+
+  class RowIndex {
+  public:
+    int m_count;          //结点个数
+    int *m_cols;          //列号，严格递增
+    NodePointer *m_nodes; //对应的结点
+
+    explicit RowIndex(int count) : m_count(count), m_cols(new int[count]), m_nodes(new NodePointer[count]) {}
+    RowIndex(const RowIndex &other) = delete;
+    RowIndex &operator=(const RowIndex &other) = delete;
+    ~RowIndex() {
+      delete[] m_cols;
+      delete[] m_nodes;
+    }
+  };
+
 protected:
   /*****************************************************************
 
@@ -63,6 +85,36 @@ protected:
   int m_total;               //非零元素个数
   NodePointer *m_rows_heads; //行链表指针数组
   NodePointer *m_cols_heads; //列链表指针数组
+  NodePointer *m_rows_tails; //行链表尾指针数组，按行列顺序追加时不必遍历链表
+  NodePointer *m_cols_tails; //列链表尾指针数组
+
+  // 结点池：结点按块分配，空闲结点通过 m_right 串联，清空时整块释放
+  NodePointer m_free_nodes;   //空闲结点链表
+  int m_free_count;           //空闲结点个数
+  NodePointer *m_node_blocks; //已分配的结点块
+  int m_block_count;          //结点块个数
+  int m_block_capacity;       //结点块指针数组容量
+
+  // 行索引（可选）：启用后长度不小于 m_index_threshold 的行都建有 RowIndex，GetValue 为 O(log k)。
+  // 索引只在修改矩阵的函数中建立：Insert 插入新结点后立即重建该行，批量建立的函数在结束时统一补建；
+  // 只修改值时索引仍然有效。GetValue 只读索引，没有索引的行沿链表查找
+  RowIndex **m_row_index; //每行的索引，未建立时为 nullptr；整个数组为 nullptr 表示未启用
+  int *m_row_lengths;     //启用时维护的每行结点个数
+  int m_index_threshold;  //建立索引的最短行长
+
+private:
+  void AllocateNodeBlock(int block_size);
+  NodePointer NewNode(int r, int c, const T &value);
+  void ReleaseNodes();
+  void HelpAllocateLists();
+  void HelpReshape(int r, int c);
+  void HelpAppend(NodePointer node);
+  void HelpCopyNodes(const CrossSparseMatrix<T> &other);
+  void HelpSwap(CrossSparseMatrix<T> &other);
+  void HelpLinkSum(const T &alpha, const CrossSparseMatrix<T> &a, const T &beta, const CrossSparseMatrix<T> &b);
+  void HelpBuildRowIndex(int r);
+  void HelpDropRowIndex(int r);
+  void HelpRefreshRowIndex();
 
 public:
   /*****************************************************************
@@ -71,69 +123,34 @@ public:
 
   *****************************************************************/
 
-  CrossSparseMatrix(int r, int c) : m_rows(r), m_cols(c), m_total(0) {
-    m_rows_heads = new NodePointer[m_rows];
-    m_cols_heads = new NodePointer[m_cols];
+  CrossSparseMatrix(int r, int c) : m_rows(r), m_cols(c), m_total(0), m_free_nodes(nullptr), m_free_count(0),
+                                    m_node_blocks(nullptr), m_block_count(0), m_block_capacity(0),
+                                    m_row_index(nullptr), m_row_lengths(nullptr), m_index_threshold(16) {
+    HelpAllocateLists();
   }
   virtual ~CrossSparseMatrix();
-  CrossSparseMatrix(const CrossSparseMatrix &other) : m_rows(other.m_rows), m_cols(other.m_cols), m_total(0) {
-    m_rows_heads = new NodePointer[m_rows];
-    m_cols_heads = new NodePointer[m_cols];
-
-    for (int i = 0; i < m_rows; ++i) {
-      NodePointer current = other.m_rows_heads[i];
-      while (current != nullptr) {
-        Insert(current->m_col, current->m_col, current->m_value);
-        current = current->m_right;
-      }
-    }
+  CrossSparseMatrix(const CrossSparseMatrix &other) : m_rows(other.m_rows), m_cols(other.m_cols), m_total(0),
+                                                      m_free_nodes(nullptr), m_free_count(0), m_node_blocks(nullptr),
+                                                      m_block_count(0), m_block_capacity(0), m_row_index(nullptr),
+                                                      m_row_lengths(nullptr), m_index_threshold(16) {
+    HelpAllocateLists();
+    HelpCopyNodes(other);
   }
 
-  //移动构造函数
-  CrossSparseMatrix(CrossSparseMatrix &&other) noexcept {
-    m_rows = other.m_rows;
-    m_cols = other.m_cols;
-    m_total = other.m_total;
-
-    m_rows_heads = new NodePointer[m_rows];
-    m_cols_heads = new NodePointer[m_cols];
-
-    for (int i = 0; i < m_rows; ++i) {
-      m_rows_heads[i] = other.m_rows_heads[i];
-      other.m_rows_heads[i] = nullptr;
-    }
-    for (int i = 0; i < m_cols; ++i) {
-      m_cols_heads[i] = other.m_cols_heads[i];
-      other.m_cols_heads[i] = nullptr;
-    }
-
-    delete[] other.m_rows_heads;
-    delete[] other.m_cols_heads;
-    other.m_total = 0;
+  //移动构造函数：结点和结点池一起接管
+  CrossSparseMatrix(CrossSparseMatrix &&other) noexcept : m_rows(0), m_cols(0), m_total(0), m_rows_heads(nullptr),
+                                                           m_cols_heads(nullptr), m_rows_tails(nullptr),
+                                                           m_cols_tails(nullptr), m_free_nodes(nullptr), m_free_count(0),
+                                                           m_node_blocks(nullptr), m_block_count(0), m_block_capacity(0),
+                                                           m_row_index(nullptr), m_row_lengths(nullptr),
+                                                           m_index_threshold(16) {
+    HelpSwap(other);
   }
 
   //移动赋值运算符
   CrossSparseMatrix &operator=(CrossSparseMatrix &&other) noexcept {
     if (this != &other) {
-      m_rows = other.m_rows;
-      m_cols = other.m_cols;
-      m_total = other.m_total;
-
-      m_rows_heads = new NodePointer[m_rows];
-      m_cols_heads = new NodePointer[m_cols];
-
-      for (int i = 0; i < m_rows; ++i) {
-        m_rows_heads[i] = other.m_rows_heads[i];
-        other.m_rows_heads[i] = nullptr;
-      }
-      for (int i = 0; i < m_cols; ++i) {
-        m_cols_heads[i] = other.m_cols_heads[i];
-        other.m_cols_heads[i] = nullptr;
-      }
-
-      delete[] other.m_rows_heads;
-      delete[] other.m_cols_heads;
-      other.m_total = 0;
+      HelpSwap(other);
     }
 
     return *this;
@@ -146,9 +163,25 @@ public:
   bool IsEmpty() const;
   bool Insert(int r, int c, const T &value);
   bool GetValue(int r, int c, T &e) const;
+  void Reserve(int node_capacity); //预留结点，批量插入前调用
+  bool LoadSorted(const int *rows, const int *cols, const T *values, int count); //按行优先有序的三元组一次建立
+
+  // 行索引，适合读远多于写的场合
+  void EnableRowIndex(int min_length = 16); //启用行索引并建立所有长行的索引
+  void DisableRowIndex();                   //释放行索引
+  bool IsRowIndexEnabled() const;           //是否启用了行索引
+  int GetIndexThreshold() const;            //建立索引的最短行长
+
+  // 与压缩格式的转换
+  void GetCSR(int *row_offsets, int *col_indices, T *values) const; //按行压缩导出
+  void GetCSC(int *col_offsets, int *row_indices, T *values) const; //按列压缩导出
+  void LoadCSR(int r, int c, const int *row_offsets, const int *col_indices, const T *values); //由按行压缩的数组建立
+
+  void Multiply(const T *x, T *y) const; //稀疏矩阵乘向量 y = 本矩阵 * x
 
   CrossSparseMatrix<T> &operator=(const CrossSparseMatrix<T> &other);
   CrossSparseMatrix<T> operator+(const CrossSparseMatrix<T> &other);
+  bool Axpy(const T &alpha, const CrossSparseMatrix<T> &other, const T &beta, CrossSparseMatrix<T> &result) const;
 };
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -161,55 +194,436 @@ public:
 
 /**
  * *****************************************************************
- * @brief : Destroy the Cross Sparse Matrix< T>:: Cross Sparse Matrix object
+ * @brief : 分配一整块结点，并挂到空闲链表上
  * @tparam T
+ * @param  block_size 本块的结点个数
  * *****************************************************************
  */
 template <typename T>
-inline CrossSparseMatrix<T>::~CrossSparseMatrix() {
-  Clear();
-  if (!m_rows_heads) {
-    delete[] m_rows_heads;
+inline void CrossSparseMatrix<T>::AllocateNodeBlock(int block_size) {
+  //结点块指针数组放满时扩容
+  if (m_block_count == m_block_capacity) {
+    m_block_capacity = m_block_capacity == 0 ? 8 : m_block_capacity * 2;
+    NodePointer *new_blocks = new NodePointer[m_block_capacity];
+    for (int i = 0; i < m_block_count; ++i) {
+      new_blocks[i] = m_node_blocks[i];
+    }
+    delete[] m_node_blocks;
+    m_node_blocks = new_blocks;
+  }
+
+  NodePointer block = new Node[block_size];
+  m_node_blocks[m_block_count++] = block;
+
+  //倒序串联，使得取结点的顺序与内存顺序一致
+  for (int i = block_size - 1; i >= 0; --i) {
+    block[i].m_right = m_free_nodes;
+    m_free_nodes = &block[i];
   }
+  m_free_count += block_size;
+}
 
-  if (!m_cols_heads) {
+/**
+ * *****************************************************************
+ * @brief : 从空闲链表中取出一个结点
+ * @tparam T
+ * @param  r
+ * @param  c
+ * @param  value
+ * @return NodePointer
+ * *****************************************************************
+ */
+template <typename T>
+inline typename CrossSparseMatrix<T>::NodePointer CrossSparseMatrix<T>::NewNode(int r, int c, const T &value) {
+  if (m_free_nodes == nullptr) {
+    //每次按已有结点数成倍增长，避免逐个分配
+    AllocateNodeBlock(m_total < 16 ? 16 : m_total);
+  }
+
+  NodePointer node = m_free_nodes;
+  m_free_nodes = node->m_right;
+  --m_free_count;
+
+  node->m_row = r;
+  node->m_col = c;
+  node->m_value = value;
+  node->m_right = nullptr;
+  node->m_down = nullptr;
+  return node;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 整块释放所有结点
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::ReleaseNodes() {
+  for (int i = 0; i < m_block_count; ++i) {
+    delete[] m_node_blocks[i];
+  }
+  m_block_count = 0;
+  m_free_nodes = nullptr;
+  m_free_count = 0;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 分配四个链表指针数组并置空
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::HelpAllocateLists() {
+  m_rows_heads = new NodePointer[m_rows]();
+  m_cols_heads = new NodePointer[m_cols]();
+  m_rows_tails = new NodePointer[m_rows]();
+  m_cols_tails = new NodePointer[m_cols]();
+}
+
+/**
+ * *****************************************************************
+ * @brief : 清空矩阵并改为 r 行 c 列，尺寸不变时不重新分配指针数组
+ * @tparam T
+ * @param  r
+ * @param  c
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::HelpReshape(int r, int c) {
+  Clear();
+  if (m_rows != r || m_cols != c) {
+    delete[] m_rows_heads;
     delete[] m_cols_heads;
+    delete[] m_rows_tails;
+    delete[] m_cols_tails;
+    m_rows = r;
+    m_cols = c;
+    HelpAllocateLists();
+
+    //行数变了，行索引按新的行数重新分配，Clear 已经释放了各行的索引
+    if (m_row_index != nullptr) {
+      delete[] m_row_index;
+      delete[] m_row_lengths;
+      m_row_index = new RowIndex *[m_rows]();
+      m_row_lengths = new int[m_rows]();
+    }
   }
 }
 
 /**
  * *****************************************************************
- * @brief : 置空,不改变结构,只清空结点
+ * @brief : 把结点接到所在行和所在列的末尾，O(1)。结点必须在该行、该列所有结点之后
  * @tparam T
+ * @param  node
  * *****************************************************************
  */
 template <typename T>
-inline void CrossSparseMatrix<T>::Clear() {
-  if (m_total == 0) {
-    return;
+inline void CrossSparseMatrix<T>::HelpAppend(NodePointer node) {
+  if (m_rows_tails[node->m_row] == nullptr) {
+    m_rows_heads[node->m_row] = node;
+  } else {
+    m_rows_tails[node->m_row]->m_right = node;
+  }
+  m_rows_tails[node->m_row] = node;
+
+  if (m_cols_tails[node->m_col] == nullptr) {
+    m_cols_heads[node->m_col] = node;
+  } else {
+    m_cols_tails[node->m_col]->m_down = node;
+  }
+  m_cols_tails[node->m_col] = node;
+  ++m_total;
+
+  if (m_row_index != nullptr) {
+    ++m_row_lengths[node->m_row];
+    HelpDropRowIndex(node->m_row);
   }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 复制 other 的全部结点，本矩阵必须为空且尺寸相同；按行生成，接到行尾和列尾，O(t + 行数)
+ * @tparam T
+ * @param  other
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::HelpCopyNodes(const CrossSparseMatrix<T> &other) {
+  Reserve(other.m_total);
 
-  //清空结点
   for (int i = 0; i < m_rows; ++i) {
-    NodePointer current = m_rows_heads[i];
-    while (current != nullptr) {
-      NodePointer to_delete = current;
-      current = current->m_right;
-      delete to_delete;
+    for (NodePointer current = other.m_rows_heads[i]; current != nullptr; current = current->m_right) {
+      HelpAppend(NewNode(i, current->m_col, current->m_value));
     }
   }
-  //将两个指针数组全部置空
+  HelpRefreshRowIndex();
+}
+
+/**
+ * *****************************************************************
+ * @brief : 交换两个矩阵的全部内容，包括结点池
+ * @tparam T
+ * @param  other
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::HelpSwap(CrossSparseMatrix<T> &other) {
+  std::swap(m_rows, other.m_rows);
+  std::swap(m_cols, other.m_cols);
+  std::swap(m_total, other.m_total);
+  std::swap(m_rows_heads, other.m_rows_heads);
+  std::swap(m_cols_heads, other.m_cols_heads);
+  std::swap(m_rows_tails, other.m_rows_tails);
+  std::swap(m_cols_tails, other.m_cols_tails);
+  std::swap(m_free_nodes, other.m_free_nodes);
+  std::swap(m_free_count, other.m_free_count);
+  std::swap(m_node_blocks, other.m_node_blocks);
+  std::swap(m_block_count, other.m_block_count);
+  std::swap(m_block_capacity, other.m_block_capacity);
+  std::swap(m_row_index, other.m_row_index);
+  std::swap(m_row_lengths, other.m_row_lengths);
+  std::swap(m_index_threshold, other.m_index_threshold);
+}
+
+/**
+ * *****************************************************************
+ * @brief : Destroy the Cross Sparse Matrix< T>:: Cross Sparse Matrix object
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+inline CrossSparseMatrix<T>::~CrossSparseMatrix() {
+  DisableRowIndex();
+  ReleaseNodes();
+  delete[] m_node_blocks;
+  delete[] m_rows_heads;
+  delete[] m_cols_heads;
+  delete[] m_rows_tails;
+  delete[] m_cols_tails;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 置空,不改变结构,只清空结点；结点整块释放，不再逐个删除
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::Clear() {
+  ReleaseNodes();
+
+  //将头、尾指针数组全部置空
   for (int i = 0; i < m_rows; ++i) {
     m_rows_heads[i] = nullptr;
+    m_rows_tails[i] = nullptr;
+  }
+
+  //行索引保持启用，各行的索引随结点一起释放
+  if (m_row_index != nullptr) {
+    for (int i = 0; i < m_rows; ++i) {
+      HelpDropRowIndex(i);
+      m_row_lengths[i] = 0;
+    }
   }
 
   for (int i = 0; i < m_cols; ++i) {
     m_cols_heads[i] = nullptr;
+    m_cols_tails[i] = nullptr;
   }
 
   m_total = 0;
 }
 
+/**
+ * *****************************************************************
+ * @brief : 预留结点，保证再插入 node_capacity - 非零元素个数 个元素不必分配
+ * @tparam T
+ * @param  node_capacity 非零元素个数的上限
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::Reserve(int node_capacity) {
+  int need = node_capacity - m_total - m_free_count;
+  if (need > 0) {
+    AllocateNodeBlock(need);
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 清空矩阵后按三元组一次建立，三元组必须按行优先严格递增（无重复），
+ *          每个结点直接接到行尾和列尾，O(count + 行数 + 列数)
+ * @tparam T
+ * @param  rows 行下标
+ * @param  cols 列下标
+ * @param  values 值
+ * @param  count 三元组个数
+ * @return true
+ * @return false 下标越界或无序，此时矩阵不变
+ * *****************************************************************
+ */
+template <typename T>
+inline bool CrossSparseMatrix<T>::LoadSorted(const int *rows, const int *cols, const T *values, int count) {
+  //先整体检查，出错时不改动矩阵
+  for (int k = 0; k < count; ++k) {
+    if (rows[k] < 0 || rows[k] >= m_rows || cols[k] < 0 || cols[k] >= m_cols) {
+      return false;
+    }
+    if (k > 0 && (rows[k] < rows[k - 1] || (rows[k] == rows[k - 1] && cols[k] <= cols[k - 1]))) {
+      return false;
+    }
+  }
+
+  Clear();
+  Reserve(count);
+  for (int k = 0; k < count; ++k) {
+    HelpAppend(NewNode(rows[k], cols[k], values[k]));
+  }
+  HelpRefreshRowIndex();
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 按行压缩（CSR）导出：先并行统计每行长度，求出起始位置后各行并行填充，O(t + 行数)
+ * @tparam T
+ * @param  row_offsets 长度为行数 + 1
+ * @param  col_indices 长度为非零元素个数
+ * @param  values 长度为非零元素个数，为 nullptr 时只导出结构
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::GetCSR(int *row_offsets, int *col_indices, T *values) const {
+  const int threads = MatrixThreads(m_total);
+
+  row_offsets[0] = 0;
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 256)
+  for (int i = 0; i < m_rows; ++i) {
+    int count = 0;
+    for (NodePointer current = m_rows_heads[i]; current != nullptr; current = current->m_right) {
+      ++count;
+    }
+    row_offsets[i + 1] = count;
+  }
+  for (int i = 0; i < m_rows; ++i) {
+    row_offsets[i + 1] += row_offsets[i];
+  }
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 256)
+  for (int i = 0; i < m_rows; ++i) {
+    int position = row_offsets[i];
+    for (NodePointer current = m_rows_heads[i]; current != nullptr; current = current->m_right) {
+      col_indices[position] = current->m_col;
+      if (values != nullptr) {
+        values[position] = current->m_value;
+      }
+      ++position;
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 按列压缩（CSC）导出，沿列链表进行，与 GetCSR 相同，不需要排序
+ * @tparam T
+ * @param  col_offsets 长度为列数 + 1
+ * @param  row_indices 长度为非零元素个数
+ * @param  values 长度为非零元素个数，为 nullptr 时只导出结构
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::GetCSC(int *col_offsets, int *row_indices, T *values) const {
+  const int threads = MatrixThreads(m_total);
+
+  col_offsets[0] = 0;
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 256)
+  for (int j = 0; j < m_cols; ++j) {
+    int count = 0;
+    for (NodePointer current = m_cols_heads[j]; current != nullptr; current = current->m_down) {
+      ++count;
+    }
+    col_offsets[j + 1] = count;
+  }
+  for (int j = 0; j < m_cols; ++j) {
+    col_offsets[j + 1] += col_offsets[j];
+  }
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 256)
+  for (int j = 0; j < m_cols; ++j) {
+    int position = col_offsets[j];
+    for (NodePointer current = m_cols_heads[j]; current != nullptr; current = current->m_down) {
+      row_indices[position] = current->m_row;
+      if (values != nullptr) {
+        values[position] = current->m_value;
+      }
+      ++position;
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 由按行压缩（CSR）的数组建立，替换原有内容，允许改变结构。每行内列号必须严格递增。
+ *          所有结点取自同一块，第 k 个元素就是块中第 k 个结点：结点内容和行链表按行并行生成，
+ *          列链表再按行优先顺序接到列尾，O(t + 行数 + 列数)
+ * @tparam T
+ * @param  r 行数
+ * @param  c 列数
+ * @param  row_offsets 长度为 r + 1
+ * @param  col_indices 长度为 row_offsets[r]
+ * @param  values 长度为 row_offsets[r]
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::LoadCSR(int r, int c, const int *row_offsets, const int *col_indices, const T *values) {
+  HelpReshape(r, c);
+
+  const int base = row_offsets[0];
+  const int total = row_offsets[r] - base;
+  if (total == 0) {
+    return;
+  }
+
+  //整块取出，不经过空闲链表
+  AllocateNodeBlock(total);
+  NodePointer block = m_node_blocks[m_block_count - 1];
+  m_free_nodes = nullptr;
+  m_free_count = 0;
+
+  const int threads = MatrixThreads(total);
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 256)
+  for (int i = 0; i < r; ++i) {
+    int begin = row_offsets[i] - base;
+    int end = row_offsets[i + 1] - base;
+    for (int k = begin; k < end; ++k) {
+      block[k].m_row = i;
+      block[k].m_col = col_indices[k + base];
+      block[k].m_value = values[k + base];
+      block[k].m_right = k + 1 < end ? &block[k + 1] : nullptr;
+      block[k].m_down = nullptr;
+    }
+    m_rows_heads[i] = begin < end ? &block[begin] : nullptr;
+    m_rows_tails[i] = begin < end ? &block[end - 1] : nullptr;
+    if (m_row_index != nullptr) {
+      m_row_lengths[i] = end - begin;
+    }
+  }
+
+  for (int k = 0; k < total; ++k) {
+    int col = block[k].m_col;
+    if (m_cols_tails[col] == nullptr) {
+      m_cols_heads[col] = &block[k];
+    } else {
+      m_cols_tails[col]->m_down = &block[k];
+    }
+    m_cols_tails[col] = &block[k];
+  }
+  m_total = total;
+  HelpRefreshRowIndex();
+}
+
 /**
  * *****************************************************************
  * @brief : 获取行
@@ -261,7 +675,8 @@ inline bool CrossSparseMatrix<T>::IsEmpty() const {
 
 /**
  * *****************************************************************
- * @brief : 插入元素
+ * @brief : 插入元素，已存在时修改值。位于行尾、列尾之后时 O(1)，否则需要遍历行链表和列链表。
+ *          启用行索引时，插入新结点还要 O(k) 重建该行的索引
  * @tparam T
  * @param  r
  * @param  c
@@ -276,52 +691,75 @@ inline bool CrossSparseMatrix<T>::Insert(int r, int c, const T &value) {
     return false;
   }
 
-  NodePointer new_node = new Node(r, c, value);
-
-  //插入到行链表中
-  if (m_rows_heads[r] == nullptr || m_rows_heads[r]->m_col > c) { //插入时是本行第一个结点
-    new_node->m_right = m_rows_heads[r];
-    m_rows_heads[r] = new_node;
+  NodePointer new_node;
+  if (m_rows_tails[r] == nullptr || m_rows_tails[r]->m_col < c) {
+    //在行尾之后：直接追加，按行优先顺序插入时总走这里
+    new_node = NewNode(r, c, value);
+    if (m_rows_tails[r] == nullptr) {
+      m_rows_heads[r] = new_node;
+    } else {
+      m_rows_tails[r]->m_right = new_node;
+    }
+    m_rows_tails[r] = new_node;
   } else {
+    //行索引已建立时先二分查找，存在时直接修改值
+    if (m_row_index != nullptr && m_row_index[r] != nullptr) {
+      const RowIndex *index = m_row_index[r];
+      const int *found = std::lower_bound(index->m_cols, index->m_cols + index->m_count, c);
+      if (found != index->m_cols + index->m_count && *found == c) {
+        index->m_nodes[found - index->m_cols]->m_value = value;
+        return true;
+      }
+    }
 
-    NodePointer current = m_rows_heads[r];
-    while (current->m_right != nullptr && current->m_right->m_col < c) {
-      current = current->m_right;
+    //在行链表中找到插入位置，存在同行同列的结点时只修改值
+    NodePointer *row_link = &m_rows_heads[r];
+    while ((*row_link)->m_col < c) {
+      row_link = &(*row_link)->m_right;
     }
-    if (current->m_right != nullptr && current->m_right->m_col == c) {
-      current->m_right->m_value = value;
-    } else {
-      new_node->m_right = current->m_right;
-      current->m_right = new_node;
+    if ((*row_link)->m_col == c) {
+      (*row_link)->m_value = value;
+      return true;
     }
-  }
 
-  //插入到列链表中
-  if (m_cols_heads[c] == nullptr || m_cols_heads[c]->m_row > r) { //插入时是本列的第一个结点
-    new_node->m_down = m_cols_heads[c];
-    m_cols_heads[c] = new_node;
-  } else {
-    NodePointer current = m_cols_heads[c];
-    while (current->m_down != nullptr && current->m_down->m_row < r) {
-      current = current->m_down;
-    }
+    new_node = NewNode(r, c, value);
+    new_node->m_right = *row_link;
+    *row_link = new_node;
+  }
 
-    //存在同行同列的情况
-    if (current->m_down != nullptr && current->m_down->m_row == r) {
-      current->m_down->m_value = value;
+  //插入到列链表中，同样先看能否接在列尾
+  if (m_cols_tails[c] == nullptr || m_cols_tails[c]->m_row < r) {
+    if (m_cols_tails[c] == nullptr) {
+      m_cols_heads[c] = new_node;
     } else {
-      new_node->m_down = current->m_down;
-      current->m_down = new_node;
+      m_cols_tails[c]->m_down = new_node;
     }
+    m_cols_tails[c] = new_node;
+  } else {
+    NodePointer *col_link = &m_cols_heads[c];
+    while ((*col_link)->m_row < r) {
+      col_link = &(*col_link)->m_down;
+    }
+    new_node->m_down = *col_link;
+    *col_link = new_node;
   }
 
   ++m_total;
+  if (m_row_index != nullptr) {
+    //新结点改变了该行的下标，立即重建，GetValue 不必修改索引
+    ++m_row_lengths[r];
+    HelpDropRowIndex(r);
+    if (m_row_lengths[r] >= m_index_threshold) {
+      HelpBuildRowIndex(r);
+    }
+  }
   return true;
 }
 
 /**
  * *****************************************************************
- * @brief : 获取值
+ * @brief : 获取值。该行建有索引时二分查找，O(log k)；否则沿行链表查找，列号有序，越过 c 即可停止。
+ *          不修改任何成员，多个线程可以同时查找
  * @tparam T
  * @param  r
  * @param  c
@@ -334,12 +772,22 @@ inline bool CrossSparseMatrix<T>::GetValue(int r, int c, T &e) const {
     return false;
   }
 
+  if (m_row_index != nullptr && m_row_index[r] != nullptr) {
+    const RowIndex *index = m_row_index[r];
+    const int *found = std::lower_bound(index->m_cols, index->m_cols + index->m_count, c);
+    if (found == index->m_cols + index->m_count || *found != c) {
+      return false;
+    }
+    e = index->m_nodes[found - index->m_cols]->m_value;
+    return true;
+  }
+
   NodePointer current = m_rows_heads[r];
-  while (current != nullptr && current->m_col != c) {
+  while (current != nullptr && current->m_col < c) {
     current = current->m_right;
   }
 
-  if (!current) {
+  if (current == nullptr || current->m_col != c) {
     return false;
   } else {
     e = current->m_value;
@@ -347,6 +795,132 @@ inline bool CrossSparseMatrix<T>::GetValue(int r, int c, T &e) const {
   }
 }
 
+/**
+ * *****************************************************************
+ * @brief : 建立第 r 行的索引，该行原来不能有索引
+ * @tparam T
+ * @param  r
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::HelpBuildRowIndex(int r) {
+  RowIndex *index = new RowIndex(m_row_lengths[r]);
+  int k = 0;
+  for (NodePointer current = m_rows_heads[r]; current != nullptr; current = current->m_right) {
+    index->m_cols[k] = current->m_col;
+    index->m_nodes[k++] = current;
+  }
+  m_row_index[r] = index;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 释放第 r 行的索引
+ * @tparam T
+ * @param  r
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::HelpDropRowIndex(int r) {
+  delete m_row_index[r];
+  m_row_index[r] = nullptr;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 启用行索引时，按行并行补建长行缺少的索引，释放短行的索引。批量建立结点后调用
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::HelpRefreshRowIndex() {
+  if (m_row_index == nullptr) {
+    return;
+  }
+
+#pragma omp parallel for num_threads(MatrixThreads(m_total)) schedule(dynamic, 256)
+  for (int i = 0; i < m_rows; ++i) {
+    if (m_row_lengths[i] < m_index_threshold) {
+      HelpDropRowIndex(i);
+    } else if (m_row_index[i] == nullptr) {
+      HelpBuildRowIndex(i);
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 启用行索引，并按行并行建立所有长度不小于 min_length 的行的索引，短行的索引释放。
+ *          之后矩阵的各个修改函数都会维护索引，GetValue 不修改索引，多个线程同时查找是安全的
+ * @tparam T
+ * @param  min_length 建立索引的最短行长，短行遍历链表更快
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::EnableRowIndex(int min_length) {
+  m_index_threshold = min_length > 1 ? min_length : 1;
+
+  if (m_row_index == nullptr) {
+    m_row_index = new RowIndex *[m_rows > 0 ? m_rows : 1]();
+    m_row_lengths = new int[m_rows > 0 ? m_rows : 1];
+#pragma omp parallel for num_threads(MatrixThreads(m_total)) schedule(dynamic, 256)
+    for (int i = 0; i < m_rows; ++i) {
+      int count = 0;
+      for (NodePointer current = m_rows_heads[i]; current != nullptr; current = current->m_right) {
+        ++count;
+      }
+      m_row_lengths[i] = count;
+    }
+  }
+
+  HelpRefreshRowIndex();
+}
+
+/**
+ * *****************************************************************
+ * @brief : 释放所有行索引，之后插入不再有维护开销
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::DisableRowIndex() {
+  if (m_row_index == nullptr) {
+    return;
+  }
+  for (int i = 0; i < m_rows; ++i) {
+    delete m_row_index[i];
+  }
+  delete[] m_row_index;
+  delete[] m_row_lengths;
+  m_row_index = nullptr;
+  m_row_lengths = nullptr;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 是否启用了行索引
+ * @tparam T
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename T>
+inline bool CrossSparseMatrix<T>::IsRowIndexEnabled() const {
+  return m_row_index != nullptr;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 建立索引的最短行长
+ * @tparam T
+ * @return int
+ * *****************************************************************
+ */
+template <typename T>
+inline int CrossSparseMatrix<T>::GetIndexThreshold() const {
+  return m_index_threshold;
+}
+
 /**
  * *****************************************************************
  * @brief : 重载赋值运算符
@@ -358,32 +932,64 @@ inline bool CrossSparseMatrix<T>::GetValue(int r, int c, T &e) const {
 template <typename T>
 inline CrossSparseMatrix<T> &CrossSparseMatrix<T>::operator=(const CrossSparseMatrix<T> &other) {
   if (this != &other) {
-    Clear(); //清空矩阵
-    delete[] m_rows_heads;
-    delete[] m_cols_heads;
-
     //允许改变结构
-    m_rows = other.m_rows;
-    m_cols = other.m_cols;
+    HelpReshape(other.m_rows, other.m_cols);
+    HelpCopyNodes(other);
+  }
 
-    m_rows_heads = new NodePointer[m_rows];
-    m_cols_heads = new NodePointer[m_cols];
+  return *this;
+}
 
-    for (int i = 0; i < m_rows; ++i) {
-      NodePointer current = other.m_rows_heads[i];
-      while (current != nullptr) {
-        Insert(current->m_row, current->m_col, current->m_value);
-        current = current->m_right;
+/**
+ * *****************************************************************
+ * @brief : 逐行归并 alpha * a + beta * b，结点直接接到行尾和列尾，不再逐个 Insert 查找位置，
+ *          O(t1 + t2 + 行数 + 列数)。本矩阵必须为空且尺寸与 a、b 相同，结果为零的元素丢弃
+ * @tparam T
+ * @param  alpha
+ * @param  a
+ * @param  beta
+ * @param  b
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::HelpLinkSum(const T &alpha, const CrossSparseMatrix<T> &a, const T &beta,
+                                              const CrossSparseMatrix<T> &b) {
+  //按行从上到下生成，每列的新结点总是接在该列的末尾
+  for (int i = 0; i < m_rows; ++i) {
+    NodePointer current_a = a.m_rows_heads[i];
+    NodePointer current_b = b.m_rows_heads[i];
+
+    while (current_a != nullptr || current_b != nullptr) {
+      int col;
+      T value;
+      if (current_b == nullptr || (current_a != nullptr && current_a->m_col < current_b->m_col)) {
+        col = current_a->m_col;
+        value = alpha * current_a->m_value;
+        current_a = current_a->m_right;
+      } else if (current_a == nullptr || current_a->m_col > current_b->m_col) {
+        col = current_b->m_col;
+        value = beta * current_b->m_value;
+        current_b = current_b->m_right;
+      } else {
+        col = current_a->m_col;
+        value = alpha * current_a->m_value + beta * current_b->m_value;
+        current_a = current_a->m_right;
+        current_b = current_b->m_right;
       }
+
+      if (value == T()) {
+        continue;
+      }
+
+      HelpAppend(NewNode(i, col, value));
     }
   }
-
-  return *this;
+  HelpRefreshRowIndex();
 }
 
 /**
  * *****************************************************************
- * @brief : 重载加法运算符
+ * @brief : 重载加法运算符，逐行归并
  * @tparam T
  * @param  other
  * @return CrossSparseMatrix<T>&
@@ -396,32 +1002,69 @@ inline CrossSparseMatrix<T> CrossSparseMatrix<T>::operator+(const CrossSparseMat
   }
 
   CrossSparseMatrix result(m_rows, m_cols);
-  for (int i = 0; i < m_rows; ++i) {
-    NodePointer current_this = m_rows_heads[i];
-    NodePointer current_other = other.m_rows_heads[i];
-
-    while (current_this != nullptr || current_other != nullptr) {
-      if (current_this == nullptr) { //这个位置是0
-        result.Insert(current_other->m_row, current_other->m_col, current_other->m_value);
-        current_other = current_other->m_right;
-      } else if (current_other == nullptr) {
-        result.Insert(current_this->m_row, current_this->m_col, current_this->m_value);
-        current_this = current_this->m_right;
-      } else if (current_this->m_col < current_other->m_col) {
-        result.Insert(current_this->m_row, current_this->m_col, current_this->m_value);
-        current_this = current_this->m_right;
-      } else if (current_this->m_col > current_other->m_col) {
-        result.Insert(current_other->m_row, current_other->m_col, current_other->m_value);
-        current_other = current_other->m_right;
-      } else {
-        result.Insert(current_this->m_row, current_this->m_col, current_this->m_value + current_other->m_value);
-        current_this = current_this->m_right;
-        current_other = current_other->m_right;
-      }
+  result.HelpLinkSum(T(1), *this, T(1), other);
+  return result;
+}
+
+/**
+ * *****************************************************************
+ * @brief : result = alpha * 本矩阵 + beta * other，逐行归并，O(t1 + t2 + 行数 + 列数)。
+ *          result 可以是本矩阵或 other
+ * @tparam T
+ * @param  alpha
+ * @param  other
+ * @param  beta
+ * @param  result
+ * @return true
+ * @return false 尺寸不同
+ * *****************************************************************
+ */
+template <typename T>
+inline bool CrossSparseMatrix<T>::Axpy(const T &alpha, const CrossSparseMatrix<T> &other, const T &beta,
+                                       CrossSparseMatrix<T> &result) const {
+  if (m_rows != other.m_rows || m_cols != other.m_cols) {
+    return false;
+  }
+
+  //结果与某个操作数是同一个矩阵时，先生成到临时矩阵再交换。
+  //HelpSwap 连行索引一起交换，原来的索引随临时矩阵释放，交换后按原来的阈值重新启用
+  if (&result == this || &result == &other) {
+    const bool indexed = result.m_row_index != nullptr;
+    const int threshold = result.m_index_threshold;
+    CrossSparseMatrix<T> temp(m_rows, m_cols);
+    temp.HelpLinkSum(alpha, *this, beta, other);
+    result.HelpSwap(temp);
+    if (indexed) {
+      result.EnableRowIndex(threshold);
     }
+    return true;
   }
 
-  return std::move(result);
+  result.HelpReshape(m_rows, m_cols);
+  result.HelpLinkSum(alpha, *this, beta, other);
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 稀疏矩阵乘向量 y = 本矩阵 * x，沿行链表求内积，按行并行，O(t + 行数)
+ * @tparam T
+ * @param  x 长度为列数
+ * @param  y 长度为行数
+ * *****************************************************************
+ */
+template <typename T>
+inline void CrossSparseMatrix<T>::Multiply(const T *x, T *y) const {
+  const int threads = MatrixThreads(m_total);
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 256)
+  for (int i = 0; i < m_rows; ++i) {
+    T sum = T();
+    for (NodePointer current = m_rows_heads[i]; current != nullptr; current = current->m_right) {
+      sum += current->m_value * x[current->m_col];
+    }
+    y[i] = sum;
+  }
 }
 
 } // namespace bu_tools
@@ -12,6 +12,7 @@
  */
 
 #include "crosssparsematrix.h"
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
@@ -32,6 +33,12 @@ void InitRandomSeed();
 int GenerateRandomNumber(int min, int max);
 void ShowMatrix(const bu_tools::CrossSparseMatrix<int> &matrix);
 void InitMatrix(bu_tools::CrossSparseMatrix<int> &matrix);
+bool CheckRowIndexAxpy();
+void RandomDense(int *dense, int rows, int cols);
+void InsertDense(const int *dense, int rows, int cols, bu_tools::CrossSparseMatrix<int> &matrix);
+bool SameMatrix(const bu_tools::CrossSparseMatrix<int> &matrix, const bu_tools::CrossSparseMatrix<int> &expected);
+bool CheckAxpy();
+bool CheckLoadSortedAndReserve();
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 /*
@@ -72,7 +79,7 @@ int main(int argc, const char *argv[]) {
     //展示矩阵
     ShowMatrix(matrix);
 
-    cout << "\n请选择你要操作的代码<1-4>：";
+    cout << "\n请选择你要操作的代码<1-7>：";
     cin >> menu01_select;
 
     if (menu01_select == 1) {
@@ -197,6 +204,42 @@ int main(int argc, const char *argv[]) {
           break;
         }
       }
+    }else if(menu01_select==5){
+      /*****************************************************************
+
+      5.启用行索引后原地相加
+
+      *****************************************************************/
+      cout << "\033[2J\033[1;1H";
+      cout << "启用行索引后原地相加（result 与操作数为同一矩阵）："
+           << (CheckRowIndexAxpy() ? "通过" : "失败") << "\n";
+
+      cout << "\n按任意键返回：";
+      cin >> is_continue;
+    }else if(menu01_select==6){
+      /*****************************************************************
+
+      6.与逐个插入的结果比较 Axpy
+
+      *****************************************************************/
+      cout << "\033[2J\033[1;1H";
+      cout << "Axpy 与逐个插入的结果比较（含结果与操作数为同一矩阵）："
+           << (CheckAxpy() ? "通过" : "失败") << "\n";
+
+      cout << "\n按任意键返回：";
+      cin >> is_continue;
+    }else if(menu01_select==7){
+      /*****************************************************************
+
+      7.与逐个插入的结果比较 LoadSorted 和 Reserve
+
+      *****************************************************************/
+      cout << "\033[2J\033[1;1H";
+      cout << "LoadSorted、Reserve 与逐个插入的结果比较（含无序、重复的输入）："
+           << (CheckLoadSortedAndReserve() ? "通过" : "失败") << "\n";
+
+      cout << "\n按任意键返回：";
+      cin >> is_continue;
     }
     else {
       break;
@@ -228,6 +271,9 @@ void Menu01() {
   cout << "         2.求稀疏矩阵的加法\n";
   cout << "         3.随机生成稀疏矩阵\n";
   cout << "         4.用已有的稀疏矩阵初始化一个新矩阵\n";
+  cout << "         5.启用行索引后原地相加\n";
+  cout << "         6.与逐个插入的结果比较 Axpy\n";
+  cout << "         7.与逐个插入的结果比较 LoadSorted 和 Reserve\n";
   cout << "         其他.结束\n";
   cout << "*************************************************************\n";
 }
@@ -311,3 +357,287 @@ void InitMatrix(bu_tools::CrossSparseMatrix<int> &matrix) {
     matrix.Insert(GenerateRandomNumber(0, rows - 1), GenerateRandomNumber(0, cols - 1), GenerateRandomNumber(1, 100));
   }
 }
+
+/**
+ * *****************************************************************
+ * @brief : 启用行索引后做 matrix = 2 * matrix + other，检查索引和阈值保持不变、查找结果正确
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+bool CheckRowIndexAxpy() {
+  const int rows = 20;
+  const int cols = 40;
+  bu_tools::CrossSparseMatrix<int> matrix(rows, cols);
+  bu_tools::CrossSparseMatrix<int> other(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = i % 2; j < cols; j += 2) {
+      matrix.Insert(i, j, i + j);
+    }
+    for (int j = 0; j < cols; j += 3) {
+      other.Insert(i, j, 1);
+    }
+  }
+
+  matrix.EnableRowIndex(4);
+  if (!matrix.Axpy(2, other, 1, matrix)) {
+    return false;
+  }
+  if (!matrix.IsRowIndexEnabled() || matrix.GetIndexThreshold() != 4) {
+    return false;
+  }
+
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      int expected = (j % 2 == i % 2 ? 2 * (i + j) : 0) + (j % 3 == 0 ? 1 : 0);
+      bool exists = j % 2 == i % 2 || j % 3 == 0;
+      int value = 0;
+      if (matrix.GetValue(i, j, value) != exists || (exists && value != expected)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 随机生成稠密数组，约一半元素为零
+ * @param  dense 长度为 rows * cols
+ * @param  rows
+ * @param  cols
+ * *****************************************************************
+ */
+void RandomDense(int *dense, int rows, int cols) {
+  for (int k = 0; k < rows * cols; ++k) {
+    dense[k] = GenerateRandomNumber(0, 1) == 0 ? 0 : GenerateRandomNumber(-9, 9);
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 按随机顺序逐个 Insert 稠密数组中的非零元素，作为比较的基准
+ * @param  dense
+ * @param  rows
+ * @param  cols
+ * @param  matrix 尺寸为 rows * cols 的空矩阵
+ * *****************************************************************
+ */
+void InsertDense(const int *dense, int rows, int cols, bu_tools::CrossSparseMatrix<int> &matrix) {
+  int *order = new int[rows * cols];
+  for (int k = 0; k < rows * cols; ++k) {
+    order[k] = k;
+  }
+  for (int k = rows * cols - 1; k > 0; --k) {
+    std::swap(order[k], order[GenerateRandomNumber(0, k)]);
+  }
+  for (int k = 0; k < rows * cols; ++k) {
+    if (dense[order[k]] != 0) {
+      matrix.Insert(order[k] / cols, order[k] % cols, dense[order[k]]);
+    }
+  }
+  delete[] order;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 两个矩阵的尺寸、非零元素个数和每个位置的值都相同，并且列链表与行链表一致
+ * @param  matrix
+ * @param  expected
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+bool SameMatrix(const bu_tools::CrossSparseMatrix<int> &matrix, const bu_tools::CrossSparseMatrix<int> &expected) {
+  if (matrix.GetRows() != expected.GetRows() || matrix.GetCols() != expected.GetCols() ||
+      matrix.GetTotal() != expected.GetTotal()) {
+    return false;
+  }
+  for (int i = 0; i < matrix.GetRows(); ++i) {
+    for (int j = 0; j < matrix.GetCols(); ++j) {
+      int value = 0;
+      int expected_value = 0;
+      bool exists = expected.GetValue(i, j, expected_value);
+      if (matrix.GetValue(i, j, value) != exists || (exists && value != expected_value)) {
+        return false;
+      }
+    }
+  }
+
+  // 按列导出走的是列链表
+  const int total = matrix.GetTotal();
+  int *offsets = new int[matrix.GetCols() + 1];
+  int *indices = new int[total > 0 ? total : 1];
+  int *values = new int[total > 0 ? total : 1];
+  int *expected_offsets = new int[matrix.GetCols() + 1];
+  int *expected_indices = new int[total > 0 ? total : 1];
+  int *expected_values = new int[total > 0 ? total : 1];
+  matrix.GetCSC(offsets, indices, values);
+  expected.GetCSC(expected_offsets, expected_indices, expected_values);
+  bool same = std::equal(offsets, offsets + matrix.GetCols() + 1, expected_offsets) &&
+              std::equal(indices, indices + total, expected_indices) &&
+              std::equal(values, values + total, expected_values);
+  delete[] offsets;
+  delete[] indices;
+  delete[] values;
+  delete[] expected_offsets;
+  delete[] expected_indices;
+  delete[] expected_values;
+  return same;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 随机矩阵上比较 Axpy 与逐个插入 alpha * a + beta * b 的结果，
+ *          包括 result 与 a、b 或两者都是同一矩阵，以及 result 的尺寸不同、结果相消为零的情况
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+bool CheckAxpy() {
+  for (int round = 0; round < 50; ++round) {
+    const int rows = GenerateRandomNumber(1, 12);
+    const int cols = GenerateRandomNumber(1, 12);
+    const int alpha = GenerateRandomNumber(-3, 3);
+    const int beta = GenerateRandomNumber(-3, 3);
+    int *a = new int[rows * cols];
+    int *b = new int[rows * cols];
+    int *sum = new int[rows * cols];
+    RandomDense(a, rows, cols);
+    RandomDense(b, rows, cols);
+
+    bool passed = true;
+    for (int alias = 0; alias < 4 && passed; ++alias) {
+      bu_tools::CrossSparseMatrix<int> matrix(rows, cols);
+      bu_tools::CrossSparseMatrix<int> other(rows, cols);
+      InsertDense(a, rows, cols, matrix);
+      InsertDense(alias == 3 ? a : b, rows, cols, other);
+      if (round % 2 == 1) {
+        matrix.EnableRowIndex(2);
+      }
+
+      // alias：0 结果另存，1 结果为本矩阵，2 结果为 other，3 本矩阵、other 和结果是同一矩阵
+      const int *second = alias == 3 ? a : b;
+      for (int k = 0; k < rows * cols; ++k) {
+        sum[k] = alpha * a[k] + beta * second[k];
+      }
+      bu_tools::CrossSparseMatrix<int> expected(rows, cols);
+      InsertDense(sum, rows, cols, expected);
+
+      bu_tools::CrossSparseMatrix<int> separate(GenerateRandomNumber(1, 5), GenerateRandomNumber(1, 5));
+      separate.Insert(0, 0, 1);
+      if (alias == 0) {
+        passed = matrix.Axpy(alpha, other, beta, separate) && SameMatrix(separate, expected);
+      } else if (alias == 1) {
+        passed = matrix.Axpy(alpha, other, beta, matrix) && SameMatrix(matrix, expected);
+      } else if (alias == 2) {
+        passed = matrix.Axpy(alpha, other, beta, other) && SameMatrix(other, expected);
+      } else {
+        passed = matrix.Axpy(alpha, matrix, beta, matrix) && SameMatrix(matrix, expected);
+      }
+    }
+
+    // 尺寸不同时拒绝
+    bu_tools::CrossSparseMatrix<int> matrix(rows, cols);
+    bu_tools::CrossSparseMatrix<int> wrong(rows + 1, cols);
+    passed = passed && !matrix.Axpy(1, wrong, 1, matrix);
+
+    delete[] a;
+    delete[] b;
+    delete[] sum;
+    if (!passed) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 随机矩阵上比较 LoadSorted、Reserve 之后再插入与逐个插入的结果。
+ *          无序、重复或越界的三元组必须被拒绝，并且矩阵保持原样
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+bool CheckLoadSortedAndReserve() {
+  for (int round = 0; round < 50; ++round) {
+    const int rows = GenerateRandomNumber(1, 12);
+    const int cols = GenerateRandomNumber(1, 12);
+    int *dense = new int[rows * cols];
+    int *extra = new int[rows * cols];
+    RandomDense(dense, rows, cols);
+    RandomDense(extra, rows, cols);
+
+    // 按行优先顺序取出三元组
+    int *triple_rows = new int[rows * cols + 1];
+    int *triple_cols = new int[rows * cols + 1];
+    int *triple_values = new int[rows * cols + 1];
+    int count = 0;
+    for (int k = 0; k < rows * cols; ++k) {
+      if (dense[k] != 0) {
+        triple_rows[count] = k / cols;
+        triple_cols[count] = k % cols;
+        triple_values[count++] = dense[k];
+      }
+    }
+
+    bu_tools::CrossSparseMatrix<int> expected(rows, cols);
+    InsertDense(dense, rows, cols, expected);
+
+    // 已有元素的矩阵整体替换为三元组的内容
+    bu_tools::CrossSparseMatrix<int> matrix(rows, cols);
+    matrix.Insert(rows - 1, cols - 1, 100);
+    if (round % 2 == 1) {
+      matrix.EnableRowIndex(2);
+    }
+    bool passed = matrix.LoadSorted(triple_rows, triple_cols, triple_values, count) && SameMatrix(matrix, expected);
+
+    // 无序、重复、越界的输入都被拒绝，矩阵不变
+    if (count >= 2) {
+      std::swap(triple_rows[0], triple_rows[count - 1]);
+      std::swap(triple_cols[0], triple_cols[count - 1]);
+      passed = passed && !matrix.LoadSorted(triple_rows, triple_cols, triple_values, count) && SameMatrix(matrix, expected);
+      std::swap(triple_rows[0], triple_rows[count - 1]);
+      std::swap(triple_cols[0], triple_cols[count - 1]);
+    }
+    if (count >= 1) {
+      triple_rows[count] = triple_rows[count - 1];
+      triple_cols[count] = triple_cols[count - 1];
+      triple_values[count] = 1;
+      passed = passed && !matrix.LoadSorted(triple_rows, triple_cols, triple_values, count + 1) &&
+               SameMatrix(matrix, expected);
+      triple_cols[count] = cols;
+      passed = passed && !matrix.LoadSorted(triple_rows, triple_cols, triple_values, count + 1) &&
+               SameMatrix(matrix, expected);
+    }
+
+    // 预留结点之后逐个插入：覆盖已有元素、插到中间和行尾
+    matrix.Reserve(rows * cols);
+    for (int k = 0; k < rows * cols; ++k) {
+      if (extra[k] != 0) {
+        dense[k] = extra[k];
+      }
+    }
+    bu_tools::CrossSparseMatrix<int> updated(rows, cols);
+    InsertDense(dense, rows, cols, updated);
+    InsertDense(extra, rows, cols, matrix);
+    passed = passed && SameMatrix(matrix, updated);
+
+    // 空矩阵上预留后插入
+    bu_tools::CrossSparseMatrix<int> reserved(rows, cols);
+    reserved.Reserve(rows * cols);
+    InsertDense(dense, rows, cols, reserved);
+    passed = passed && SameMatrix(reserved, updated);
+
+    delete[] dense;
+    delete[] extra;
+    delete[] triple_rows;
+    delete[] triple_cols;
+    delete[] triple_values;
+    if (!passed) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,435 @@
+/**
+ * ************************************************************************
+ * @filename: compressedsparsematrix.h
+ *
+ * @brief : 稀疏矩阵（压缩行 CSR / 压缩列 CSC）
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-20
+ *
+ * ************************************************************************
+ */
+
+#ifndef _COMPRESSEDSPARSEMATRIX_H_
+#define _COMPRESSEDSPARSEMATRIX_H_
+
+#include "../matrixthreads.h"
+#include <algorithm>
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 压缩存储的稀疏矩阵。按行压缩（CSR）时第 r 行的元素存放在 [m_offsets[r], m_offsets[r + 1]) 中，
+ *          m_indices 为列号；按列压缩（CSC）时行列互换。每段内下标严格递增。
+ *          只读的批量计算用这种格式，修改请用三元组表或十字链表，再转换过来
+ * @tparam T
+ * @tparam RowMajor true 为 CSR，false 为 CSC
+ * *****************************************************************
+ */
+template <typename T, bool RowMajor>
+class CompressedSparseMatrix {
+  /*****************************************************************
+
+  数据域
+
+  *****************************************************************/
+protected:
+  int m_rows;     //行数
+  int m_cols;     //列数
+  int m_total;    //非零元素个数
+  int *m_offsets; //每行（列）的起始位置，长度为行（列）数 + 1
+  int *m_indices; //每个元素的列（行）号
+  T *m_values;    //每个元素的值
+
+  /*****************************************************************
+
+  成员函数的声明
+
+  *****************************************************************/
+private:
+
+public:
+  CompressedSparseMatrix() : m_rows(0), m_cols(0), m_total(0), m_offsets(nullptr), m_indices(nullptr), m_values(nullptr) {
+    Resize(0, 0, 0);
+  }
+  CompressedSparseMatrix(int r, int c) : m_rows(0), m_cols(0), m_total(0), m_offsets(nullptr), m_indices(nullptr), m_values(nullptr) {
+    Resize(r, c, 0);
+  }
+  CompressedSparseMatrix(const CompressedSparseMatrix &other);
+  CompressedSparseMatrix &operator=(const CompressedSparseMatrix &other);
+
+  //移动构造函数
+  CompressedSparseMatrix(CompressedSparseMatrix &&other) noexcept
+      : m_rows(other.m_rows), m_cols(other.m_cols), m_total(other.m_total), m_offsets(other.m_offsets),
+        m_indices(other.m_indices), m_values(other.m_values) {
+    other.m_rows = 0;
+    other.m_cols = 0;
+    other.m_total = 0;
+    other.m_offsets = nullptr;
+    other.m_indices = nullptr;
+    other.m_values = nullptr;
+  }
+
+  //移动赋值运算符
+  CompressedSparseMatrix &operator=(CompressedSparseMatrix &&other) noexcept {
+    if (this != &other) {
+      std::swap(m_rows, other.m_rows);
+      std::swap(m_cols, other.m_cols);
+      std::swap(m_total, other.m_total);
+      std::swap(m_offsets, other.m_offsets);
+      std::swap(m_indices, other.m_indices);
+      std::swap(m_values, other.m_values);
+    }
+    return *this;
+  }
+
+  virtual ~CompressedSparseMatrix() {
+    delete[] m_offsets;
+    delete[] m_indices;
+    delete[] m_values;
+  }
+
+  void Resize(int r, int c, int total); // 重新分配存储空间，起始位置全部置零，下标和值未初始化
+  void Clear();                         // 清空元素，不改变行列数
+  int GetRows() const { return m_rows; }
+  int GetCols() const { return m_cols; }
+  int GetTotal() const { return m_total; }
+  bool IsEmpty() const { return m_total == 0; }
+  int GetMajorCount() const { return RowMajor ? m_rows : m_cols; } // CSR 为行数，CSC 为列数
+  bool GetValue(int r, int c, T &e) const;
+
+  // 与稠密矩阵（行优先）的转换
+  void LoadDense(int r, int c, const T *dense); // 由稠密矩阵建立，只保留不等于 T() 的元素
+  void GetDense(T *dense) const;                // 导出为稠密矩阵，长度为行数 * 列数
+
+  // 同一矩阵换成另一种压缩方向（CSR <-> CSC），计数排序 O(t + 行数 + 列数)
+  void ConvertTo(CompressedSparseMatrix<T, !RowMajor> &result) const;
+
+  // 稀疏矩阵乘向量 y = A * x，x 长度为列数，y 长度为行数
+  void Multiply(const T *x, T *y) const;
+
+  // 直接访问底层数组，供转换函数和计算核心使用
+  int *GetOffsets() { return m_offsets; }
+  int *GetIndices() { return m_indices; }
+  T *GetValues() { return m_values; }
+  const int *GetOffsets() const { return m_offsets; }
+  const int *GetIndices() const { return m_indices; }
+  const T *GetValues() const { return m_values; }
+};
+
+// 按行压缩
+template <typename T>
+using CSRSparseMatrix = CompressedSparseMatrix<T, true>;
+
+// 按列压缩
+template <typename T>
+using CSCSparseMatrix = CompressedSparseMatrix<T, false>;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+成员函数的定义
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * *****************************************************************
+ * @brief : 拷贝构造函数
+ * @tparam T
+ * @tparam RowMajor
+ * @param  other
+ * *****************************************************************
+ */
+template <typename T, bool RowMajor>
+inline CompressedSparseMatrix<T, RowMajor>::CompressedSparseMatrix(const CompressedSparseMatrix &other)
+    : m_rows(0), m_cols(0), m_total(0), m_offsets(nullptr), m_indices(nullptr), m_values(nullptr) {
+  *this = other;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 重载赋值运算符
+ * @tparam T
+ * @tparam RowMajor
+ * @param  other
+ * @return CompressedSparseMatrix&
+ * *****************************************************************
+ */
+template <typename T, bool RowMajor>
+inline CompressedSparseMatrix<T, RowMajor> &CompressedSparseMatrix<T, RowMajor>::operator=(const CompressedSparseMatrix &other) {
+  if (this != &other) {
+    Resize(other.m_rows, other.m_cols, other.m_total);
+    std::copy(other.m_offsets, other.m_offsets + GetMajorCount() + 1, m_offsets);
+    std::copy(other.m_indices, other.m_indices + m_total, m_indices);
+    std::copy(other.m_values, other.m_values + m_total, m_values);
+  }
+  return *this;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 重新分配存储空间，起始位置全部置零，下标和值未初始化，由调用者填充
+ * @tparam T
+ * @tparam RowMajor
+ * @param  r 行数
+ * @param  c 列数
+ * @param  total 非零元素个数
+ * *****************************************************************
+ */
+template <typename T, bool RowMajor>
+inline void CompressedSparseMatrix<T, RowMajor>::Resize(int r, int c, int total) {
+  delete[] m_offsets;
+  delete[] m_indices;
+  delete[] m_values;
+
+  m_rows = r;
+  m_cols = c;
+  m_total = total;
+  m_offsets = new int[GetMajorCount() + 1]();
+  m_indices = new int[total > 0 ? total : 1];
+  m_values = new T[total > 0 ? total : 1];
+}
+
+/**
+ * *****************************************************************
+ * @brief : 清空元素，不改变行列数
+ * @tparam T
+ * @tparam RowMajor
+ * *****************************************************************
+ */
+template <typename T, bool RowMajor>
+inline void CompressedSparseMatrix<T, RowMajor>::Clear() {
+  Resize(m_rows, m_cols, 0);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 获取值，在所在行（列）内二分查找，O(log 行长)
+ * @tparam T
+ * @tparam RowMajor
+ * @param  r
+ * @param  c
+ * @param  e
+ * @return true
+ * @return false 越界或该位置为零
+ * *****************************************************************
+ */
+template <typename T, bool RowMajor>
+inline bool CompressedSparseMatrix<T, RowMajor>::GetValue(int r, int c, T &e) const {
+  if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) {
+    return false;
+  }
+
+  int major = RowMajor ? r : c;
+  int minor = RowMajor ? c : r;
+  const int *begin = m_indices + m_offsets[major];
+  const int *end = m_indices + m_offsets[major + 1];
+  const int *found = std::lower_bound(begin, end, minor);
+  if (found == end || *found != minor) {
+    return false;
+  }
+
+  e = m_values[found - m_indices];
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 由行优先的稠密矩阵建立。先按行（列）计数，求出起始位置后各自填充，两遍都可以并行
+ * @tparam T
+ * @tparam RowMajor
+ * @param  r 行数
+ * @param  c 列数
+ * @param  dense 长度为 r * c，第 i 行第 j 列为 dense[i * c + j]
+ * *****************************************************************
+ */
+template <typename T, bool RowMajor>
+inline void CompressedSparseMatrix<T, RowMajor>::LoadDense(int r, int c, const T *dense) {
+  const int majors = RowMajor ? r : c;
+  const int minors = RowMajor ? c : r;
+  const long long major_stride = RowMajor ? c : 1;
+  const long long minor_stride = RowMajor ? 1 : c;
+  const int threads = MatrixThreads(static_cast<long long>(r) * c);
+
+  int *counts = new int[majors + 1]();
+#pragma omp parallel for num_threads(threads) schedule(static)
+  for (int i = 0; i < majors; ++i) {
+    const T *line = dense + i * major_stride;
+    int count = 0;
+    for (int j = 0; j < minors; ++j) {
+      if (!(line[j * minor_stride] == T())) {
+        ++count;
+      }
+    }
+    counts[i + 1] = count;
+  }
+  for (int i = 0; i < majors; ++i) {
+    counts[i + 1] += counts[i];
+  }
+
+  Resize(r, c, counts[majors]);
+  std::copy(counts, counts + majors + 1, m_offsets);
+  delete[] counts;
+
+#pragma omp parallel for num_threads(threads) schedule(static)
+  for (int i = 0; i < majors; ++i) {
+    const T *line = dense + i * major_stride;
+    int position = m_offsets[i];
+    for (int j = 0; j < minors; ++j) {
+      if (!(line[j * minor_stride] == T())) {
+        m_indices[position] = j;
+        m_values[position] = line[j * minor_stride];
+        ++position;
+      }
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 导出为行优先的稠密矩阵，每行（列）由一个线程负责
+ * @tparam T
+ * @tparam RowMajor
+ * @param  dense 长度为行数 * 列数
+ * *****************************************************************
+ */
+template <typename T, bool RowMajor>
+inline void CompressedSparseMatrix<T, RowMajor>::GetDense(T *dense) const {
+  const long long size = static_cast<long long>(m_rows) * m_cols;
+  const int majors = GetMajorCount();
+  const long long major_stride = RowMajor ? m_cols : 1;
+  const long long minor_stride = RowMajor ? 1 : m_cols;
+  const int threads = MatrixThreads(size);
+
+#pragma omp parallel for num_threads(threads) schedule(static)
+  for (long long i = 0; i < size; ++i) {
+    dense[i] = T();
+  }
+
+#pragma omp parallel for num_threads(threads) schedule(static)
+  for (int i = 0; i < majors; ++i) {
+    T *line = dense + i * major_stride;
+    for (int k = m_offsets[i]; k < m_offsets[i + 1]; ++k) {
+      line[m_indices[k] * minor_stride] = m_values[k];
+    }
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : 换成另一种压缩方向，即对下标做计数排序。元素按存储顺序分成若干段，
+ *          每个线程统计自己那一段的直方图，按下标求出各线程的起始偏移后各自分发，
+ *          前面的段主下标更小，所以结果每段内下标仍然有序。result 不能是自身
+ * @tparam T
+ * @tparam RowMajor
+ * @param  result
+ * *****************************************************************
+ */
+template <typename T, bool RowMajor>
+inline void CompressedSparseMatrix<T, RowMajor>::ConvertTo(CompressedSparseMatrix<T, !RowMajor> &result) const {
+  const int majors = GetMajorCount();
+  const int minors = RowMajor ? m_cols : m_rows;
+  const int total = m_total;
+
+  int threads = MatrixThreads(total);
+  long long by_memory = (4LL * total + (1 << 20)) / (minors + 1LL) + 1; // 直方图总量不超过非零元素的 4 倍左右
+  if (threads > by_memory) {
+    threads = static_cast<int>(by_memory);
+  }
+  const int chunk = (total + threads - 1) / threads;
+
+  result.Resize(m_rows, m_cols, total);
+  int *out_offsets = result.GetOffsets();
+  int *out_indices = result.GetIndices();
+  T *out_values = result.GetValues();
+
+  int *histograms = new int[static_cast<long long>(threads) * minors + 1]();
+
+#pragma omp parallel for num_threads(threads) schedule(static, 1)
+  for (int t = 0; t < threads; ++t) {
+    int *histogram = histograms + static_cast<long long>(t) * minors;
+    int end = std::min(total, (t + 1) * chunk);
+    for (int k = t * chunk; k < end; ++k) {
+      ++histogram[m_indices[k]];
+    }
+  }
+
+#pragma omp parallel for num_threads(threads) schedule(static)
+  for (int j = 0; j < minors; ++j) {
+    int running = 0;
+    for (int t = 0; t < threads; ++t) {
+      int &slot = histograms[static_cast<long long>(t) * minors + j];
+      int count = slot;
+      slot = running;
+      running += count;
+    }
+    out_offsets[j + 1] = running;
+  }
+
+  out_offsets[0] = 0;
+  for (int j = 0; j < minors; ++j) {
+    out_offsets[j + 1] += out_offsets[j];
+  }
+
+  // 每段先二分找到起始的主下标，再顺序分发
+#pragma omp parallel for num_threads(threads) schedule(static, 1)
+  for (int t = 0; t < threads; ++t) {
+    int *histogram = histograms + static_cast<long long>(t) * minors;
+    int begin = t * chunk;
+    int end = std::min(total, (t + 1) * chunk);
+    if (begin >= end) {
+      continue;
+    }
+    int major = static_cast<int>(std::upper_bound(m_offsets, m_offsets + majors + 1, begin) - m_offsets) - 1;
+    for (int k = begin; k < end; ++k) {
+      while (m_offsets[major + 1] <= k) {
+        ++major;
+      }
+      int minor = m_indices[k];
+      int position = out_offsets[minor] + histogram[minor]++;
+      out_indices[position] = major;
+      out_values[position] = m_values[k];
+    }
+  }
+
+  delete[] histograms;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 稀疏矩阵乘向量 y = A * x。CSR 每行一个内积，按行并行；
+ *          CSC 按列把 x[c] 乘到 y 上，不同列会写同一个 y，只能单线程
+ * @tparam T
+ * @tparam RowMajor
+ * @param  x 长度为列数
+ * @param  y 长度为行数
+ * *****************************************************************
+ */
+template <typename T, bool RowMajor>
+inline void CompressedSparseMatrix<T, RowMajor>::Multiply(const T *x, T *y) const {
+  if (RowMajor) {
+    const int threads = MatrixThreads(m_total);
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 1024)
+    for (int i = 0; i < m_rows; ++i) {
+      T sum = T();
+      for (int k = m_offsets[i]; k < m_offsets[i + 1]; ++k) {
+        sum += m_values[k] * x[m_indices[k]];
+      }
+      y[i] = sum;
+    }
+  } else {
+    std::fill(y, y + m_rows, T());
+    for (int j = 0; j < m_cols; ++j) {
+      const T xj = x[j];
+      for (int k = m_offsets[j]; k < m_offsets[j + 1]; ++k) {
+        y[m_indices[k]] += m_values[k] * xj;
+      }
+    }
+  }
+}
+
+} // namespace bu_tools
+
+#endif // _COMPRESSEDSPARSEMATRIX_H_
@@ -0,0 +1,185 @@
+/**
+ * ************************************************************************
+ * @filename: sparseconvert.h
+ *
+ * @brief : 稀疏矩阵各存储格式之间的转换
+ *
+ *          三元组表、十字链表、CSR、CSC 两两之间都可以用 Convert(源, 目标) 转换，
+ *          目标的原有内容被替换，行列数随源改变。每个转换都是线性时间，
+ *          源格式已经有序的地方直接写入目标的数组，不经过中间结果，非零元素多时多线程执行。
+ *          与稠密矩阵（行优先）的转换见 CompressedSparseMatrix::LoadDense / GetDense
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-20
+ *
+ * ************************************************************************
+ */
+
+#ifndef _SPARSECONVERT_H_
+#define _SPARSECONVERT_H_
+
+#include "../cross/crosssparsematrix.h"
+#include "../tuple/tripletsparsematrix.h"
+#include "compressedsparsematrix.h"
+
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 三元组表 -> CSR，三元组本来按行有序，列号和值原样复制
+ * @tparam T
+ * @param  source
+ * @param  target
+ * *****************************************************************
+ */
+template <typename T>
+inline void Convert(const TripletSparseMatrix<T> &source, CSRSparseMatrix<T> &target) {
+  target.Resize(source.GetRows(), source.GetCols(), source.GetTolal());
+  source.GetCSR(target.GetOffsets(), target.GetIndices(), target.GetValues());
+}
+
+/**
+ * *****************************************************************
+ * @brief : 三元组表 -> CSC，按列计数排序
+ * @tparam T
+ * @param  source
+ * @param  target
+ * *****************************************************************
+ */
+template <typename T>
+inline void Convert(const TripletSparseMatrix<T> &source, CSCSparseMatrix<T> &target) {
+  target.Resize(source.GetRows(), source.GetCols(), source.GetTolal());
+  source.GetCSC(target.GetOffsets(), target.GetIndices(), target.GetValues());
+}
+
+/**
+ * *****************************************************************
+ * @brief : 十字链表 -> CSR，沿行链表
+ * @tparam T
+ * @param  source
+ * @param  target
+ * *****************************************************************
+ */
+template <typename T>
+inline void Convert(const CrossSparseMatrix<T> &source, CSRSparseMatrix<T> &target) {
+  target.Resize(source.GetRows(), source.GetCols(), source.GetTotal());
+  source.GetCSR(target.GetOffsets(), target.GetIndices(), target.GetValues());
+}
+
+/**
+ * *****************************************************************
+ * @brief : 十字链表 -> CSC，沿列链表
+ * @tparam T
+ * @param  source
+ * @param  target
+ * *****************************************************************
+ */
+template <typename T>
+inline void Convert(const CrossSparseMatrix<T> &source, CSCSparseMatrix<T> &target) {
+  target.Resize(source.GetRows(), source.GetCols(), source.GetTotal());
+  source.GetCSC(target.GetOffsets(), target.GetIndices(), target.GetValues());
+}
+
+/**
+ * *****************************************************************
+ * @brief : CSR -> 三元组表
+ * @tparam T
+ * @param  source
+ * @param  target
+ * *****************************************************************
+ */
+template <typename T>
+inline void Convert(const CSRSparseMatrix<T> &source, TripletSparseMatrix<T> &target) {
+  target.LoadCSR(source.GetRows(), source.GetCols(), source.GetOffsets(), source.GetIndices(), source.GetValues());
+}
+
+/**
+ * *****************************************************************
+ * @brief : CSR -> 十字链表
+ * @tparam T
+ * @param  source
+ * @param  target
+ * *****************************************************************
+ */
+template <typename T>
+inline void Convert(const CSRSparseMatrix<T> &source, CrossSparseMatrix<T> &target) {
+  target.LoadCSR(source.GetRows(), source.GetCols(), source.GetOffsets(), source.GetIndices(), source.GetValues());
+}
+
+/**
+ * *****************************************************************
+ * @brief : CSC -> 三元组表，先换成 CSR
+ * @tparam T
+ * @param  source
+ * @param  target
+ * *****************************************************************
+ */
+template <typename T>
+inline void Convert(const CSCSparseMatrix<T> &source, TripletSparseMatrix<T> &target) {
+  CSRSparseMatrix<T> csr;
+  source.ConvertTo(csr);
+  Convert(csr, target);
+}
+
+/**
+ * *****************************************************************
+ * @brief : CSC -> 十字链表，先换成 CSR
+ * @tparam T
+ * @param  source
+ * @param  target
+ * *****************************************************************
+ */
+template <typename T>
+inline void Convert(const CSCSparseMatrix<T> &source, CrossSparseMatrix<T> &target) {
+  CSRSparseMatrix<T> csr;
+  source.ConvertTo(csr);
+  Convert(csr, target);
+}
+
+/**
+ * *****************************************************************
+ * @brief : CSR <-> CSC
+ * @tparam T
+ * @tparam RowMajor
+ * @param  source
+ * @param  target
+ * *****************************************************************
+ */
+template <typename T, bool RowMajor>
+inline void Convert(const CompressedSparseMatrix<T, RowMajor> &source, CompressedSparseMatrix<T, !RowMajor> &target) {
+  source.ConvertTo(target);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 三元组表 -> 十字链表，经过 CSR
+ * @tparam T
+ * @param  source
+ * @param  target
+ * *****************************************************************
+ */
+template <typename T>
+inline void Convert(const TripletSparseMatrix<T> &source, CrossSparseMatrix<T> &target) {
+  CSRSparseMatrix<T> csr;
+  Convert(source, csr);
+  Convert(csr, target);
+}
+
+/**
+ * *****************************************************************
+ * @brief : 十字链表 -> 三元组表，经过 CSR
+ * @tparam T
+ * @param  source
+ * @param  target
+ * *****************************************************************
+ */
+template <typename T>
+inline void Convert(const CrossSparseMatrix<T> &source, TripletSparseMatrix<T> &target) {
+  CSRSparseMatrix<T> csr;
+  Convert(source, csr);
+  Convert(csr, target);
+}
+
+} // namespace bu_tools
+
+#endif // _SPARSECONVERT_H_
@@ -0,0 +1,130 @@
+/**
+ * ************************************************************************
+ * @filename: test_compressedsparsematrix.cpp
+ *
+ * @brief : 测试压缩存储的稀疏矩阵和格式转换
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-20
+ *
+ * ************************************************************************
+ */
+
+#include "sparseconvert.h"
+#include <iomanip>
+#include <iostream>
+
+using std::cout;
+using std::setw;
+
+template <typename M>
+void ShowMatrix(const M &matrix);
+void test_Dense();
+void test_Convert();
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+主函数
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, const char *argv[]) {
+  test_Dense();
+  test_Convert();
+
+  return 0;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 按行列打印，零元素打印为 0
+ * @tparam M 任何提供 GetRows、GetCols、GetValue 的稀疏矩阵
+ * @param  matrix
+ * *****************************************************************
+ */
+template <typename M>
+void ShowMatrix(const M &matrix) {
+  for (int i = 0; i < matrix.GetRows(); ++i) {
+    for (int j = 0; j < matrix.GetCols(); ++j) {
+      int value = 0;
+      matrix.GetValue(i, j, value);
+      cout << setw(4) << value;
+    }
+    cout << "\n";
+  }
+}
+
+void test_Dense() {
+  const int rows = 3;
+  const int cols = 4;
+  int dense[rows * cols] = {
+      1, 0, 0, 2, //
+      0, 0, 3, 0, //
+      4, 5, 0, 6, //
+  };
+
+  bu_tools::CSRSparseMatrix<int> csr;
+  csr.LoadDense(rows, cols, dense);
+  cout << "CSR 共 " << csr.GetTotal() << " 个非零元素\n";
+  ShowMatrix(csr);
+
+  cout << "row_offsets:";
+  for (int i = 0; i <= rows; ++i) {
+    cout << " " << csr.GetOffsets()[i];
+  }
+  cout << "\ncol_indices:";
+  for (int k = 0; k < csr.GetTotal(); ++k) {
+    cout << " " << csr.GetIndices()[k];
+  }
+  cout << "\n";
+
+  bu_tools::CSCSparseMatrix<int> csc;
+  bu_tools::Convert(csr, csc);
+  cout << "col_offsets:";
+  for (int j = 0; j <= cols; ++j) {
+    cout << " " << csc.GetOffsets()[j];
+  }
+  cout << "\nrow_indices:";
+  for (int k = 0; k < csc.GetTotal(); ++k) {
+    cout << " " << csc.GetIndices()[k];
+  }
+  cout << "\n";
+
+  int back[rows * cols];
+  csc.GetDense(back);
+  bool same = true;
+  for (int i = 0; i < rows * cols; ++i) {
+    same = same && back[i] == dense[i];
+  }
+  cout << "CSC 导出的稠密矩阵与原矩阵" << (same ? "相同" : "不同") << "\n\n";
+}
+
+void test_Convert() {
+  // 十字链表负责修改
+  bu_tools::CrossSparseMatrix<int> cross(4, 4);
+  cross.Insert(0, 0, 1);
+  cross.Insert(1, 2, 2);
+  cross.Insert(3, 1, 3);
+  cross.Insert(2, 3, 4);
+  cross.Insert(1, 0, 5);
+
+  // 交给计算时换成 CSR
+  bu_tools::CSRSparseMatrix<int> csr;
+  bu_tools::Convert(cross, csr);
+  cout << "十字链表 -> CSR：\n";
+  ShowMatrix(csr);
+
+  bu_tools::TripletSparseMatrix<int> triplet;
+  bu_tools::Convert(csr, triplet);
+  cout << "CSR -> 三元组表，共 " << triplet.GetTolal() << " 个非零元素\n";
+
+  bu_tools::CSCSparseMatrix<int> csc;
+  bu_tools::Convert(triplet, csc);
+  bu_tools::CrossSparseMatrix<int> back(1, 1);
+  bu_tools::Convert(csc, back);
+  cout << "三元组表 -> CSC -> 十字链表：\n";
+  ShowMatrix(back);
+}
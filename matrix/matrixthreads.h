@@ -0,0 +1,43 @@
+/**
+ * ************************************************************************
+ * @filename: matrixthreads.h
+ *
+ * @brief : 稀疏矩阵各种格式共用的线程数选择
+ *
+ *          工作量太小时多开线程得不偿失，所有按非零元素或分量并行的循环都用同一个规则
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-25
+ *
+ * ************************************************************************
+ */
+
+#ifndef _MATRIXTHREADS_H_
+#define _MATRIXTHREADS_H_
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 按工作量决定线程数，每个线程至少 64K 个元素，没有 OpenMP 时为 1
+ * @param  work 非零元素个数或向量长度
+ * @return int
+ * *****************************************************************
+ */
+inline int MatrixThreads(long long work) {
+  int threads = 1;
+#ifdef _OPENMP
+  threads = omp_get_max_threads();
+  if (threads > work / 65536 + 1) {
+    threads = static_cast<int>(work / 65536 + 1);
+  }
+#endif
+  return threads;
+}
+
+} // namespace bu_tools
+
+#endif // _MATRIXTHREADS_H_
@@ -0,0 +1,423 @@
+/**
+ * ************************************************************************
+ * @filename: iterativesolver.h
+ *
+ * @brief : 稀疏线性方程组的迭代解法（共轭梯度、BiCGSTAB）
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-22
+ *
+ * ************************************************************************
+ */
+
+#ifndef _ITERATIVESOLVER_H_
+#define _ITERATIVESOLVER_H_
+
+#include "preconditioner.h"
+#include <cmath>
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 迭代求解 A * x = b。
+ *          A 可以是任何提供 GetRows() 和 Multiply(x, y)（y = A * x）的稀疏矩阵：
+ *          三元组表、十字链表、CSR、CSC、BSR 都可以；预条件子提供 Apply(r, z)。
+ *          工作向量放在求解器里，按方程个数增长后重复使用，迭代过程中不分配内存；
+ *          向量运算在方程多时多线程执行。一个求解器同一时刻只能解一个方程组
+ * @tparam T 浮点类型
+ * *****************************************************************
+ */
+template <typename T>
+class IterativeSolver {
+  /*****************************************************************
+
+  数据域
+
+  *****************************************************************/
+protected:
+  int m_max_iterations; //最大迭代次数
+  T m_tolerance;        //收敛条件：残差范数 / b 的范数
+  int m_iterations;     //上一次求解的迭代次数
+  T m_residual;         //上一次求解结束时的相对残差
+  T *m_workspace;       //工作向量，每个长度为 m_capacity
+  int m_capacity;       //工作向量的容量
+
+  static const int WORK_VECTORS = 7; //BiCGSTAB 需要的工作向量个数，CG 只用前 4 个
+
+  /*****************************************************************
+
+  成员函数的声明
+
+  *****************************************************************/
+private:
+  static T HelpDot(const T *x, const T *y, int n);
+  static void HelpCombine(T *y, const T &a, const T *x, const T &b, int n); // y = a * x + b * y
+  static T HelpStep(T *x, T *r, const T &alpha, const T *p, const T *q, int n); // x += alpha * p，r -= alpha * q，返回 r 的范数平方
+  T *HelpVector(int index) { return m_workspace + static_cast<long long>(index) * m_capacity; }
+  template <typename M>
+  T HelpResidual(const M &matrix, const T *b, const T *x, T *r, const T &b_norm); // r = b - A * x，返回相对残差
+
+public:
+  IterativeSolver(int max_iterations = 1000, const T &tolerance = T(1e-8))
+      : m_max_iterations(max_iterations), m_tolerance(tolerance), m_iterations(0), m_residual(T()),
+        m_workspace(nullptr), m_capacity(0) {}
+  IterativeSolver(const IterativeSolver &other) = delete;
+  IterativeSolver &operator=(const IterativeSolver &other) = delete;
+  virtual ~IterativeSolver() {
+    delete[] m_workspace;
+  }
+
+  void Reserve(int n); // 预先分配 n 个方程的工作向量
+  void SetMaxIterations(int max_iterations) { m_max_iterations = max_iterations; }
+  void SetTolerance(const T &tolerance) { m_tolerance = tolerance; }
+  int GetIterations() const { return m_iterations; }
+  T GetResidual() const { return m_residual; }
+
+  // 共轭梯度法，A 必须对称正定，预条件子也必须对称正定
+  template <typename M, typename P>
+  bool ConjugateGradient(const M &matrix, const T *b, T *x, const P &preconditioner);
+  template <typename M>
+  bool ConjugateGradient(const M &matrix, const T *b, T *x);
+
+  // 稳定双共轭梯度法，用于一般的非对称矩阵，右预条件
+  template <typename M, typename P>
+  bool BiCGSTAB(const M &matrix, const T *b, T *x, const P &preconditioner);
+  template <typename M>
+  bool BiCGSTAB(const M &matrix, const T *b, T *x);
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+成员函数的定义
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * *****************************************************************
+ * @brief : 内积
+ * @tparam T
+ * @param  x
+ * @param  y
+ * @param  n
+ * @return T
+ * *****************************************************************
+ */
+template <typename T>
+inline T IterativeSolver<T>::HelpDot(const T *x, const T *y, int n) {
+  T sum = T();
+#pragma omp parallel for num_threads(MatrixThreads(n)) schedule(static) reduction(+ : sum)
+  for (int i = 0; i < n; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+/**
+ * *****************************************************************
+ * @brief : y = a * x + b * y
+ * @tparam T
+ * @param  y
+ * @param  a
+ * @param  x
+ * @param  b
+ * @param  n
+ * *****************************************************************
+ */
+template <typename T>
+inline void IterativeSolver<T>::HelpCombine(T *y, const T &a, const T *x, const T &b, int n) {
+#pragma omp parallel for num_threads(MatrixThreads(n)) schedule(static)
+  for (int i = 0; i < n; ++i) {
+    y[i] = a * x[i] + b * y[i];
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : CG 的一步更新合并为一遍：x += alpha * p，r -= alpha * q，同时求 r 的范数平方，
+ *          少读写两遍向量
+ * @tparam T
+ * @param  x
+ * @param  r
+ * @param  alpha
+ * @param  p
+ * @param  q
+ * @param  n
+ * @return T
+ * *****************************************************************
+ */
+template <typename T>
+inline T IterativeSolver<T>::HelpStep(T *x, T *r, const T &alpha, const T *p, const T *q, int n) {
+  T sum = T();
+#pragma omp parallel for num_threads(MatrixThreads(n)) schedule(static) reduction(+ : sum)
+  for (int i = 0; i < n; ++i) {
+    x[i] += alpha * p[i];
+    r[i] -= alpha * q[i];
+    sum += r[i] * r[i];
+  }
+  return sum;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 重新计算真实残差 r = b - A * x
+ * @tparam T
+ * @tparam M
+ * @param  matrix
+ * @param  b
+ * @param  x
+ * @param  r
+ * @param  b_norm b 的范数
+ * @return T 相对残差
+ * *****************************************************************
+ */
+template <typename T>
+template <typename M>
+inline T IterativeSolver<T>::HelpResidual(const M &matrix, const T *b, const T *x, T *r, const T &b_norm) {
+  const int n = matrix.GetRows();
+  matrix.Multiply(x, r);
+  HelpCombine(r, T(1), b, T(-1), n);
+  return std::sqrt(HelpDot(r, r, n)) / b_norm;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 预先分配 n 个方程的工作向量，容量不足时才重新分配
+ * @tparam T
+ * @param  n
+ * *****************************************************************
+ */
+template <typename T>
+inline void IterativeSolver<T>::Reserve(int n) {
+  if (n <= m_capacity) {
+    return;
+  }
+
+  delete[] m_workspace;
+  m_capacity = n;
+  m_workspace = new T[static_cast<long long>(WORK_VECTORS) * m_capacity];
+}
+
+/**
+ * *****************************************************************
+ * @brief : 预条件共轭梯度法。x 为初值，结束时为解；b 为零向量时直接得到零解
+ * @tparam T
+ * @tparam M 稀疏矩阵
+ * @tparam P 预条件子
+ * @param  matrix 对称正定矩阵
+ * @param  b
+ * @param  x
+ * @param  preconditioner
+ * @return true 收敛
+ * @return false 达到最大迭代次数仍未收敛，或出现破缺
+ * *****************************************************************
+ */
+template <typename T>
+template <typename M, typename P>
+inline bool IterativeSolver<T>::ConjugateGradient(const M &matrix, const T *b, T *x, const P &preconditioner) {
+  const int n = matrix.GetRows();
+  Reserve(n);
+  T *r = HelpVector(0);
+  T *z = HelpVector(1);
+  T *p = HelpVector(2);
+  T *q = HelpVector(3);
+
+  m_iterations = 0;
+  const T b_norm = std::sqrt(HelpDot(b, b, n));
+  if (b_norm == T()) {
+    std::fill(x, x + n, T());
+    m_residual = T();
+    return true;
+  }
+
+  m_residual = HelpResidual(matrix, b, x, r, b_norm);
+  if (m_residual <= m_tolerance) {
+    return true;
+  }
+
+  preconditioner.Apply(r, z);
+  std::copy(z, z + n, p);
+  T rz = HelpDot(r, z, n);
+
+  while (m_iterations < m_max_iterations) {
+    ++m_iterations;
+
+    matrix.Multiply(p, q);
+    T pq = HelpDot(p, q, n);
+    if (pq == T()) {
+      return false;
+    }
+    T alpha = rz / pq;
+    m_residual = std::sqrt(HelpStep(x, r, alpha, p, q, n)) / b_norm;
+
+    //递推的残差收敛时用真实残差确认，不够小就从真实残差重新开始
+    bool restart = false;
+    if (m_residual <= m_tolerance) {
+      m_residual = HelpResidual(matrix, b, x, r, b_norm);
+      if (m_residual <= m_tolerance) {
+        return true;
+      }
+      restart = true;
+    }
+
+    preconditioner.Apply(r, z);
+    T rz_new = HelpDot(r, z, n);
+    HelpCombine(p, T(1), z, restart ? T() : rz_new / rz, n);
+    rz = rz_new;
+  }
+
+  return false;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 不带预条件的共轭梯度法
+ * @tparam T
+ * @tparam M
+ * @param  matrix
+ * @param  b
+ * @param  x
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename T>
+template <typename M>
+inline bool IterativeSolver<T>::ConjugateGradient(const M &matrix, const T *b, T *x) {
+  return ConjugateGradient(matrix, b, x, IdentityPreconditioner<T>(matrix.GetRows()));
+}
+
+/**
+ * *****************************************************************
+ * @brief : 右预条件的 BiCGSTAB，即对 A * M^-1 * y = b 迭代，x = M^-1 * y。
+ *          x 为初值，结束时为解；残差始终是原方程组的残差，返回 true 时为真实残差
+ * @tparam T
+ * @tparam M 稀疏矩阵
+ * @tparam P 预条件子
+ * @param  matrix 方阵
+ * @param  b
+ * @param  x
+ * @param  preconditioner
+ * @return true 收敛
+ * @return false 达到最大迭代次数仍未收敛，或出现破缺
+ * *****************************************************************
+ */
+template <typename T>
+template <typename M, typename P>
+inline bool IterativeSolver<T>::BiCGSTAB(const M &matrix, const T *b, T *x, const P &preconditioner) {
+  const int n = matrix.GetRows();
+  Reserve(n);
+  T *r = HelpVector(0);
+  T *r_hat = HelpVector(1); //影子残差，重新开始时更新
+  T *p = HelpVector(2);
+  T *v = HelpVector(3);
+  T *p_hat = HelpVector(4); //M^-1 * p
+  T *s_hat = HelpVector(5); //M^-1 * s
+  T *t = HelpVector(6);
+  T *s = r; //s 与 r 共用，s = r - alpha * v 之后 r 只在下一步由 s 得到
+
+  m_iterations = 0;
+  const T b_norm = std::sqrt(HelpDot(b, b, n));
+  if (b_norm == T()) {
+    std::fill(x, x + n, T());
+    m_residual = T();
+    return true;
+  }
+
+  m_residual = HelpResidual(matrix, b, x, r, b_norm);
+  if (m_residual <= m_tolerance) {
+    return true;
+  }
+
+  T rho = T(1);
+  T alpha = T(1);
+  T omega = T(1);
+  bool restart = true;
+
+  while (m_iterations < m_max_iterations) {
+    //开始或重新开始：影子残差取当前残差，搜索方向清零
+    if (restart) {
+      std::copy(r, r + n, r_hat);
+      std::fill(p, p + n, T());
+      std::fill(v, v + n, T());
+      rho = T(1);
+      alpha = T(1);
+      omega = T(1);
+      restart = false;
+    }
+    ++m_iterations;
+
+    T rho_new = HelpDot(r_hat, r, n);
+    if (rho_new == T() || omega == T()) {
+      return false;
+    }
+
+    // p = r + beta * (p - omega * v)
+    T beta = (rho_new / rho) * (alpha / omega);
+    HelpCombine(p, -omega, v, T(1), n);
+    HelpCombine(p, T(1), r, beta, n);
+    rho = rho_new;
+
+    preconditioner.Apply(p, p_hat);
+    matrix.Multiply(p_hat, v);
+    T r_hat_v = HelpDot(r_hat, v, n);
+    if (r_hat_v == T()) {
+      return false;
+    }
+    alpha = rho / r_hat_v;
+
+    // s = r - alpha * v，已经足够小时只走半步
+    HelpCombine(s, -alpha, v, T(1), n);
+    T s_norm = std::sqrt(HelpDot(s, s, n)) / b_norm;
+    if (s_norm <= m_tolerance) {
+      HelpCombine(x, alpha, p_hat, T(1), n);
+    } else {
+      preconditioner.Apply(s, s_hat);
+      matrix.Multiply(s_hat, t);
+      T tt = HelpDot(t, t, n);
+      omega = tt == T() ? T() : HelpDot(t, s, n) / tt;
+
+      // x += alpha * p_hat + omega * s_hat，r = s - omega * t
+      HelpCombine(x, alpha, p_hat, T(1), n);
+      HelpCombine(x, omega, s_hat, T(1), n);
+      HelpCombine(r, -omega, t, T(1), n);
+      m_residual = std::sqrt(HelpDot(r, r, n)) / b_norm;
+      if (m_residual > m_tolerance) {
+        continue;
+      }
+    }
+
+    //递推的残差会与真实残差逐渐偏离，收敛时用真实残差确认，不够小就从真实残差重新开始
+    m_residual = HelpResidual(matrix, b, x, r, b_norm);
+    if (m_residual <= m_tolerance) {
+      return true;
+    }
+    restart = true;
+  }
+
+  return false;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 不带预条件的 BiCGSTAB
+ * @tparam T
+ * @tparam M
+ * @param  matrix
+ * @param  b
+ * @param  x
+ * @return true
+ * @return false
+ * *****************************************************************
+ */
+template <typename T>
+template <typename M>
+inline bool IterativeSolver<T>::BiCGSTAB(const M &matrix, const T *b, T *x) {
+  return BiCGSTAB(matrix, b, x, IdentityPreconditioner<T>(matrix.GetRows()));
+}
+
+} // namespace bu_tools
+
+#endif // _ITERATIVESOLVER_H_
@@ -0,0 +1,311 @@
+/**
+ * ************************************************************************
+ * @filename: preconditioner.h
+ *
+ * @brief : 迭代法的预条件子
+ *
+ *          预条件子 M 近似系数矩阵 A，Apply(r, z) 求 z = M^-1 * r。
+ *          都由 CSR 矩阵建立，其他格式先用 Convert 转换
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-22
+ *
+ * ************************************************************************
+ */
+
+#ifndef _PRECONDITIONER_H_
+#define _PRECONDITIONER_H_
+
+#include "../csr/compressedsparsematrix.h"
+#include <algorithm>
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 不做预条件，z = r
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+class IdentityPreconditioner {
+protected:
+  int m_size; //向量长度
+
+public:
+  explicit IdentityPreconditioner(int n = 0) : m_size(n) {}
+
+  bool Setup(const CSRSparseMatrix<T> &matrix) {
+    m_size = matrix.GetRows();
+    return true;
+  }
+  void Apply(const T *r, T *z) const {
+    std::copy(r, r + m_size, z);
+  }
+};
+
+/**
+ * *****************************************************************
+ * @brief : Jacobi 预条件子，M 为 A 的对角线，z[i] = r[i] / a[i][i]，按分量并行。
+ *          与 ILU(0) 相同，Setup 失败时不保留对角元的倒数，Apply 退化为 z = r
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+class JacobiPreconditioner {
+protected:
+  int m_size;            //向量长度
+  T *m_inverse_diagonal; //对角元的倒数
+  bool m_valid;          //最近一次 Setup 是否成功
+
+private:
+  bool HelpInvalidate();
+
+public:
+  JacobiPreconditioner() : m_size(0), m_inverse_diagonal(nullptr), m_valid(false) {}
+  JacobiPreconditioner(const JacobiPreconditioner &other) = delete;
+  JacobiPreconditioner &operator=(const JacobiPreconditioner &other) = delete;
+  virtual ~JacobiPreconditioner() {
+    delete[] m_inverse_diagonal;
+  }
+
+  bool Setup(const CSRSparseMatrix<T> &matrix); // 对角元缺失或为零时返回 false
+  void Apply(const T *r, T *z) const;
+  bool IsValid() const { return m_valid; }
+};
+
+/**
+ * *****************************************************************
+ * @brief : 不完全 LU 分解 ILU(0)：L、U 只保留 A 的非零结构，L 的对角线为 1 不存放，
+ *          两者合起来与 A 共用同一套下标。Apply 依次做前代、回代，只能单线程。
+ *          Setup 失败时不保留分解到一半的结果，Apply 退化为 z = r
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+class ILU0Preconditioner {
+protected:
+  CSRSparseMatrix<T> m_factors; //L 的严格下三角和 U 的上三角
+  int *m_diagonal;              //每行对角元在 m_factors 中的位置
+  int m_size;                   //向量长度
+  bool m_valid;                 //最近一次分解是否成功
+
+private:
+  bool HelpInvalidate();
+
+public:
+  ILU0Preconditioner() : m_diagonal(nullptr), m_size(0), m_valid(false) {}
+  ILU0Preconditioner(const ILU0Preconditioner &other) = delete;
+  ILU0Preconditioner &operator=(const ILU0Preconditioner &other) = delete;
+  virtual ~ILU0Preconditioner() {
+    delete[] m_diagonal;
+  }
+
+  bool Setup(const CSRSparseMatrix<T> &matrix); // 对角元缺失或分解中出现零主元时返回 false
+  void Apply(const T *r, T *z) const;
+  bool IsValid() const { return m_valid; }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+成员函数的定义
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * *****************************************************************
+ * @brief : 取出对角元的倒数
+ * @tparam T
+ * @param  matrix 方阵
+ * @return true
+ * @return false 不是方阵，或对角元缺失、为零
+ * *****************************************************************
+ */
+template <typename T>
+inline bool JacobiPreconditioner<T>::Setup(const CSRSparseMatrix<T> &matrix) {
+  const int n = matrix.GetRows();
+  m_size = n == matrix.GetCols() ? n : 0;
+  if (n != matrix.GetCols()) {
+    return HelpInvalidate();
+  }
+
+  delete[] m_inverse_diagonal;
+  m_inverse_diagonal = new T[n > 0 ? n : 1];
+  for (int i = 0; i < n; ++i) {
+    T diagonal = T();
+    if (!matrix.GetValue(i, i, diagonal) || diagonal == T()) {
+      return HelpInvalidate();
+    }
+    m_inverse_diagonal[i] = T(1) / diagonal;
+  }
+  m_valid = true;
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : Setup 失败时释放对角元的倒数，标记为无效
+ * @tparam T
+ * @return false
+ * *****************************************************************
+ */
+template <typename T>
+inline bool JacobiPreconditioner<T>::HelpInvalidate() {
+  delete[] m_inverse_diagonal;
+  m_inverse_diagonal = nullptr;
+  m_valid = false;
+  return false;
+}
+
+/**
+ * *****************************************************************
+ * @brief : z = D^-1 * r，没有成功 Setup 时 z = r
+ * @tparam T
+ * @param  r
+ * @param  z 可以与 r 相同
+ * *****************************************************************
+ */
+template <typename T>
+inline void JacobiPreconditioner<T>::Apply(const T *r, T *z) const {
+  if (!m_valid) {
+    if (z != r) {
+      std::copy(r, r + m_size, z);
+    }
+    return;
+  }
+
+#pragma omp parallel for schedule(static) if (m_size > 65536)
+  for (int i = 0; i < m_size; ++i) {
+    z[i] = r[i] * m_inverse_diagonal[i];
+  }
+}
+
+/**
+ * *****************************************************************
+ * @brief : ILU(0) 分解，IKJ 顺序：第 i 行依次用前面各行消去，只更新 A 中原有的位置。
+ *          position[j] 记录第 i 行第 j 列在 m_factors 中的位置，不在本行时为 -1
+ * @tparam T
+ * @param  matrix 方阵，每行列号严格递增
+ * @return true
+ * @return false 不是方阵，或对角元缺失，或出现零主元
+ * *****************************************************************
+ */
+template <typename T>
+inline bool ILU0Preconditioner<T>::Setup(const CSRSparseMatrix<T> &matrix) {
+  const int n = matrix.GetRows();
+  m_size = n == matrix.GetCols() ? n : 0;
+  if (n != matrix.GetCols()) {
+    return HelpInvalidate();
+  }
+
+  m_valid = true;
+  m_factors = matrix;
+  const int *offsets = m_factors.GetOffsets();
+  const int *indices = m_factors.GetIndices();
+  T *values = m_factors.GetValues();
+
+  delete[] m_diagonal;
+  m_diagonal = new int[n > 0 ? n : 1];
+  for (int i = 0; i < n; ++i) {
+    const int *found = std::lower_bound(indices + offsets[i], indices + offsets[i + 1], i);
+    if (found == indices + offsets[i + 1] || *found != i) {
+      return HelpInvalidate();
+    }
+    m_diagonal[i] = static_cast<int>(found - indices);
+  }
+
+  int *position = new int[n > 0 ? n : 1];
+  std::fill(position, position + n, -1);
+
+  bool valid = true;
+  for (int i = 0; i < n && valid; ++i) {
+    for (int p = offsets[i]; p < offsets[i + 1]; ++p) {
+      position[indices[p]] = p;
+    }
+
+    // 第 i 行中对角线左边的每个 k，用第 k 行消去
+    for (int p = offsets[i]; p < m_diagonal[i]; ++p) {
+      int k = indices[p];
+      values[p] /= values[m_diagonal[k]];
+      const T factor = values[p];
+      for (int q = m_diagonal[k] + 1; q < offsets[k + 1]; ++q) {
+        int j = indices[q];
+        if (position[j] >= 0) {
+          values[position[j]] -= factor * values[q];
+        }
+      }
+    }
+
+    if (values[m_diagonal[i]] == T()) {
+      valid = false;
+    }
+
+    for (int p = offsets[i]; p < offsets[i + 1]; ++p) {
+      position[indices[p]] = -1;
+    }
+  }
+
+  delete[] position;
+  return valid ? true : HelpInvalidate();
+}
+
+/**
+ * *****************************************************************
+ * @brief : 分解失败时释放分解到一半的因子和对角元位置，标记为无效
+ * @tparam T
+ * @return false
+ * *****************************************************************
+ */
+template <typename T>
+inline bool ILU0Preconditioner<T>::HelpInvalidate() {
+  m_factors.Resize(0, 0, 0);
+  delete[] m_diagonal;
+  m_diagonal = nullptr;
+  m_valid = false;
+  return false;
+}
+
+/**
+ * *****************************************************************
+ * @brief : z = (L * U)^-1 * r：先解 L * w = r（前代），再解 U * z = w（回代）。
+ *          没有成功分解时 z = r
+ * @tparam T
+ * @param  r
+ * @param  z 可以与 r 相同
+ * *****************************************************************
+ */
+template <typename T>
+inline void ILU0Preconditioner<T>::Apply(const T *r, T *z) const {
+  if (!m_valid) {
+    if (z != r) {
+      std::copy(r, r + m_size, z);
+    }
+    return;
+  }
+
+  const int n = m_factors.GetRows();
+  const int *offsets = m_factors.GetOffsets();
+  const int *indices = m_factors.GetIndices();
+  const T *values = m_factors.GetValues();
+
+  for (int i = 0; i < n; ++i) {
+    T sum = r[i];
+    for (int p = offsets[i]; p < m_diagonal[i]; ++p) {
+      sum -= values[p] * z[indices[p]];
+    }
+    z[i] = sum;
+  }
+
+  for (int i = n - 1; i >= 0; --i) {
+    T sum = z[i];
+    for (int p = m_diagonal[i] + 1; p < offsets[i + 1]; ++p) {
+      sum -= values[p] * z[indices[p]];
+    }
+    z[i] = sum / values[m_diagonal[i]];
+  }
+}
+
+} // namespace bu_tools
+
+#endif // _PRECONDITIONER_H_
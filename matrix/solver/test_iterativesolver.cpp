@@ -0,0 +1,186 @@
+/**
+ * ************************************************************************
+ * @filename: test_iterativesolver.cpp
+ *
+ * @brief : 测试稀疏线性方程组的迭代解法
+ *
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-22
+ *
+ * ************************************************************************
+ */
+
+#include "../csr/sparseconvert.h"
+#include "iterativesolver.h"
+#include <iostream>
+
+using std::cout;
+
+void BuildPoisson(int m, double convection, bu_tools::TripletSparseMatrix<double> &matrix);
+void test_ConjugateGradient();
+void test_BiCGSTAB();
+void test_PreconditionerFailure();
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+
+主函数
+
+*/
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, const char *argv[]) {
+  test_ConjugateGradient();
+  test_BiCGSTAB();
+  test_PreconditionerFailure();
+
+  return 0;
+}
+
+/**
+ * *****************************************************************
+ * @brief : m * m 网格上的五点差分，convection 不为零时加上对流项，矩阵不再对称
+ * @param  m
+ * @param  convection
+ * @param  matrix
+ * *****************************************************************
+ */
+void BuildPoisson(int m, double convection, bu_tools::TripletSparseMatrix<double> &matrix) {
+  const int n = m * m;
+  int *offsets = new int[n + 1];
+  int *indices = new int[n * 5];
+  double *values = new double[n * 5];
+
+  int total = 0;
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < m; ++j) {
+      int row = i * m + j;
+      offsets[row] = total;
+      if (i > 0) {
+        indices[total] = row - m;
+        values[total++] = -1 - convection;
+      }
+      if (j > 0) {
+        indices[total] = row - 1;
+        values[total++] = -1 - convection;
+      }
+      indices[total] = row;
+      values[total++] = 4;
+      if (j < m - 1) {
+        indices[total] = row + 1;
+        values[total++] = -1 + convection;
+      }
+      if (i < m - 1) {
+        indices[total] = row + m;
+        values[total++] = -1 + convection;
+      }
+    }
+  }
+  offsets[n] = total;
+
+  matrix.LoadCSR(n, n, offsets, indices, values);
+  delete[] offsets;
+  delete[] indices;
+  delete[] values;
+}
+
+void test_ConjugateGradient() {
+  const int m = 50;
+  const int n = m * m;
+  bu_tools::TripletSparseMatrix<double> triplet;
+  BuildPoisson(m, 0.0, triplet);
+
+  bu_tools::CSRSparseMatrix<double> csr;
+  bu_tools::Convert(triplet, csr);
+
+  double *b = new double[n];
+  double *x = new double[n];
+  for (int i = 0; i < n; ++i) {
+    b[i] = 1.0;
+  }
+
+  bu_tools::IterativeSolver<double> solver(5000, 1e-10);
+
+  // 三元组表直接求解，不做预条件
+  std::fill(x, x + n, 0.0);
+  bool converged = solver.ConjugateGradient(triplet, b, x);
+  cout << "CG（三元组表）：" << (converged ? "收敛" : "未收敛") << "，迭代 " << solver.GetIterations()
+       << " 次，相对残差 " << solver.GetResidual() << "\n";
+
+  // CSR + ILU(0)，同一个求解器，工作向量不再分配
+  bu_tools::ILU0Preconditioner<double> ilu;
+  ilu.Setup(csr);
+  std::fill(x, x + n, 0.0);
+  converged = solver.ConjugateGradient(csr, b, x, ilu);
+  cout << "CG（CSR + ILU(0)）：" << (converged ? "收敛" : "未收敛") << "，迭代 " << solver.GetIterations()
+       << " 次，相对残差 " << solver.GetResidual() << "\n";
+  cout << "中心点 x = " << x[(m / 2) * m + m / 2] << "\n\n";
+
+  delete[] b;
+  delete[] x;
+}
+
+void test_BiCGSTAB() {
+  const int m = 50;
+  const int n = m * m;
+  bu_tools::TripletSparseMatrix<double> triplet;
+  BuildPoisson(m, 0.4, triplet);
+
+  bu_tools::CSRSparseMatrix<double> csr;
+  bu_tools::Convert(triplet, csr);
+
+  double *b = new double[n];
+  double *x = new double[n];
+  for (int i = 0; i < n; ++i) {
+    b[i] = 1.0;
+  }
+
+  bu_tools::IterativeSolver<double> solver(5000, 1e-10);
+
+  bu_tools::JacobiPreconditioner<double> jacobi;
+  jacobi.Setup(csr);
+  std::fill(x, x + n, 0.0);
+  bool converged = solver.BiCGSTAB(csr, b, x, jacobi);
+  cout << "BiCGSTAB（Jacobi）：" << (converged ? "收敛" : "未收敛") << "，迭代 " << solver.GetIterations()
+       << " 次，相对残差 " << solver.GetResidual() << "\n";
+
+  bu_tools::ILU0Preconditioner<double> ilu;
+  ilu.Setup(csr);
+  std::fill(x, x + n, 0.0);
+  converged = solver.BiCGSTAB(csr, b, x, ilu);
+  cout << "BiCGSTAB（ILU(0)）：" << (converged ? "收敛" : "未收敛") << "，迭代 " << solver.GetIterations()
+       << " 次，相对残差 " << solver.GetResidual() << "\n";
+
+  delete[] b;
+  delete[] x;
+}
+
+void test_PreconditionerFailure() {
+  // 第 1 行缺少对角元：先成功分解一次，再用这个矩阵分解，不能留下上一次或分解到一半的结果
+  const double dense[9] = {4, 1, 0, 1, 0, 1, 0, 1, 4};
+  const double diagonal[9] = {2, 0, 0, 0, 2, 0, 0, 0, 2};
+  bu_tools::CSRSparseMatrix<double> good;
+  bu_tools::CSRSparseMatrix<double> bad;
+  good.LoadDense(3, 3, diagonal);
+  bad.LoadDense(3, 3, dense);
+
+  bu_tools::ILU0Preconditioner<double> ilu;
+  ilu.Setup(good);
+  bool valid = ilu.Setup(bad);
+
+  double r[3] = {1, 2, 3};
+  double z[3] = {0, 0, 0};
+  ilu.Apply(r, z);
+  cout << "ILU(0) 缺少对角元：" << (valid ? "分解成功" : "分解失败") << "，IsValid = " << ilu.IsValid()
+       << "，Apply 结果 " << z[0] << " " << z[1] << " " << z[2] << "（应与 r 相同）\n";
+
+  // Jacobi 的约定相同：对角元为零时不保留上一次或替换过的倒数
+  bu_tools::JacobiPreconditioner<double> jacobi;
+  jacobi.Setup(good);
+  valid = jacobi.Setup(bad);
+  std::fill(z, z + 3, 0.0);
+  jacobi.Apply(r, z);
+  cout << "Jacobi 对角元为零：" << (valid ? "成功" : "失败") << "，IsValid = " << jacobi.IsValid()
+       << "，Apply 结果 " << z[0] << " " << z[1] << " " << z[2] << "（应与 r 相同）\n";
+}
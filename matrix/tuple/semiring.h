@@ -0,0 +1,97 @@
+/**
+ * ************************************************************************
+ * @filename: semiring.h
+ *
+ * @brief : 稀疏矩阵乘法用的半环
+ *
+ *          半环由加法 Add、乘法 Multiply 和加法单位元 Zero 组成，矩阵乘法中
+ *          c[i][j] = Add(..., Multiply(a[i][k], b[k][j]), ...)。不存在的元素视为 Zero，
+ *          换一个半环，同一套乘法就能表达最短路径、可达性等图算法
+ *
+ * @author : baiyebzx (baiyebzx1228@gmail.com)
+ * @date : 2024-10-24
+ *
+ * ************************************************************************
+ */
+
+#ifndef _SEMIRING_H_
+#define _SEMIRING_H_
+
+#include <limits>
+namespace bu_tools {
+
+/**
+ * *****************************************************************
+ * @brief : 普通的 (+, ×) 半环
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+struct PlusTimesSemiring {
+  static T Zero() { return T(); }
+  static T Add(const T &a, const T &b) { return a + b; }
+  static T Multiply(const T &a, const T &b) { return a * b; }
+};
+
+/**
+ * *****************************************************************
+ * @brief : (min, +) 半环，用于最短路径。Zero 为 numeric_limits<T>::max()，表示无穷大，
+ *          与无穷大相加仍为无穷大，不会溢出
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+struct MinPlusSemiring {
+  static T Zero() { return std::numeric_limits<T>::max(); }
+  static T Add(const T &a, const T &b) { return b < a ? b : a; }
+  static T Multiply(const T &a, const T &b) {
+    if (a == Zero() || b == Zero()) {
+      return Zero();
+    }
+    return a + b;
+  }
+};
+
+/**
+ * *****************************************************************
+ * @brief : (max, ×) 半环，用于最可靠路径等概率乘积问题，元素不能为负
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+struct MaxTimesSemiring {
+  static T Zero() { return T(); }
+  static T Add(const T &a, const T &b) { return a < b ? b : a; }
+  static T Multiply(const T &a, const T &b) { return a * b; }
+};
+
+/**
+ * *****************************************************************
+ * @brief : (or, and) 布尔半环，非零为真，结果用 T(1) 和 T() 表示
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+struct OrAndSemiring {
+  static T Zero() { return T(); }
+  static T Add(const T &a, const T &b) { return a != T() || b != T() ? T(1) : T(); }
+  static T Multiply(const T &a, const T &b) { return a != T() && b != T() ? T(1) : T(); }
+};
+
+/**
+ * *****************************************************************
+ * @brief : (or, second) 半环：只看右边的值，左边矩阵中存放的元素一律视为真。
+ *          用于可达性，权值为零的边也算作边
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+struct OrSecondSemiring {
+  static T Zero() { return T(); }
+  static T Add(const T &a, const T &b) { return a != T() || b != T() ? T(1) : T(); }
+  static T Multiply(const T &, const T &b) { return b != T() ? T(1) : T(); }
+};
+
+} // namespace bu_tools
+
+#endif // _SEMIRING_H_
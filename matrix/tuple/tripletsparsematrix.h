@@ -14,6 +14,8 @@
 #ifndef _TRIPLETSPARSEMATRIX_H_
 #define _TRIPLETSPARSEMATRIX_H_
 
+#include "../matrixthreads.h"
+#include "semiring.h"
 #include <algorithm>
 namespace bu_tools {
 
@@ -75,11 +77,19 @@ protected:
 private:
   void Resize();
   void InsertAt(int index, const Triple &elem);
+  int LowerBoundRow(int r) const;
+  template <typename F>
+  void HelpScatterByColumn(int *col_offsets, F place) const;
+  static int HelpMerge(const Triple *a, int a_len, const T &alpha, const Triple *b, int b_len, const T &beta, Triple *out);
+  void HelpRowOffsets(int *row_offsets) const;
 
 public:
   void Clear();
   void Transpose(TripletSparseMatrix<T> &matrix) const;
   void TransposeFast(TripletSparseMatrix<T> &matrix) const;
+  void GetCSC(int *col_offsets, int *row_indices, T *values) const; // 按列压缩导出，不经过转置矩阵
+  void GetCSR(int *row_offsets, int *col_indices, T *values) const; // 按行压缩导出
+  void LoadCSR(int r, int c, const int *row_offsets, const int *col_indices, const T *values); // 由按行压缩的数组建立
   int GetRows() const;
   bool SetRows(int r);
   int GetCols() const;
@@ -90,9 +100,20 @@ public:
   bool Insert(int r, int c, const T &e);
   bool Remove(int r,int c);
   bool GetValue(int r, int c, T &e) const;
+  void Sort();
   TripletSparseMatrix<T> &operator=(const TripletSparseMatrix<T> &other);
   TripletSparseMatrix<T> operator+(const TripletSparseMatrix<T> &other);
+  bool Axpy(const T &alpha, const TripletSparseMatrix<T> &other, const T &beta, TripletSparseMatrix<T> &result) const; // result = alpha * 本矩阵 + beta * other
   TripletSparseMatrix<T> operator*(const TripletSparseMatrix<T> &other);
+  void Multiply(const T *x, T *y) const; // 稀疏矩阵乘向量 y = 本矩阵 * x
+
+  // 半环 S 上的乘法，不存在的元素视为 S::Zero()。mask 决定计算哪些输出，complement 为 true 时取补集，
+  // 被屏蔽的输出不计算，mask 为 nullptr 时全部计算
+  template <typename S>
+  void Multiply(const T *x, T *y, const bool *mask = nullptr, bool complement = false) const; // y = 本矩阵 * x
+  template <typename S>
+  bool Multiply(const TripletSparseMatrix<T> &other, TripletSparseMatrix<T> &result,
+                const TripletSparseMatrix<T> *mask = nullptr, bool complement = false) const; // result = 本矩阵 * other
 
 
 TripletSparseMatrix(){
@@ -212,6 +233,14 @@ TripletSparseMatrix(){
   Iterator end() const {
     return Iterator(m_data + m_total);
   }
+
+  // 第 r 行的三元组区间 [RowBegin(r), RowEnd(r))，三元组按行列有序，二分查找 O(log t)
+  Iterator RowBegin(int r) const {
+    return Iterator(m_data + LowerBoundRow(r));
+  }
+  Iterator RowEnd(int r) const {
+    return Iterator(m_data + LowerBoundRow(r + 1));
+  }
 };
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -312,47 +341,196 @@ inline void TripletSparseMatrix<T>::Transpose(TripletSparseMatrix<T> &matrix) co
 
 /**
  * *****************************************************************
- * @brief : 快速转置
+ * @brief : 按列计数排序的分发：三元组分成若干段，每个线程统计自己那一段的列直方图，
+ *          按列求出各线程在每列中的起始偏移，再各自按原顺序分发。源三元组按行有序，
+ *          同一列中先出现的行号更小，所以分发后每列内行号仍然有序。
+ *          直方图放在堆上，每个线程一份；非零元素少时只用一个线程，列很多时减少线程数控制内存
  * @tparam T
- * @param  matrix
+ * @tparam F void(int index, int position)
+ * @param  col_offsets 输出每列的起始位置，长度为列数 + 1
+ * @param  place 把第 index 个三元组放到列优先顺序的第 position 个位置
  * *****************************************************************
  */
 template <typename T>
-inline void TripletSparseMatrix<T>::TransposeFast(TripletSparseMatrix<T> &matrix) const {
+template <typename F>
+inline void TripletSparseMatrix<T>::HelpScatterByColumn(int *col_offsets, F place) const {
+  const int cols = m_cols;
+  const int total = m_total;
+
+  int threads = MatrixThreads(total);
+  long long by_memory = (4LL * total + (1 << 20)) / (cols + 1LL) + 1; // 直方图总量不超过非零元素的 4 倍左右
+  if (threads > by_memory) {
+    threads = static_cast<int>(by_memory);
+  }
+  const int chunk = (total + threads - 1) / threads;
 
-  int col_count[m_cols] = {0};
-  int position[m_cols] = {0};
+  int *histograms = new int[static_cast<long long>(threads) * cols + 1];
+  for (long long i = 0; i < static_cast<long long>(threads) * cols; ++i) {
+    histograms[i] = 0;
+  }
 
-  // 统计每列非零元素的个数
-  for (int i = 0; i < m_total; ++i) {
-    int col = m_data[i].m_col;
-    col_count[col]++;
+  // 每个线程统计自己那一段的列直方图
+#pragma omp parallel for num_threads(threads) schedule(static, 1)
+  for (int t = 0; t < threads; ++t) {
+    int *histogram = histograms + static_cast<long long>(t) * cols;
+    int end = std::min(total, (t + 1) * chunk);
+    for (int i = t * chunk; i < end; ++i) {
+      ++histogram[m_data[i].m_col];
+    }
   }
 
-  // 计算每列元素在转置矩阵中的起始位置
-  for (int i = 1; i < m_cols; ++i) {
-    position[i] = position[i - 1] + col_count[i - 1];
+  // 按列把各线程的计数换成该线程在列内的起始偏移，同时得到每列的总数
+#pragma omp parallel for num_threads(threads) schedule(static)
+  for (int c = 0; c < cols; ++c) {
+    int running = 0;
+    for (int t = 0; t < threads; ++t) {
+      int &slot = histograms[static_cast<long long>(t) * cols + c];
+      int count = slot;
+      slot = running;
+      running += count;
+    }
+    col_offsets[c + 1] = running;
   }
 
-  // 填充转置矩阵
-  matrix.Clear();
-  matrix.m_capacity = m_capacity;
-  matrix.m_rows = m_cols;
-  matrix.m_cols = m_rows;
-  // matrix.m_total=m_total;
-  matrix.m_data = new Triple[matrix.m_capacity];
+  col_offsets[0] = 0;
+  for (int c = 0; c < cols; ++c) {
+    col_offsets[c + 1] += col_offsets[c];
+  }
 
-  Triple elem;
-  for (int i = 0; i < m_total; ++i) {
-    int col = m_data[i].m_col;
-    int pos = position[col];
-    ++position[col];
+  // 各线程按原顺序分发
+#pragma omp parallel for num_threads(threads) schedule(static, 1)
+  for (int t = 0; t < threads; ++t) {
+    int *histogram = histograms + static_cast<long long>(t) * cols;
+    int end = std::min(total, (t + 1) * chunk);
+    for (int i = t * chunk; i < end; ++i) {
+      int col = m_data[i].m_col;
+      place(i, col_offsets[col] + histogram[col]++);
+    }
+  }
+
+  delete[] histograms;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 快速转置：按列计数排序，O(t + cols)，非零元素多时多线程执行。
+ *          结果直接写入新的三元组数组，matrix 可以就是自身
+ * @tparam T
+ * @param  matrix
+ * *****************************************************************
+ */
+template <typename T>
+inline void TripletSparseMatrix<T>::TransposeFast(TripletSparseMatrix<T> &matrix) const {
+  const int new_rows = m_cols;
+  const int new_cols = m_rows;
+  const int total = m_total;
+  const int capacity = m_capacity > total ? m_capacity : total;
+
+  Triple *new_data = new Triple[capacity > 0 ? capacity : 1];
+  int *col_offsets = new int[m_cols + 1];
+  HelpScatterByColumn(col_offsets, [&](int index, int position) {
+    new_data[position].m_row = m_data[index].m_col;
+    new_data[position].m_col = m_data[index].m_row;
+    new_data[position].m_value = m_data[index].m_value;
+  });
+  delete[] col_offsets;
+
+  delete[] matrix.m_data;
+  matrix.m_data = new_data;
+  matrix.m_capacity = capacity > 0 ? capacity : 1;
+  matrix.m_total = total;
+  matrix.m_rows = new_rows;
+  matrix.m_cols = new_cols;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 按列压缩（CSC）导出，与快速转置共用计数排序，直接写入调用者的数组，
+ *          每列内行号有序
+ * @tparam T
+ * @param  col_offsets 长度为列数 + 1，第 c 列的元素在 [col_offsets[c], col_offsets[c + 1])
+ * @param  row_indices 长度为非零元素个数
+ * @param  values 长度为非零元素个数，为 nullptr 时只导出结构
+ * *****************************************************************
+ */
+template <typename T>
+inline void TripletSparseMatrix<T>::GetCSC(int *col_offsets, int *row_indices, T *values) const {
+  HelpScatterByColumn(col_offsets, [&](int index, int position) {
+    row_indices[position] = m_data[index].m_row;
+    if (values != nullptr) {
+      values[position] = m_data[index].m_value;
+    }
+  });
+}
+
+/**
+ * *****************************************************************
+ * @brief : 按行压缩（CSR）导出。三元组本来就按行有序，列号和值原样复制，
+ *          行的起始位置在每个行号变化处写出，O(t + 行数)，非零元素多时多线程执行
+ * @tparam T
+ * @param  row_offsets 长度为行数 + 1，第 r 行的元素在 [row_offsets[r], row_offsets[r + 1])
+ * @param  col_indices 长度为非零元素个数
+ * @param  values 长度为非零元素个数，为 nullptr 时只导出结构
+ * *****************************************************************
+ */
+template <typename T>
+inline void TripletSparseMatrix<T>::GetCSR(int *row_offsets, int *col_indices, T *values) const {
+  const int total = m_total;
+
+  const int threads = MatrixThreads(total);
+
+  // 第 k 个三元组是第 r 行的第一个元素时，上一个非空行之后到 r 为止的各行都从 k 开始
+#pragma omp parallel for num_threads(threads) schedule(static)
+  for (int k = 0; k < total; ++k) {
+    int row = m_data[k].m_row;
+    int previous = k == 0 ? -1 : m_data[k - 1].m_row;
+    for (int r = previous + 1; r <= row; ++r) {
+      row_offsets[r] = k;
+    }
+    col_indices[k] = m_data[k].m_col;
+    if (values != nullptr) {
+      values[k] = m_data[k].m_value;
+    }
+  }
+
+  for (int r = total == 0 ? 0 : m_data[total - 1].m_row + 1; r <= m_rows; ++r) {
+    row_offsets[r] = total;
+  }
+}
 
-    elem.m_row = m_data[i].m_col;
-    elem.m_col = m_data[i].m_row;
-    elem.m_value = m_data[i].m_value;
+/**
+ * *****************************************************************
+ * @brief : 由按行压缩（CSR）的数组建立，替换原有内容，允许改变结构。
+ *          每行内列号必须严格递增，存储空间一次分配，O(t + 行数)，非零元素多时多线程执行
+ * @tparam T
+ * @param  r 行数
+ * @param  c 列数
+ * @param  row_offsets 长度为 r + 1
+ * @param  col_indices 长度为 row_offsets[r]
+ * @param  values 长度为 row_offsets[r]
+ * *****************************************************************
+ */
+template <typename T>
+inline void TripletSparseMatrix<T>::LoadCSR(int r, int c, const int *row_offsets, const int *col_indices, const T *values) {
+  const int total = row_offsets[r] - row_offsets[0];
+  const int base = row_offsets[0];
 
-    matrix.InsertAt(pos, elem);
+  delete[] m_data;
+  m_rows = r;
+  m_cols = c;
+  m_total = total;
+  m_capacity = total > 10 ? total : 10;
+  m_data = new Triple[m_capacity];
+
+  const int threads = MatrixThreads(total);
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 256)
+  for (int i = 0; i < r; ++i) {
+    for (int k = row_offsets[i]; k < row_offsets[i + 1]; ++k) {
+      m_data[k - base].m_row = i;
+      m_data[k - base].m_col = col_indices[k];
+      m_data[k - base].m_value = values[k];
+    }
   }
 }
 
@@ -461,6 +639,29 @@ inline bool TripletSparseMatrix<T>::IsEmpty() const {
   return m_total == 0;
 }
 
+/**
+ * *****************************************************************
+ * @brief : 二分查找第一个行号不小于 r 的三元组的下标
+ * @tparam T
+ * @param  r
+ * @return int 不存在时返回非零元素个数
+ * *****************************************************************
+ */
+template <typename T>
+inline int TripletSparseMatrix<T>::LowerBoundRow(int r) const {
+  int low = 0;
+  int high = m_total;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (m_data[mid].m_row < r) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
 /**
  * *****************************************************************
  * @brief : 判断指定行列是否存在非零元素
@@ -495,7 +696,7 @@ inline bool TripletSparseMatrix<T>::IsNonZeroAt(int r, int c) const {
  */
 template <typename T>
 inline bool TripletSparseMatrix<T>::Insert(int r, int c, const T &e) {
-  if (r > m_rows || c > m_cols || r < 0 || c < 0) {
+  if (r >= m_rows || c >= m_cols || r < 0 || c < 0) {
     return false;
   }
 
@@ -568,6 +769,22 @@ inline bool TripletSparseMatrix<T>::GetValue(int r, int c, T &e) const {
   return false;
 }
 
+/**
+ * *****************************************************************
+ * @brief : 按行列重新排序，用于通过迭代器直接改写了三元组的行列之后
+ * @tparam T
+ * *****************************************************************
+ */
+template <typename T>
+inline void TripletSparseMatrix<T>::Sort() {
+  if (!m_data) {
+    return;
+  }
+  std::sort(m_data, m_data + m_total, [](const Triple &a, const Triple &b) {
+    return a.m_row < b.m_row || (a.m_row == b.m_row && a.m_col < b.m_col);
+  });
+}
+
 /**
  * *****************************************************************
  * @brief : 重载赋值运算符
@@ -598,7 +815,142 @@ inline TripletSparseMatrix<T> &TripletSparseMatrix<T>::operator=(const TripletSp
 
 /**
  * *****************************************************************
- * @brief : 重载加法运算符
+ * @brief : 两个按行列有序的三元组序列做一次二路归并，out[k] = alpha * a + beta * b，结果为零的元素丢弃
+ * @tparam T
+ * @param  a
+ * @param  a_len
+ * @param  alpha
+ * @param  b
+ * @param  b_len
+ * @param  beta
+ * @param  out 为 nullptr 时只计数
+ * @return int 结果的元素个数
+ * *****************************************************************
+ */
+template <typename T>
+inline int TripletSparseMatrix<T>::HelpMerge(const Triple *a, int a_len, const T &alpha, const Triple *b, int b_len,
+                                             const T &beta, Triple *out) {
+  int i = 0, j = 0, count = 0;
+  while (i < a_len || j < b_len) {
+    int row, col;
+    T value;
+    //行列排序更小的先进，相同位置相加
+    if (j == b_len || (i < a_len && (a[i].m_row < b[j].m_row || (a[i].m_row == b[j].m_row && a[i].m_col < b[j].m_col)))) {
+      row = a[i].m_row;
+      col = a[i].m_col;
+      value = alpha * a[i].m_value;
+      ++i;
+    } else if (i == a_len || a[i].m_row > b[j].m_row || (a[i].m_row == b[j].m_row && a[i].m_col > b[j].m_col)) {
+      row = b[j].m_row;
+      col = b[j].m_col;
+      value = beta * b[j].m_value;
+      ++j;
+    } else {
+      row = a[i].m_row;
+      col = a[i].m_col;
+      value = alpha * a[i].m_value + beta * b[j].m_value;
+      ++i;
+      ++j;
+    }
+
+    if (value == T()) {
+      continue;
+    }
+    if (out != nullptr) {
+      out[count].m_row = row;
+      out[count].m_col = col;
+      out[count].m_value = value;
+    }
+    ++count;
+  }
+  return count;
+}
+
+/**
+ * *****************************************************************
+ * @brief : result = alpha * 本矩阵 + beta * other，两个三元组序列一次归并，O(t1 + t2)，只分配一次。
+ *          非零元素多时按行切分成若干段并行：先并行统计每段结果的个数，求前缀和后各段直接写入最终位置。
+ *          result 可以是本矩阵或 other
+ * @tparam T
+ * @param  alpha
+ * @param  other
+ * @param  beta
+ * @param  result
+ * @return true
+ * @return false 尺寸不同
+ * *****************************************************************
+ */
+template <typename T>
+inline bool TripletSparseMatrix<T>::Axpy(const T &alpha, const TripletSparseMatrix<T> &other, const T &beta,
+                                         TripletSparseMatrix<T> &result) const {
+  if (m_rows != other.m_rows || m_cols != other.m_cols) {
+    return false;
+  }
+
+  // 分段数即线程数，每段至少 64K 个非零元素
+  const int parts = MatrixThreads(static_cast<long long>(m_total) + other.m_total);
+
+  Triple *new_data = nullptr;
+  int total = 0;
+  int capacity = 0;
+  if (parts == 1) {
+    // 单线程：按上界一次分配，一次归并
+    capacity = m_total + other.m_total > 10 ? m_total + other.m_total : 10;
+    new_data = new Triple[capacity];
+    total = HelpMerge(m_data, m_total, alpha, other.m_data, other.m_total, beta, new_data);
+  } else {
+    // 以本矩阵的非零元素均分各段的起始行，两边用二分查找定位各段的区间
+    const TripletSparseMatrix<T> &pivot = m_total >= other.m_total ? *this : other;
+    int *a_begin = new int[parts + 1];
+    int *b_begin = new int[parts + 1];
+    int *offsets = new int[parts + 1];
+    for (int p = 0; p < parts; ++p) {
+      int row = p == 0 ? 0 : pivot.m_data[static_cast<long long>(pivot.m_total) * p / parts].m_row;
+      a_begin[p] = LowerBoundRow(row);
+      b_begin[p] = other.LowerBoundRow(row);
+    }
+    a_begin[parts] = m_total;
+    b_begin[parts] = other.m_total;
+
+#pragma omp parallel for num_threads(parts) schedule(static, 1)
+    for (int p = 0; p < parts; ++p) {
+      offsets[p + 1] = HelpMerge(m_data + a_begin[p], a_begin[p + 1] - a_begin[p], alpha, other.m_data + b_begin[p],
+                                 b_begin[p + 1] - b_begin[p], beta, nullptr);
+    }
+
+    offsets[0] = 0;
+    for (int p = 0; p < parts; ++p) {
+      offsets[p + 1] += offsets[p];
+    }
+    total = offsets[parts];
+    capacity = total > 10 ? total : 10;
+    new_data = new Triple[capacity];
+
+#pragma omp parallel for num_threads(parts) schedule(static, 1)
+    for (int p = 0; p < parts; ++p) {
+      HelpMerge(m_data + a_begin[p], a_begin[p + 1] - a_begin[p], alpha, other.m_data + b_begin[p],
+                b_begin[p + 1] - b_begin[p], beta, new_data + offsets[p]);
+    }
+
+    delete[] a_begin;
+    delete[] b_begin;
+    delete[] offsets;
+  }
+
+  const int rows = m_rows;
+  const int cols = m_cols;
+  delete[] result.m_data;
+  result.m_data = new_data;
+  result.m_capacity = capacity;
+  result.m_total = total;
+  result.m_rows = rows;
+  result.m_cols = cols;
+  return true;
+}
+
+/**
+ * *****************************************************************
+ * @brief : 重载加法运算符，一次二路归并
  * @tparam T
  * @param  other
  * @return TripletSparseMatrix<T>&
@@ -611,80 +963,256 @@ inline TripletSparseMatrix<T> TripletSparseMatrix<T>::operator+(const TripletSpa
     return TripletSparseMatrix(0, 0);
   }
 
-  TripletSparseMatrix result(m_rows, m_cols);
+  TripletSparseMatrix result;
+  Axpy(T(1), other, T(1), result);
+  return result;
+}
 
-  int i = 0, j = 0, index = 0;
-  while (i < m_total && j < other.m_total) {
-    //行列排序更小的先进
-    if (m_data[i].m_row < other.m_data[j].m_row || (m_data[i].m_row == other.m_data[j].m_row && m_data[i].m_col < other.m_data[j].m_col)) {
-      // result.Insert(m_data[i].m_row,m_data[i].m_col,m_data[i].m_value);
-      result.InsertAt(index, m_data[i]);
-      ++i;
-      ++index;
-    } else if (m_data[i].m_row > other.m_data[j].m_row || (m_data[i].m_row == other.m_data[j].m_row && m_data[i].m_col > other.m_data[j].m_col)) {
-      // result.Insert(other.m_data[j].m_row,other.m_data[j].m_col,other.m_data[j].m_value);
-      result.InsertAt(index, other.m_data[j]);
-      ++j;
-      ++index;
-    } else {
-      T sum = m_data[i].m_value + other.m_data[j].m_value;
-      if (sum != 0) {
-        result.Insert(m_data[i].m_row, m_data[i].m_col, sum);
-        ++index;
-      }
-      ++i;
-      ++j;
+/**
+ * *****************************************************************
+ * @brief : 重载乘法运算符，(+, ×) 半环上的 Gustavson 乘法，O(乘加次数 + 行数 * log t)
+ * @tparam T
+ * @param  other
+ * @return TripletSparseMatrix<T>&
+ * *****************************************************************
+ */
+template <typename T>
+inline TripletSparseMatrix<T> TripletSparseMatrix<T>::operator*(const TripletSparseMatrix<T> &other) {
+  TripletSparseMatrix result(0, 0);
+  if (!Multiply<PlusTimesSemiring<T>>(other, result)) {
+    return result;
+  }
+
+  // 相互抵消为零的元素不保留
+  int total = 0;
+  for (int k = 0; k < result.m_total; ++k) {
+    if (result.m_data[k].m_value != T()) {
+      result.m_data[total++] = result.m_data[k];
     }
   }
+  result.m_total = total;
+  return result;
+}
 
-  while (i < m_total) {
-    result.InsertAt(index, m_data[i]);
-    ++i;
-    ++index;
+/**
+ * *****************************************************************
+ * @brief : 稀疏矩阵乘向量 y = 本矩阵 * x，O(t + 行数)。行按块分给各线程，
+ *          每块用二分查找定位第一个三元组，之后顺序扫描，不同线程写不同的行
+ * @tparam T
+ * @param  x 长度为列数
+ * @param  y 长度为行数
+ * *****************************************************************
+ */
+template <typename T>
+inline void TripletSparseMatrix<T>::Multiply(const T *x, T *y) const {
+  const int rows = m_rows;
+  const int chunk = 1024;
+  const int chunk_count = (rows + chunk - 1) / chunk;
+
+  const int threads = MatrixThreads(m_total);
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+  for (int b = 0; b < chunk_count; ++b) {
+    int begin = b * chunk;
+    int end = std::min(rows, begin + chunk);
+    int k = LowerBoundRow(begin);
+    for (int i = begin; i < end; ++i) {
+      T sum = T();
+      for (; k < m_total && m_data[k].m_row == i; ++k) {
+        sum += m_data[k].m_value * x[m_data[k].m_col];
+      }
+      y[i] = sum;
+    }
   }
+}
 
-  while (i < other.m_total) {
-    result.InsertAt(index, other.m_data[j]);
-    ++j;
-    ++index;
+/**
+ * *****************************************************************
+ * @brief : 每行第一个三元组的位置，O(行数 * log t)，不复制列号和值
+ * @tparam T
+ * @param  row_offsets 长度为行数 + 1
+ * *****************************************************************
+ */
+template <typename T>
+inline void TripletSparseMatrix<T>::HelpRowOffsets(int *row_offsets) const {
+#pragma omp parallel for num_threads(MatrixThreads(m_rows)) schedule(static)
+  for (int r = 0; r <= m_rows; ++r) {
+    row_offsets[r] = LowerBoundRow(r);
   }
+}
 
-  return std::move(result);
+/**
+ * *****************************************************************
+ * @brief : 半环上的矩阵乘向量 y = 本矩阵 * x，按行分块并行，与 Multiply(x, y) 相同。
+ *          被屏蔽的行不扫描，y 中写入 S::Zero()；跳过若干行后用二分查找重新定位
+ * @tparam T
+ * @tparam S 半环
+ * @param  x 长度为列数，不存在的元素存放 S::Zero()
+ * @param  y 长度为行数
+ * @param  mask 长度为行数，mask[i] 为 true 时计算第 i 行，为 nullptr 时全部计算
+ * @param  complement 为 true 时改为计算 mask[i] 为 false 的行
+ * *****************************************************************
+ */
+template <typename T>
+template <typename S>
+inline void TripletSparseMatrix<T>::Multiply(const T *x, T *y, const bool *mask, bool complement) const {
+  const int rows = m_rows;
+  const int chunk = 1024;
+  const int chunk_count = (rows + chunk - 1) / chunk;
+
+#pragma omp parallel for num_threads(MatrixThreads(m_total)) schedule(dynamic, 1)
+  for (int b = 0; b < chunk_count; ++b) {
+    int begin = b * chunk;
+    int end = std::min(rows, begin + chunk);
+    int k = -1; // 为 -1 时需要重新定位
+    for (int i = begin; i < end; ++i) {
+      if (mask != nullptr && mask[i] == complement) {
+        y[i] = S::Zero();
+        k = -1;
+        continue;
+      }
+      if (k < 0) {
+        k = LowerBoundRow(i);
+      }
+      T sum = S::Zero();
+      for (; k < m_total && m_data[k].m_row == i; ++k) {
+        sum = S::Add(sum, S::Multiply(m_data[k].m_value, x[m_data[k].m_col]));
+      }
+      y[i] = sum;
+    }
+  }
 }
 
 /**
  * *****************************************************************
- * @brief : 重载乘法运算符
+ * @brief : 半环上的稀疏矩阵乘法（Gustavson 算法），按行并行，分两遍：先数出每行的元素个数，
+ *          再计算并写入，存储空间一次分配。每个线程一个稠密累加器，marker[j] == i 表示第 i 行
+ *          第 j 列已经出现；mask 同样展开成 allowed[j] == i，被屏蔽的位置直接跳过，不做乘加。
+ *          只要有一项乘积就保留该位置，即使结果等于 S::Zero()
  * @tparam T
- * @param  other
- * @return TripletSparseMatrix<T>&
+ * @tparam S 半环
+ * @param  other 行数等于本矩阵的列数
+ * @param  result 可以是本矩阵或 other
+ * @param  mask 与结果同样大小，只看结构；为 nullptr 时全部计算
+ * @param  complement 为 true 时只计算 mask 中不存在的位置
+ * @return true
+ * @return false 大小不匹配
  * *****************************************************************
  */
 template <typename T>
-inline TripletSparseMatrix<T> TripletSparseMatrix<T>::operator*(const TripletSparseMatrix<T> &other) {
-  if (m_cols != other.m_rows) {
-    return TripletSparseMatrix(0, 0);
+template <typename S>
+inline bool TripletSparseMatrix<T>::Multiply(const TripletSparseMatrix<T> &other, TripletSparseMatrix<T> &result,
+                                             const TripletSparseMatrix<T> *mask, bool complement) const {
+  if (m_cols != other.m_rows ||
+      (mask != nullptr && (mask->m_rows != m_rows || mask->m_cols != other.m_cols))) {
+    return false;
+  }
+
+  const int rows = m_rows;
+  const int cols = other.m_cols;
+  int *offsets = new int[rows + 1];
+  int *other_offsets = new int[other.m_rows + 1];
+  int *mask_offsets = mask != nullptr ? new int[rows + 1] : nullptr;
+  HelpRowOffsets(offsets);
+  other.HelpRowOffsets(other_offsets);
+  if (mask != nullptr) {
+    mask->HelpRowOffsets(mask_offsets);
   }
 
-  TripletSparseMatrix result(m_rows, other.m_cols);
+  const int threads = MatrixThreads(static_cast<long long>(m_total) + other.m_total);
+  int *counts = new int[rows + 1]();
+  Triple *new_data = nullptr;
+
+  for (int pass = 0; pass < 2; ++pass) {
+#pragma omp parallel num_threads(threads)
+    {
+      int *marker = new int[cols > 0 ? cols : 1];
+      int *allowed = new int[mask != nullptr && cols > 0 ? cols : 1];
+      T *accumulator = pass == 1 ? new T[cols > 0 ? cols : 1] : nullptr;
+      std::fill(marker, marker + cols, -1);
+      if (mask != nullptr) {
+        std::fill(allowed, allowed + cols, -1);
+      }
+
+#pragma omp for schedule(dynamic, 64)
+      for (int i = 0; i < rows; ++i) {
+        if (mask != nullptr) {
+          if (!complement && mask_offsets[i] == mask_offsets[i + 1]) {
+            continue; // 整行被屏蔽
+          }
+          for (int p = mask_offsets[i]; p < mask_offsets[i + 1]; ++p) {
+            allowed[mask->m_data[p].m_col] = i;
+          }
+        }
 
-  for (int i = 0; i < m_rows; ++i) {         //当前矩阵的行
-    for (int j = 0; j < other.m_cols; ++j) { //另一个矩阵的列
-      T sum = 0;
-      T val1 = 0, val2 = 0;
-      for (int k = 0; k < m_cols; ++k) {
-        if (GetValue(i, k, val1) && other.GetValue(k, j, val2)) {
-          sum += val1 * val2;
+        Triple *row = pass == 1 ? new_data + counts[i] : nullptr;
+        int count = 0;
+        for (int p = offsets[i]; p < offsets[i + 1]; ++p) {
+          const int k = m_data[p].m_col;
+          for (int q = other_offsets[k]; q < other_offsets[k + 1]; ++q) {
+            const int j = other.m_data[q].m_col;
+            if (mask != nullptr && (allowed[j] == i) == complement) {
+              continue;
+            }
+            if (pass == 0) {
+              if (marker[j] != i) {
+                marker[j] = i;
+                ++count;
+              }
+              continue;
+            }
+            const T product = S::Multiply(m_data[p].m_value, other.m_data[q].m_value);
+            if (marker[j] != i) {
+              marker[j] = i;
+              accumulator[j] = product;
+              row[count++].m_col = j;
+            } else {
+              accumulator[j] = S::Add(accumulator[j], product);
+            }
+          }
+        }
+
+        if (pass == 0) {
+          counts[i] = count;
+        } else {
+          std::sort(row, row + count, [](const Triple &a, const Triple &b) { return a.m_col < b.m_col; });
+          for (int p = 0; p < count; ++p) {
+            row[p].m_row = i;
+            row[p].m_value = accumulator[row[p].m_col];
+          }
         }
       }
 
-      if (sum != 0) {
-        result.Insert(i, j, sum);
+      delete[] marker;
+      delete[] allowed;
+      delete[] accumulator;
+    }
+
+    if (pass == 0) {
+      // 个数转为起始位置
+      int total = 0;
+      for (int i = 0; i < rows; ++i) {
+        int count = counts[i];
+        counts[i] = total;
+        total += count;
       }
+      counts[rows] = total;
+      new_data = new Triple[total > 10 ? total : 10];
     }
   }
 
-  return std::move(result);
+  delete[] result.m_data;
+  result.m_data = new_data;
+  result.m_total = counts[rows];
+  result.m_capacity = counts[rows] > 10 ? counts[rows] : 10;
+  result.m_rows = rows;
+  result.m_cols = cols;
+
+  delete[] offsets;
+  delete[] other_offsets;
+  delete[] mask_offsets;
+  delete[] counts;
+  return true;
 }
 
 } // namespace bu_tools
@@ -383,7 +383,7 @@ inline bool SeqBinaryTree<T>::SetNode(int index, const T &value) {
   // 如果插入的是根节点或者父节点存在，允许插入
   if (index == 0 || m_nodes[(index - 1) / 2] != T()) {
     // 如果索引超出当前容量，扩展容量
-    while (index > m_capacity) {
+    while (index >= m_capacity) {
       Resize();
     }
     m_nodes[index] = value;